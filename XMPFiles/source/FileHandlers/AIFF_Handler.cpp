@@ -214,6 +214,21 @@ void AIFF_MetaHandler::CacheFileData()
 	// Throws exception if the file cannot be parsed
 	mChunkController->parseFile( this->parent->ioRef, &this->parent->openFlags );
 
+	// Read the data of the chunks that are used, only the headers have been read so far.
+	// A read-only open that only wants the XMP leaves the legacy chunks on disk.
+	const bool readOnly = ! XMP_OptionIsSet ( this->parent->openFlags, kXMPFiles_OpenForUpdate );
+	const bool xmpOnly = readOnly && XMP_OptionIsSet ( this->parent->openFlags, kXMPFiles_OpenOnlyXMP );
+
+	mChunkController->cacheChunks( this->parent->ioRef, mAIFFXMPChunkPath, true );
+
+	if( ! xmpOnly )
+	{
+		mChunkController->cacheChunks( this->parent->ioRef, mAIFFNameChunkPath, true );
+		mChunkController->cacheChunks( this->parent->ioRef, mAIFFAuthChunkPath, true );
+		mChunkController->cacheChunks( this->parent->ioRef, mAIFFCprChunkPath, true );
+		mChunkController->cacheChunks( this->parent->ioRef, mAIFFAnnoChunkPath );
+	}
+
 	// Check if the file contains XMP (last one if there are multiple chunks)
 	mXMPChunk = mChunkController->getChunk( mAIFFXMPChunkPath, true );
 	
@@ -260,6 +275,14 @@ void AIFF_MetaHandler::ProcessXMP()
 		this->containsXMP = true;
 	}
 
+	// The legacy chunks have not been read for a read-only open that only wants the XMP
+	const bool readOnly = ! XMP_OptionIsSet ( this->parent->openFlags, kXMPFiles_OpenForUpdate );
+
+	if ( readOnly && XMP_OptionIsSet ( this->parent->openFlags, kXMPFiles_OpenOnlyXMP ) )
+	{
+		return;
+	}
+
 	// Then import native properties
 	MetadataSet metaSet;
 	AIFFReconcile recon;
@@ -211,7 +211,14 @@ void ASF_MetaHandler::UpdateFile ( bool doSafeUpdate )
 	// value, when guessing for sufficient legacy padding (line-ending conversion etc.)
 	const int paddingTolerance = 50;
 
-	bool xmpGrows = ( objectState.xmpLen && (packetLen > objectState.xmpLen) && ( ! objectState.xmpIsLastObject) );
+	// The XMP object can grow in place if it is the last object of the file, a new one can be
+	// appended if the data object is the last one. Neither moves the data object.
+	const ASF_Support::ObjectData& lastObject = objectState.objects.back();
+	bool lastObjectEndsFile = ( (lastObject.pos + lastObject.len) == (XMP_Uns64)fileRef->Length() );
+	bool xmpCanGrowAtEnd = lastObjectEndsFile &&
+						   ( objectState.xmpIsLastObject || ( (objectState.xmpLen == 0) && IsEqualGUID ( ASF_Data_Object, lastObject.guid ) ) );
+
+	bool xmpGrows = ( (packetLen > objectState.xmpLen) && ( ! xmpCanGrowAtEnd ) );
 
 	bool legacyGrows = ( this->legacyManager.hasLegacyChanged() &&
 						 (this->legacyManager.getLegacyDiff() > (this->legacyManager.GetPadding() - paddingTolerance)) );
@@ -223,43 +230,53 @@ void ASF_MetaHandler::UpdateFile ( bool doSafeUpdate )
 
 	} else {
 
-		// possibly we can do an in-place update
+		// in-place update, the header object reuses its padding, the XMP object is rewritten
+		
+		XMP_ProgressTracker* progressTracker = this->parent->progressTracker;
+		if ( progressTracker != 0 ) progressTracker->BeginWork ( (float)packetLen );
 
-		if ( objectState.xmpLen < packetLen ) {
+		updated = true;
 
-			updated = SafeWriteFile();
+		// legacy update, first since the header object is rewritten from the file's current content
+		if ( this->legacyManager.hasLegacyChanged() ) {
 
-		} else {
-			
-			XMP_ProgressTracker* progressTracker = this->parent->progressTracker;
-			if ( progressTracker != 0 ) progressTracker->BeginWork ( (float)packetLen );
-			
-			// current XMP chunk size is sufficient -> write (in place update)
-			updated = ASF_Support::WriteBuffer(fileRef, objectState.xmpPos, packetLen, packetStr );
+			ASF_Support::ObjectIterator curPos = objectState.objects.begin();
+			ASF_Support::ObjectIterator endPos = objectState.objects.end();
 
-			// legacy update
-			if ( updated && this->legacyManager.hasLegacyChanged() ) {
+			for ( ; curPos != endPos; ++curPos ) {
 
-				ASF_Support::ObjectIterator curPos = objectState.objects.begin();
-				ASF_Support::ObjectIterator endPos = objectState.objects.end();
+				ASF_Support::ObjectData object = *curPos;
 
-				for ( ; curPos != endPos; ++curPos ) {
+				// find header-object
+				if ( IsEqualGUID ( ASF_Header_Object, object.guid ) ) {
+					// update header object
+					updated = support.UpdateHeaderObject ( fileRef, object, legacyManager );
+				}
 
-					ASF_Support::ObjectData object = *curPos;
+			}
 
-					// find header-object
-					if ( IsEqualGUID ( ASF_Header_Object, object.guid ) ) {
-						// update header object
-						updated = support.UpdateHeaderObject ( fileRef, object, legacyManager );
-					}
+		}
 
+		if ( updated ) {
+
+			if ( packetLen <= objectState.xmpLen ) {
+				// current XMP chunk size is sufficient -> write
+				updated = ASF_Support::WriteBuffer ( fileRef, objectState.xmpPos, packetLen, packetStr );
+			} else {
+				// grow the last XMP object or append a new one, then fix the file size
+				if ( objectState.xmpLen != 0 ) {
+					updated = ASF_Support::UpdateXMPObject ( fileRef, objectState.xmpObject, packetLen, packetStr );
+				} else {
+					fileRef->Seek ( 0, kXMP_SeekFromEnd );
+					updated = ASF_Support::WriteXMPObject ( fileRef, packetLen, packetStr );
 				}
-
+				if ( updated ) updated = support.UpdateFileSize ( fileRef );
 			}
 
-			if ( progressTracker != 0  ) progressTracker->WorkComplete();
 		}
 
+		if ( progressTracker != 0  ) progressTracker->WorkComplete();
+
 	}
 
 	if ( ! updated ) return;	// If there's an error writing the chunk, bail.
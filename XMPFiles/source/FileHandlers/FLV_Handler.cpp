@@ -176,12 +176,53 @@ FLV_MetaHandler::~FLV_MetaHandler()
 
 }	// FLV_MetaHandler::~FLV_MetaHandler
 
+// =================================================================================================
+// FLVTagWindow
+// ============
+//
+// Holds a window of the file in memory for the scan of the time 0 tags. The script data tags are
+// usually at the front and small, so one read covers them and the following tag headers.
+
+class FLVTagWindow {
+public:
+
+	enum { kWindowSize = 64*1024 };
+
+	FLVTagWindow ( XMP_IO* _fileRef, XMP_Uns64 _fileSize )
+		: fileRef(_fileRef), fileSize(_fileSize), windowPos(0), windowLen(0) {};
+
+	// Returns the bytes in [pos, pos+len), which must be within the file.
+	const XMP_Uns8* Get ( XMP_Uns64 pos, XMP_Uns32 len )
+	{
+		if ( (pos < this->windowPos) || ((pos + len) > (this->windowPos + this->windowLen)) ) {
+			XMP_Uns64 readLen = this->fileSize - pos;
+			if ( readLen > kWindowSize ) readLen = kWindowSize;
+			if ( readLen < len ) readLen = len;
+			if ( this->window.size() < (size_t)readLen ) this->window.resize ( (size_t)readLen );
+			this->fileRef->Seek ( pos, kXMP_SeekFromStart );
+			this->fileRef->ReadAll ( &this->window[0], (XMP_Uns32)readLen );
+			this->windowPos = pos;
+			this->windowLen = readLen;
+		}
+		return &this->window[(size_t)(pos - this->windowPos)];
+	}
+
+private:
+
+	XMP_IO* fileRef;
+	XMP_Uns64 fileSize;
+
+	std::vector<XMP_Uns8> window;
+	XMP_Uns64 windowPos;
+	XMP_Uns64 windowLen;
+
+};	// FLVTagWindow
+
 // =================================================================================================
 // GetTagInfo
 // ==========
 //
-// Seek to the start of a tag and extract the type, data size, and timestamp. Leave the file
-// positioned at the first byte of data.
+// Extract the type, data size, and timestamp from an 11 byte tag header.
 
 struct TagInfo {
 	XMP_Uns8  type;
@@ -189,16 +230,11 @@ struct TagInfo {
 	XMP_Uns32 dataSize;
 };
 
-static void GetTagInfo ( XMP_IO* fileRef, XMP_Uns64 tagPos, TagInfo * info )
+static void GetTagInfo ( const XMP_Uns8 * tagHeader, TagInfo * info )
 {
-	XMP_Uns8 buffer [11];
-
-	fileRef->Seek ( tagPos, kXMP_SeekFromStart );
-	fileRef->ReadAll ( buffer, 11 );
-
-	info->type = buffer[0];
-	info->time = GetUns24BE ( &buffer[4] ) || (buffer[7] << 24);
-	info->dataSize = GetUns24BE ( &buffer[1] );
+	info->type = tagHeader[0];
+	info->time = GetUns24BE ( &tagHeader[4] ) | (tagHeader[7] << 24);
+	info->dataSize = GetUns24BE ( &tagHeader[1] );
 
 }	// GetTagInfo
 
@@ -331,12 +367,13 @@ void FLV_MetaHandler::CacheFileData()
 	XMP_IO* fileRef  = this->parent->ioRef;
 	XMP_Uns64   fileSize = fileRef->Length();
 
-	XMP_Uns8  buffer [16];	// Enough for 1+2+"onMetaData"+nul.
+	const XMP_Uns8 * buffer;
 	XMP_Uns32 ioCount;
 	TagInfo   info;
 
-	fileRef->Seek ( 5, kXMP_SeekFromStart );
-	fileRef->ReadAll ( buffer, 4 );
+	FLVTagWindow window ( fileRef, fileSize );
+
+	buffer = window.Get ( 5, 4 );
 
 	this->flvHeaderLen = GetUns32BE ( &buffer[0] );
 	XMP_Uns32 firstTagPos = this->flvHeaderLen + 4;	// Include the initial zero back pointer.
@@ -349,16 +386,19 @@ void FLV_MetaHandler::CacheFileData()
 			XMP_Throw ( "FLV_MetaHandler::LookForMetadata - User abort", kXMPErr_UserAbort );
 		}
 
-		GetTagInfo ( fileRef, tagPos, &info );	// ! GetTagInfo seeks to the tag offset.
+		GetTagInfo ( window.Get ( tagPos, 11 ), &info );
 		if ( info.time != 0 ) break;
 		if ( info.type != 18 ) continue;
 
-		XMP_Assert ( sizeof(buffer) >= (1+2+10+1) );	// 02 000B onMetaData 00
-		ioCount = fileRef->Read ( buffer, sizeof(buffer) );
-		if ( (ioCount < 4) || (buffer[0] != 0x02) ) continue;
+		ioCount = 1+2+10+1;	// Enough for 02 000B onMetaData 00.
+		if ( ioCount > (fileSize - (tagPos + 11)) ) ioCount = (XMP_Uns32)(fileSize - (tagPos + 11));
+		if ( ioCount < 4 ) continue;
+		buffer = window.Get ( (tagPos + 11), ioCount );
+		if ( buffer[0] != 0x02 ) continue;
 
 		XMP_Uns16     nameLen = GetUns16BE ( &buffer[1] );
 		XMP_StringPtr namePtr = (XMP_StringPtr)(&buffer[3]);
+		if ( (XMP_Uns32)(1+2+nameLen) > ioCount ) continue;	// Too long for onXMPData or onMetaData.
 
 		if ( this->onXMP.empty() && CheckName ( namePtr, nameLen, "onXMPData", 9 ) ) {
 
@@ -370,10 +410,7 @@ void FLV_MetaHandler::CacheFileData()
 			this->packetInfo.offset = tagPos + 11 + 1+2+nameLen;	// ! Not the real offset yet, the offset of the onXMPData value.
 
 			ioCount = info.dataSize - (1+2+nameLen);	// Just the onXMPData value portion.
-			this->onXMP.reserve ( ioCount );
-			this->onXMP.assign ( ioCount, ' ' );
-			fileRef->Seek ( this->packetInfo.offset, kXMP_SeekFromStart );
-			fileRef->ReadAll ( (void*)this->onXMP.data(), ioCount );
+			this->onXMP.assign ( (const char*)window.Get ( this->packetInfo.offset, ioCount ), ioCount );
 
 			if ( ! this->onMetaData.empty() ) break;	// Done if we've found both.
 
@@ -383,10 +420,7 @@ void FLV_MetaHandler::CacheFileData()
 			this->omdTagLen  = 11 + info.dataSize + 4;	// ! Includes the trailing back pointer.
 
 			ioCount = info.dataSize - (1+2+nameLen);	// Just the onMetaData value portion.
-			this->onMetaData.reserve ( ioCount );
-			this->onMetaData.assign ( ioCount, ' ' );
-			fileRef->Seek ( (tagPos + 11 + 1+2+nameLen), kXMP_SeekFromStart );
-			fileRef->ReadAll ( (void*)this->onMetaData.data(), ioCount );
+			this->onMetaData.assign ( (const char*)window.Get ( (tagPos + 11 + 1+2+nameLen), ioCount ), ioCount );
 
 			if ( ! this->onXMP.empty() ) break;	// Done if we've found both.
 
@@ -516,64 +550,6 @@ void FLV_MetaHandler::ProcessXMP()
 
 }	// FLV_MetaHandler::ProcessXMP
 
-// =================================================================================================
-// FLV_MetaHandler::UpdateFile
-// ===========================
-
-void FLV_MetaHandler::UpdateFile ( bool doSafeUpdate )
-{
-	if ( ! this->needsUpdate ) return;
-	XMP_Assert ( ! doSafeUpdate );	// This should only be called for "unsafe" updates.
-
-	XMP_AbortProc abortProc  = this->parent->abortProc;
-	void *        abortArg   = this->parent->abortArg;
-	const bool    checkAbort = (abortProc != 0);
-
-	XMP_IO* fileRef  = this->parent->ioRef;
-	XMP_Uns64   fileSize = fileRef->Length();
-
-	// Make sure the XMP has a legacy digest if appropriate.
-
-	if ( ! this->onMetaData.empty() ) {
-
-		std::string newDigest;
-		this->MakeLegacyDigest ( &newDigest );
-		this->xmpObj.SetStructField ( kXMP_NS_XMP, "NativeDigests",
-									  kXMP_NS_XMP, "FLV", newDigest.c_str(), kXMP_DeleteExisting );
-
-		try {
-			XMP_StringLen xmpLen = (XMP_StringLen)this->xmpPacket.size();
-			this->xmpObj.SerializeToBuffer ( &this->xmpPacket, (kXMP_UseCompactFormat | kXMP_ExactPacketLength), xmpLen );
-		} catch ( ... ) {
-			this->xmpObj.SerializeToBuffer ( &this->xmpPacket, kXMP_UseCompactFormat );
-		}
-
-	}
-
-	// Rewrite the packet in-place if it fits. Otherwise rewrite the whole file.
-
-	if ( this->xmpPacket.size() == (size_t)this->packetInfo.length ) {
-		XMP_ProgressTracker* progressTracker = this->parent->progressTracker;
-		if ( progressTracker != 0 ) progressTracker->BeginWork ( (float)this->xmpPacket.size() );
-		fileRef->Seek ( this->packetInfo.offset, kXMP_SeekFromStart );
-		fileRef->Write ( this->xmpPacket.data(), (XMP_Int32)this->xmpPacket.size() );
-		if ( progressTracker != 0 ) progressTracker->WorkComplete();
-
-
-	} else {
-
-		XMP_IO* tempRef = fileRef->DeriveTemp();
-		if ( tempRef == 0 ) XMP_Throw ( "Failure creating FLV temp file", kXMPErr_InternalFailure );
-
-		this->WriteTempFile ( tempRef );
-		fileRef->AbsorbTemp();
-
-	}
-
-	this->needsUpdate = false;
-
-}	// FLV_MetaHandler::UpdateFile
-
 // =================================================================================================
 // WriteOnXMP
 // ==========
@@ -600,17 +576,26 @@ void FLV_MetaHandler::UpdateFile ( bool doSafeUpdate )
 //
 //   -- UI24 array terminator : 0x000009
 //   -- UI32 back pointer : content length + 11
+//
+// The tag is written at the current file position.
 
-static void WriteOnXMP ( XMP_IO* fileRef, const std::string & xmpPacket )
+static XMP_Uns32 GetOnXMPContentLen ( const std::string & xmpPacket )
 {
-	char buffer [64];
-	bool longXMP = false;
 	XMP_Uns32 tagLen = 1+2+9+1+4+2+7+1 + 2 + (XMP_Uns32)xmpPacket.size() + 1 + 3;
+	if ( xmpPacket.size() > 0xFFFE ) tagLen += 2;	// A long string has a UI32 length.
+	return tagLen;
+}
 
-	if ( xmpPacket.size() > 0xFFFE ) {
-		longXMP = true;
-		tagLen += 2;
-	}
+static inline XMP_Uns64 GetOnXMPTagLen ( const std::string & xmpPacket )
+{
+	return 11 + GetOnXMPContentLen ( xmpPacket ) + 4;	// ! Includes the trailing back pointer.
+}
+
+static void WriteOnXMP ( XMP_IO* fileRef, const std::string & xmpPacket )
+{
+	char buffer [64];
+	bool longXMP = ( xmpPacket.size() > 0xFFFE );
+	XMP_Uns32 tagLen = GetOnXMPContentLen ( xmpPacket );
 
 	if ( tagLen > 16*1024*1024 ) XMP_Throw ( "FLV tags can't be larger than 16MB", kXMPErr_TBD );
 
@@ -634,7 +619,6 @@ static void WriteOnXMP ( XMP_IO* fileRef, const std::string & xmpPacket )
 
 	// Fill in the XMP packet string type and length, write what we have so far.
 
-	fileRef->ToEOF();
 	if ( ! longXMP ) {
 		buffer[37] = 2;
 		PutUns16BE ( (XMP_Uns16)xmpPacket.size()+1, &buffer[38] );
@@ -654,6 +638,114 @@ static void WriteOnXMP ( XMP_IO* fileRef, const std::string & xmpPacket )
 
 }	// WriteOnXMP
 
+// =================================================================================================
+
+static const XMP_StringLen kFLV_MinXMPPadding = 4*1024;
+
+// =================================================================================================
+// FLV_MetaHandler::ReserveXMPPadding
+// ==================================
+//
+// The onXMPData tag is about to be written with a new size, which moves every following tag. Give
+// the packet room for later edits to be done in place: half of the packet size, at least 4K.
+
+void FLV_MetaHandler::ReserveXMPPadding()
+{
+	XMP_StringLen padding = (XMP_StringLen)this->xmpPacket.size() / 2;
+	if ( padding < kFLV_MinXMPPadding ) padding = kFLV_MinXMPPadding;
+
+	this->xmpObj.SerializeToBuffer ( &this->xmpPacket, kXMP_UseCompactFormat, padding );
+
+}	// FLV_MetaHandler::ReserveXMPPadding
+
+// =================================================================================================
+// FLV_MetaHandler::UpdateFile
+// ===========================
+
+void FLV_MetaHandler::UpdateFile ( bool doSafeUpdate )
+{
+	if ( ! this->needsUpdate ) return;
+	XMP_Assert ( ! doSafeUpdate );	// This should only be called for "unsafe" updates.
+
+	XMP_IO* fileRef  = this->parent->ioRef;
+	XMP_Uns64   fileSize = fileRef->Length();
+
+	// Make sure the XMP has a legacy digest if appropriate.
+
+	if ( ! this->onMetaData.empty() ) {
+
+		std::string newDigest;
+		this->MakeLegacyDigest ( &newDigest );
+		this->xmpObj.SetStructField ( kXMP_NS_XMP, "NativeDigests",
+									  kXMP_NS_XMP, "FLV", newDigest.c_str(), kXMP_DeleteExisting );
+
+		try {
+			XMP_StringLen xmpLen = (XMP_StringLen)this->xmpPacket.size();
+			this->xmpObj.SerializeToBuffer ( &this->xmpPacket, (kXMP_UseCompactFormat | kXMP_ExactPacketLength), xmpLen );
+		} catch ( ... ) {
+			this->xmpObj.SerializeToBuffer ( &this->xmpPacket, kXMP_UseCompactFormat );
+		}
+
+	}
+
+	// Rewrite the packet in-place if it fits. Otherwise shift the following tags by the size change
+	// of the onXMPData tag, in place. Only a file that is just a header is rewritten as a whole.
+
+	XMP_ProgressTracker* progressTracker = this->parent->progressTracker;
+
+	if ( this->xmpPacket.size() == (size_t)this->packetInfo.length ) {
+
+		if ( progressTracker != 0 ) progressTracker->BeginWork ( (float)this->xmpPacket.size() );
+		fileRef->Seek ( this->packetInfo.offset, kXMP_SeekFromStart );
+		fileRef->Write ( this->xmpPacket.data(), (XMP_Int32)this->xmpPacket.size() );
+		if ( progressTracker != 0 ) progressTracker->WorkComplete();
+
+	} else if ( fileSize >= (this->flvHeaderLen + 4) ) {
+
+		this->ReserveXMPPadding();
+
+		// Replace an existing onXMPData tag where it is, otherwise insert it where WriteTempFile would.
+
+		XMP_Uns64 tagPos    = this->flvHeaderLen + 4;
+		XMP_Uns64 oldTagLen = 0;
+
+		if ( this->xmpTagPos != 0 ) {
+			tagPos    = this->xmpTagPos;
+			oldTagLen = this->xmpTagLen;
+		} else if ( this->omdTagPos != 0 ) {
+			tagPos = this->omdTagPos + this->omdTagLen;
+		}
+
+		XMP_Uns64 newTagLen = GetOnXMPTagLen ( this->xmpPacket );
+		XMP_Uns64 tailPos   = tagPos + oldTagLen;
+		XMP_Uns64 tailLen   = fileSize - tailPos;
+
+		if ( progressTracker != 0 ) progressTracker->BeginWork ( (float)(tailLen + newTagLen) );
+
+		if ( newTagLen != oldTagLen ) {	// ! No abort proc, stopping part way would corrupt the file.
+			XIO::Move ( fileRef, tailPos, fileRef, (tagPos + newTagLen), tailLen );
+			if ( newTagLen < oldTagLen ) fileRef->Truncate ( fileSize - (oldTagLen - newTagLen) );
+		}
+
+		fileRef->Seek ( tagPos, kXMP_SeekFromStart );
+		WriteOnXMP ( fileRef, this->xmpPacket );
+
+		if ( progressTracker != 0 ) progressTracker->WorkComplete();
+
+	} else {
+
+		XMP_IO* tempRef = fileRef->DeriveTemp();
+		if ( tempRef == 0 ) XMP_Throw ( "Failure creating FLV temp file", kXMPErr_InternalFailure );
+
+		this->WriteTempFile ( tempRef );
+		fileRef->AbsorbTemp();
+
+	}
+
+	this->needsUpdate = false;
+
+}	// FLV_MetaHandler::UpdateFile
+
 // =================================================================================================
 // FLV_MetaHandler::WriteTempFile
 // ==============================
@@ -674,6 +766,8 @@ void FLV_MetaHandler::WriteTempFile ( XMP_IO* tempRef )
 
 	XMP_IO* originalRef = this->parent->ioRef;
 
+	if ( this->xmpPacket.size() != (size_t)this->packetInfo.length ) this->ReserveXMPPadding();
+
 	XMP_Uns64 sourceLen = originalRef->Length();
 	XMP_Uns64 sourcePos = 0;
 
@@ -65,6 +65,7 @@ private:
 
 	void ExtractLiveXML();
 	void MakeLegacyDigest ( std::string * digestStr );
+	void ReserveXMPPadding();
 
 	XMP_Uns32 flvHeaderLen;
 	bool longXMP;	// True if the stored XMP is a long string (4 byte length).
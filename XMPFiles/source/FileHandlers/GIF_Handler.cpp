@@ -143,130 +143,176 @@ void GIF_MetaHandler::ProcessXMP()
 
 }	// GIF_MetaHandler::ProcessXMP
 
+// =================================================================================================
+// GIFBlockScanner
+// ===============
+//
+// Walks the GIF block structure from memory. Every image's LZW data is a chain of sub-blocks of at
+// most 255 bytes, each preceded by its length byte, so the chains have to be followed to find the
+// next block. The file is read in large windows and the chains are followed within the window,
+// instead of doing a 1 byte read and a seek for each sub-block.
+
+class GIFBlockScanner {
+public:
+
+	enum { kWindowSize = 256*1024 };
+
+	GIFBlockScanner ( XMP_IO* _fileRef )
+		: fileRef(_fileRef), fileLength(_fileRef->Length()), windowPos(0), windowLen(0), offset(0) {};
+
+	XMP_Int64 Offset() const { return this->offset; };
+	bool AtEnd() const { return (this->offset == this->fileLength); };
+
+	XMP_Uns8 ReadByte()
+	{
+		if ( (this->offset - this->windowPos) >= this->windowLen ) this->FillWindow();
+		XMP_Uns8 value = this->window[(size_t)(this->offset - this->windowPos)];
+		++this->offset;
+		return value;
+	}
+
+	void ReadBytes ( XMP_Uns8* buffer, XMP_Uns32 count )
+	{
+		for ( ; count > 0; --count, ++buffer ) *buffer = this->ReadByte();	// Only used for short fields.
+	}
+
+	void Skip ( XMP_Int64 count )
+	{
+		if ( (count < 0) || (count > (this->fileLength - this->offset)) ) {
+			XMP_Throw ( "Out of range seek operation", kXMPErr_InternalFailure );
+		}
+		this->offset += count;
+	}
+
+	// Skip a chain of sub-blocks, up to and including the zero length terminator.
+	void SkipSubBlocks()
+	{
+		for ( XMP_Uns8 subBlockSize = this->ReadByte(); subBlockSize != 0; subBlockSize = this->ReadByte() ) {
+			this->Skip ( subBlockSize );
+		}
+	}
+
+private:
+
+	void FillWindow()
+	{
+		XMP_Int64 readLen = this->fileLength - this->offset;
+		if ( readLen <= 0 ) XMP_Throw ( "Unexpected end of GIF file", kXMPErr_BadFileFormat );
+		if ( readLen > kWindowSize ) readLen = kWindowSize;
+		if ( this->window.size() < (size_t)readLen ) this->window.resize ( (size_t)readLen );
+		this->fileRef->Seek ( this->offset, kXMP_SeekFromStart );
+		this->fileRef->ReadAll ( &this->window[0], (XMP_Uns32)readLen );
+		this->windowPos = this->offset;
+		this->windowLen = readLen;
+	}
+
+	XMP_IO* fileRef;
+	XMP_Int64 fileLength;
+
+	std::vector<XMP_Uns8> window;
+	XMP_Int64 windowPos;
+	XMP_Int64 windowLen;
+	XMP_Int64 offset;
+
+};	// GIFBlockScanner
+
 // =================================================================================================
 // GIF_MetaHandler::ParseGIFBlocks
 // ===========================
 
 bool GIF_MetaHandler::ParseGIFBlocks( XMP_IO* fileRef )
 {
-	fileRef->Rewind();
+	GIFBlockScanner scanner ( fileRef );
 
 	// Checking for GIF header
 	XMP_Uns8 buffer[ GIF_89_Header_LEN ];
 
-	fileRef->Read( buffer, GIF_89_Header_LEN );
+	scanner.ReadBytes( buffer, GIF_89_Header_LEN );
 	XMP_Enforce( memcmp( buffer, GIF_89_Header_DATA, GIF_89_Header_LEN ) == 0 );
 
 	bool IsXMPExists = false;
 	bool IsTrailerExists = false;
 
-	ReadLogicalScreenDesc( fileRef );
+	ReadLogicalScreenDesc( scanner );
 
 	// Parsing rest of the blocks
-	while ( fileRef->Offset() != fileRef->Length() )
+	while ( ! scanner.AtEnd() )
 	{
-		XMP_Uns8 blockType;
+		XMP_Int64 blockOffset = scanner.Offset();
 
 		// Read the block type byte
-		fileRef->Read( &blockType, 1 );
+		XMP_Uns8 blockType = scanner.ReadByte();
 
 		if ( blockType == kXMP_block_ImageDesc )
 		{
 
 			// ImageDesc is a special case, So read data just like its structure.
-			long tableSize = 0;
-			XMP_Uns8 fields;
 			// Reading Dimesnions of image as 
 			// 2 bytes = Image Left Position
 			// + 2 bytes = Image Right Position
 			// + 2 bytes = Image Width
 			// + 2 bytes = Image Height
 			// = 8 bytes
-			this->SeekFile( fileRef, 8, kXMP_SeekFromCurrent );
+			scanner.Skip( 8 );
 
 			// Reading one byte for Packed Fields
-			fileRef->Read( &fields, 1 );
+			XMP_Uns8 fields = scanner.ReadByte();
 
 			// Getting Local Table Size and skipping table size
 			if ( fields & 0x80 )
 			{
-				tableSize = ( 1 << ( ( fields & 0x07 ) + 1 ) ) * 3;
-				this->SeekFile( fileRef, tableSize, kXMP_SeekFromCurrent );
+				long tableSize = ( 1 << ( ( fields & 0x07 ) + 1 ) ) * 3;
+				scanner.Skip( tableSize );
 			}
 
 			// 1 byte LZW Minimum code size
-			this->SeekFile( fileRef, 1, kXMP_SeekFromCurrent );
+			scanner.Skip( 1 );
 
-			XMP_Uns8 subBlockSize;
-			// 1 byte compressed sub-block size
-			fileRef->Read( &subBlockSize, 1 );
-
-			while ( subBlockSize != 0x00 )
-			{
-				// Skipping compressed data sub-block
-				this->SeekFile( fileRef, subBlockSize, kXMP_SeekFromCurrent );
-
-				// 1 byte compressed sub-block size
-				fileRef->Read( &subBlockSize, 1 );
-			}
+			// Skipping compressed data sub-blocks
+			scanner.SkipSubBlocks();
 
 		}
 		else if ( blockType == kXMP_block_Extension )
 		{
-			XMP_Uns8 extensionLbl;
-			XMP_Uns32 blockSize = 0;
-			XMP_Uns64 blockOffset = fileRef->Offset();
-
 			// Extension Label
-			fileRef->Read( &extensionLbl, 1 );
+			XMP_Uns8 extensionLbl = scanner.ReadByte();
 
 			// Block or Sub-Block size
-			fileRef->Read( &blockSize, 1 );
+			XMP_Uns8 blockSize = scanner.ReadByte();
 
 			// Checking for Application Extension label and blockSize
 			if ( extensionLbl == 0xFF && blockSize == APP_ID_LEN )
 			{
 				XMP_Uns8 idData[ APP_ID_LEN ];
-				fileRef->Read( idData, APP_ID_LEN, true );
+				scanner.ReadBytes( idData, APP_ID_LEN );
 
 				// Checking For XMP ID
-				if ( memcmp( idData, XMP_APP_ID_DATA, APP_ID_LEN ) == 0 )
+				bool isXMPBlock = ( memcmp( idData, XMP_APP_ID_DATA, APP_ID_LEN ) == 0 );
+				if ( isXMPBlock )
 				{
-					XMPPacketOffset = fileRef->Offset();
+					XMPPacketOffset = scanner.Offset();
 					IsXMPExists = true;
 				}
 
-				// Parsing sub-blocks
-				XMP_Uns8 subBlockSize;
-				fileRef->Read( &subBlockSize, 1 );
-				while ( subBlockSize != 0x00 )
-				{
-					this->SeekFile( fileRef, subBlockSize, kXMP_SeekFromCurrent );
-					fileRef->Read( &subBlockSize, 1 );
-				}
-				if ( IsXMPExists ) {
-					XMP_Int64 packetLength = fileRef->Offset() - XMPPacketOffset - MAGIC_TRAILER_LEN;
+				// Parsing sub-blocks, for XMP these run through the packet and the magic trailer.
+				scanner.SkipSubBlocks();
+
+				if ( isXMPBlock ) {
+					XMP_Int64 packetLength = scanner.Offset() - XMPPacketOffset - MAGIC_TRAILER_LEN;
 					if( packetLength < 0 ) throw XMP_Error(kXMPErr_BadFileFormat, "corrupt GIF File.");
 					XMPPacketLength = static_cast< XMP_Uns32 >( packetLength );
 				}
 			}
-			else
+			else if ( blockSize != 0x00 )
 			{
 				// Extension block other than Application Extension
-				while ( blockSize != 0x00 )
-				{
-					// Seeking block size or sub-block size
-					this->SeekFile( fileRef, blockSize, kXMP_SeekFromCurrent );
-
-					// Block Size
-					fileRef->Read( &blockSize, 1 );
-				}
+				scanner.Skip( blockSize );
+				scanner.SkipSubBlocks();
 			}
 		}
 		else if ( blockType == kXMP_block_Trailer )
 		{
-			// 1 byte is subtracted for block type
-			trailerOffset = fileRef->Offset() - 1;
+			trailerOffset = blockOffset;
 			IsTrailerExists = true;
 			break;
 		}
@@ -285,28 +331,26 @@ bool GIF_MetaHandler::ParseGIFBlocks( XMP_IO* fileRef )
 // GIF_MetaHandler::ReadLogicalScreenDesc
 // ===========================
 
-void GIF_MetaHandler::ReadLogicalScreenDesc( XMP_IO* fileRef )
+void GIF_MetaHandler::ReadLogicalScreenDesc( GIFBlockScanner & scanner )
 {
-	XMP_Uns8 fields;
-
 	// 2 bytes for Screen Width
 	// + 2 bytes for Screen Height
 	// = 4 Bytes
-	this->SeekFile( fileRef, 4, kXMP_SeekFromCurrent );
+	scanner.Skip( 4 );
 
 	// 1 byte for Packed Fields
-	fileRef->Read( &fields, 1 );
+	XMP_Uns8 fields = scanner.ReadByte();
 
 	// 1 byte for Background Color Index
 	// + 1 byte for Pixel Aspect Ratio
 	// = 2 bytes
-	this->SeekFile( fileRef, 2, kXMP_SeekFromCurrent );
+	scanner.Skip( 2 );
 
 	// Look for Global Color Table if exists 
 	if ( fields & 0x80 )
 	{
 		long tableSize = ( 1 << ( ( fields & 0x07 ) + 1 ) ) * 3;
-		this->SeekFile( fileRef, tableSize, kXMP_SeekFromCurrent );
+		scanner.Skip( tableSize );
 	}
 
 }	// GIF_MetaHandler::ReadLogicalScreenDesc
@@ -50,6 +50,8 @@ static const XMP_OptionBits kGIF_HandlerFlags = ( kXMPFiles_CanInjectXMP |
 												  kXMPFiles_NeedsReadOnlyPacket
 													);
 
+class GIFBlockScanner;
+
 class GIF_MetaHandler : public XMPFileHandler
 {
 public:
@@ -80,7 +82,7 @@ private:
 	XMP_Uns64 trailerOffset;
 
 	bool ParseGIFBlocks( XMP_IO * fileRef );
-	void ReadLogicalScreenDesc( XMP_IO* fileRef );
+	void ReadLogicalScreenDesc( GIFBlockScanner & scanner );
 	void SeekFile( XMP_IO * fileRef, XMP_Int64 offset, SeekMode mode );
 
 };	// GIF_MetaHandler
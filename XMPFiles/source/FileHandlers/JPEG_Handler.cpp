@@ -15,6 +15,7 @@
 #include "public/include/XMP_IO.hpp"
 
 #include "XMPFiles/source/XMPFiles_Impl.hpp"
+#include "XMPFiles/source/XMPFiles_Metrics.hpp"
 #include "source/XIO.hpp"
 
 #include "XMPFiles/source/FileHandlers/JPEG_Handler.hpp"
@@ -53,16 +54,21 @@ static const char * kExtXMPSignatureString = "http://ns.adobe.com/xmp/extension/
 static const size_t kExtXMPSignatureLength = 35;
 static const size_t kExtXMPPrefixLength    = kExtXMPSignatureLength + 32 + 4 + 4;
 
-typedef std::map < XMP_Uns32 /* offset */, std::string /* portion */ > ExtXMPPortions;
+// An extended XMP stream being read. The content is sized to the full length when the first
+// portion is seen, each portion is read straight to its place. Only the portion offsets and lengths
+// are kept on the side, to check at the end that the stream is complete.
 
-struct ExtXMPContent {
+typedef std::pair < XMP_Uns32 /* offset */, XMP_Uns32 /* length */ > ExtXMPPortion;
+
+struct ExtXMPStream {
+	JPEG_MetaHandler::GUID_32 guid;
 	XMP_Uns32 length;
-	ExtXMPPortions portions;
-	ExtXMPContent() : length(0) {};
-	ExtXMPContent ( XMP_Uns32 _length ) : length(_length) {};
+	std::string content;
+	std::vector < ExtXMPPortion > portions;
+	ExtXMPStream() : length(0) {};
 };
 
-typedef std::map < JPEG_MetaHandler::GUID_32 /* guid */, ExtXMPContent /* content */ > ExtendedXMPInfo;
+typedef std::vector < ExtXMPStream > ExtXMPStreams;	// Normally just one, a linear search is fine.
 
 #ifndef Trace_UnlimitedJPEG
 	#define Trace_UnlimitedJPEG 0
@@ -125,7 +131,7 @@ bool JPEG_CheckFormat ( XMP_FileFormat format,
 // ==================================
 
 JPEG_MetaHandler::JPEG_MetaHandler ( XMPFiles * _parent )
-	: exifMgr(0), psirMgr(0), iptcMgr(0), skipReconcile(false)
+	: exifMgr(0), psirMgr(0), iptcMgr(0), skipReconcile(false), segmentsEnd(0), indexState(kIndex_None)
 {
 	this->parent = _parent;
 	this->handlerFlags = kJPEG_HandlerFlags;
@@ -147,18 +153,16 @@ JPEG_MetaHandler::~JPEG_MetaHandler()
 }	// JPEG_MetaHandler::~JPEG_MetaHandler
 
 // =================================================================================================
-// CacheExtendedXMP
-// ================
+// ReadExtendedXMP
+// ===============
 
-static void CacheExtendedXMP ( ExtendedXMPInfo * extXMP, XMP_Uns8 * buffer, size_t bufferLen )
+static void ReadExtendedXMP ( XMP_IO * fileRef, XMP_Int64 contentOrigin, size_t contentLen,
+							  size_t totalPortionLen, ExtXMPStreams * streams )
 {
 
-	// Have a portion of the extended XMP, cache the contents. This is complicated by the need to
-	// tolerate files where the extension portions are not in order. The local ExtendedXMPInfo map
-	// uses the GUID as the key and maps that to a struct that has the full length and a map of the
-	// known portions. This known portion map uses the offset of the portion as the key and maps
-	// that to a string. Only fully seen extended XMP streams are kept, the right one gets picked in
-	// ProcessXMP.
+	// Have a portion of the extended XMP, read it into the stream for its GUID. This is complicated
+	// by the need to tolerate files where the extension portions are not in order. Only fully seen
+	// extended XMP streams are kept, the right one gets picked in ProcessXMP.
 
 	// The extended XMP JPEG marker segment content holds:
 	//	- a signature string, "http://ns.adobe.com/xmp/extension/\0", already verified
@@ -166,66 +170,192 @@ static void CacheExtendedXMP ( ExtendedXMPInfo * extXMP, XMP_Uns8 * buffer, size
 	//	- a UInt32 full length of the entire extended XMP
 	//	- a UInt32 offset for this portion of the extended XMP
 	//	- the UTF-8 text for this portion of the extended XMP
-	
-	if ( bufferLen < kExtXMPPrefixLength ) return;	// Ignore bad input.
-	XMP_Assert ( CheckBytes ( &buffer[0], kExtXMPSignatureString, kExtXMPSignatureLength ) );
 
-	XMP_Uns8 * bufferPtr = buffer + kExtXMPSignatureLength;	// Start at the GUID.
-	
+	if ( contentLen < kExtXMPPrefixLength ) return;	// Ignore bad input.
+
+	XMP_Uns8 prefix [kExtXMPPrefixLength - kExtXMPSignatureLength];
+	fileRef->Seek ( (contentOrigin + kExtXMPSignatureLength), kXMP_SeekFromStart );
+	fileRef->ReadAll ( prefix, sizeof(prefix) );
+
 	JPEG_MetaHandler::GUID_32 guid;
 	XMP_Assert ( sizeof(guid.data) == 32 );
-	memcpy ( &guid.data[0], bufferPtr, sizeof(guid.data) );	// AUDIT: Use of sizeof(guid.data) is safe.
+	memcpy ( &guid.data[0], &prefix[0], sizeof(guid.data) );	// AUDIT: Use of sizeof(guid.data) is safe.
 
-	bufferPtr += sizeof(guid.data);	// Move to the length and offset.
-	XMP_Uns32 fullLen = GetUns32BE ( bufferPtr );
-	XMP_Uns32 offset  = GetUns32BE ( bufferPtr+4 );
-
-	bufferPtr += 8;	// Move to the XMP stream portion.
-	size_t xmpLen = bufferLen - kExtXMPPrefixLength;
+	XMP_Uns32 fullLen = GetUns32BE ( &prefix[32] );
+	XMP_Uns32 offset  = GetUns32BE ( &prefix[36] );
+	XMP_Uns32 xmpLen  = (XMP_Uns32) (contentLen - kExtXMPPrefixLength);
 
 	#if Trace_UnlimitedJPEG
 		printf ( "New extended XMP portion: fullLen %d, offset %d, GUID %.32s\n", fullLen, offset, guid.data );
 	#endif
 
-	// Find the ExtXMPContent for this GUID, and the string for this portion's offset.
+	// A stream can't be longer than all of the portions in the file, this keeps a bad full length
+	// from sizing the content. Ignore portions that don't fit within their stream.
+
+	if ( (fullLen > totalPortionLen) || (offset > fullLen) || (xmpLen > (fullLen - offset)) ) return;
 
-	ExtendedXMPInfo::iterator guidPos = extXMP->find ( guid );
-	if ( guidPos == extXMP->end() ) {
-		ExtXMPContent newExtContent ( fullLen );
-		guidPos = extXMP->insert ( extXMP->begin(), ExtendedXMPInfo::value_type ( guid, newExtContent ) );
+	size_t streamIndex = 0;
+	for ( ; streamIndex < streams->size(); ++streamIndex ) {
+		if ( (*streams)[streamIndex].guid == guid ) break;
 	}
 
-	ExtXMPPortions::iterator offsetPos;
-	ExtXMPContent & extContent = guidPos->second;
+	if ( streamIndex == streams->size() ) {
+		streams->push_back ( ExtXMPStream() );
+		streams->back().guid = guid;
+		streams->back().length = fullLen;
+		streams->back().content.resize ( fullLen );
+	}
+
+	ExtXMPStream & stream = (*streams)[streamIndex];
+	if ( fullLen != stream.length ) return;	// Ignore portions that disagree with the first one.
+
+	// The portion follows the prefix, the file is already there.
+
+	if ( xmpLen > 0 ) fileRef->ReadAll ( &stream.content[offset], xmpLen );
+	stream.portions.push_back ( ExtXMPPortion ( offset, xmpLen ) );
+
+}	// ReadExtendedXMP
+
+// =================================================================================================
+// ClassifySegment
+// ===============
+//
+// Tell the metadata segments apart by their signature. Check the APP1 signatures in increasing
+// length, the signature bytes are limited to the segment content.
 
-	if ( extContent.portions.empty() ) {
-		// When new create a full size offset 0 string, to which all in-order portions will get appended.
-		offsetPos = extContent.portions.insert ( extContent.portions.begin(),
-												 ExtXMPPortions::value_type ( 0, std::string() ) );
-		offsetPos->second.reserve ( extContent.length );
+static XMP_Uns8 ClassifySegment ( XMP_Uns16 marker, const XMP_Uns8 * sigPtr, size_t sigLen )
+{
+	XMP_Assert ( (kExifSignatureLength < kMainXMPSignatureLength) &&
+				 (kMainXMPSignatureLength < kExtXMPSignatureLength) );
+
+	if ( marker == 0xFFED ) {
+		if ( (sigLen >= kPSIRSignatureLength) && CheckBytes ( sigPtr, kPSIRSignatureString, kPSIRSignatureLength ) ) {
+			return JPEG_MetaHandler::kSegment_PSIR;
+		}
+	} else if ( marker == 0xFFE1 ) {
+		if ( (sigLen >= kExifSignatureLength) &&
+			 (CheckBytes ( sigPtr, kExifSignatureString, kExifSignatureLength ) ||
+			  CheckBytes ( sigPtr, kExifSignatureAltStr, kExifSignatureLength )) ) {
+			return JPEG_MetaHandler::kSegment_Exif;
+		}
+		if ( (sigLen >= kMainXMPSignatureLength) && CheckBytes ( sigPtr, kMainXMPSignatureString, kMainXMPSignatureLength ) ) {
+			return JPEG_MetaHandler::kSegment_MainXMP;
+		}
+		if ( (sigLen >= kExtXMPSignatureLength) && CheckBytes ( sigPtr, kExtXMPSignatureString, kExtXMPSignatureLength ) ) {
+			return JPEG_MetaHandler::kSegment_ExtXMP;
+		}
 	}
 
-	// Try to append this portion to a logically contiguous preceeding one.
+	return JPEG_MetaHandler::kSegment_Other;
 
-	if ( offset == 0 ) {
-		offsetPos = extContent.portions.begin();
-		XMP_Assert ( (offsetPos->first == 0) && (offsetPos->second.size() == 0) );
-	} else {
-		offsetPos = extContent.portions.lower_bound ( offset );
-		--offsetPos;	// Back up to the portion whose offset is less than the new offset.
-		if ( (offsetPos->first + offsetPos->second.size()) != offset ) {
-			// Can't append, create a new portion.
-			offsetPos = extContent.portions.insert ( extContent.portions.begin(),
-													 ExtXMPPortions::value_type ( offset, std::string() ) );
+}	// ClassifySegment
+
+// =================================================================================================
+// JPEG_MetaHandler::IndexSegments
+// ===============================
+//
+// Walk the marker segments from the SOI to the first SOS or EOI, see CacheFileData for the layout.
+// The walk reads the file through a small window, so a run of small segments costs one read and a
+// large segment costs at most one read for its marker, length, and signature. The segment content
+// is not read here.
+
+void JPEG_MetaHandler::IndexSegments()
+{
+	XMP_IO* fileRef = this->parent->ioRef;
+
+	XMP_AbortProc abortProc  = this->parent->abortProc;
+	void *        abortArg   = this->parent->abortArg;
+	const bool    checkAbort = (abortProc != 0);
+
+	static const size_t kWindowSize = 4*1024;
+	XMP_Uns8  window [kWindowSize];
+	XMP_Int64 windowOrigin = 0;
+	size_t    windowLen = 0;
+
+	const XMP_Int64 fileLen = fileRef->Length();
+	XMP_Int64 markerOffset = 2;	// Skip the SOI, CheckFormat made sure it is present.
+
+	this->segments.clear();
+	this->indexState = kIndex_Truncated;	// Until an SOS, EOI, or bad marker is seen.
+
+	while ( true ) {
+
+		if ( checkAbort && abortProc(abortArg) ) {
+			XMP_Throw ( "JPEG_MetaHandler::IndexSegments - User abort", kXMPErr_UserAbort );
 		}
+
+		if ( (fileLen - markerOffset) < 2 ) break;	// Quit, don't throw, if the file ends unexpectedly.
+
+		// Make sure the window has the marker, length, and longest signature, or the rest of the file.
+
+		size_t wanted = 4 + kExtXMPSignatureLength;
+		if ( (XMP_Int64)wanted > (fileLen - markerOffset) ) wanted = (size_t)(fileLen - markerOffset);
+
+		if ( (markerOffset < windowOrigin) || ((markerOffset + (XMP_Int64)wanted) > (windowOrigin + (XMP_Int64)windowLen)) ) {
+			fileRef->Seek ( markerOffset, kXMP_SeekFromStart );
+			windowOrigin = markerOffset;
+			windowLen = fileRef->Read ( window, kWindowSize );
+			if ( windowLen < wanted ) wanted = windowLen;
+			if ( wanted < 2 ) break;	// The file got shorter?
+		}
+
+		const XMP_Uns8 * segPtr = &window[markerOffset - windowOrigin];
+		size_t available = (size_t) ((windowOrigin + windowLen) - markerOffset);
+
+		XMP_Uns16 marker = GetUns16BE ( segPtr );
+		if ( marker == 0xFFFF ) {
+			// Have a pad byte, skip it. These are almost unheard of, so efficiency isn't critical.
+			++markerOffset;	// Skip the first 0xFF, look at the second again.
+			continue;
+		}
+
+		if ( (marker == 0xFFDA) || (marker == 0xFFD9) ) {	// Quit at the first SOS marker or at EOI.
+			this->indexState = kIndex_Complete;
+			break;
+		}
+
+		if ( (marker == 0xFF01) ||	// Ill-formed file if we encounter a TEM or RSTn marker.
+			 ((0xFFD0 <= marker) && (marker <= 0xFFD7)) ) {
+			this->indexState = kIndex_BadMarker;
+			break;
+		}
+
+		if ( available < 4 ) XMP_Throw ( "Missing JPEG segment length", kXMPErr_BadJPEG );
+		XMP_Uns16 contentLen = GetUns16BE ( segPtr + 2 );
+		if ( contentLen < 2 ) XMP_Throw ( "Invalid JPEG segment length", kXMPErr_BadJPEG );
+		contentLen -= 2;	// Reduce to just the content length.
+
+		size_t sigLen = std::min ( (size_t)contentLen, (available - 4) );
+		XMP_Uns8 kind = ClassifySegment ( marker, (segPtr + 4), sigLen );
+
+		this->segments.push_back ( SegmentInfo ( markerOffset, marker, contentLen, kind ) );
+		markerOffset += 4 + contentLen;
+
 	}
 
-	// Cache this portion of the extended XMP.
+	this->segmentsEnd = std::min ( markerOffset, fileLen );
+
+}	// JPEG_MetaHandler::IndexSegments
 
-	std::string & extPortion = offsetPos->second;
-	extPortion.append ( (XMP_StringPtr)bufferPtr, xmpLen );
+// =================================================================================================
+// JPEG_MetaHandler::FindOnlySegment
+// =================================
+//
+// Return the segment of the given kind if there is exactly one, else null.
+
+const JPEG_MetaHandler::SegmentInfo * JPEG_MetaHandler::FindOnlySegment ( XMP_Uns8 kind ) const
+{
+	const SegmentInfo * found = 0;
+
+	for ( size_t i = 0; i < this->segments.size(); ++i ) {
+		if ( this->segments[i].kind != kind ) continue;
+		if ( found != 0 ) return 0;
+		found = &this->segments[i];
+	}
 
-}	// CacheExtendedXMP
+	return found;
+
+}	// JPEG_MetaHandler::FindOnlySegment
 
 // =================================================================================================
 // JPEG_MetaHandler::CacheFileData
@@ -286,7 +416,7 @@ void JPEG_MetaHandler::CacheFileData()
 	void *        abortArg   = this->parent->abortArg;
 	const bool    checkAbort = (abortProc != 0);
 
-	ExtendedXMPInfo extXMP;
+	ExtXMPStreams extXMP;
 
 	XMP_Assert ( ! this->containsXMP );
 	// Set containsXMP to true here only if the standard XMP packet is found.
@@ -296,149 +426,108 @@ void JPEG_MetaHandler::CacheFileData()
 	XMP_Assert ( kExtXMPSignatureLength == (strlen(kExtXMPSignatureString) + 1) );
 
 	// -------------------------------------------------------------------------------------------
-	// Look for any of the Exif, PSIR, main XMP, or extended XMP marker segments. Quit when we hit
-	// an SOFn, EOI, or invalid/unexpected marker.
-
-	fileRef->Seek ( 2, kXMP_SeekFromStart  );	// Skip the SOI, CheckFormat made sure it is present.
+	// Index the marker segments up to the first SOS or EOI, then read any of the Exif, PSIR, main
+	// XMP, or extended XMP. Quit after the reads if the index hit the end of the file or an
+	// invalid/unexpected marker.
 
-	while ( true ) {
+	this->IndexSegments();
 
-		if ( checkAbort && abortProc(abortArg) ) {
-			XMP_Throw ( "JPEG_MetaHandler::CacheFileData - User abort", kXMPErr_UserAbort );
-		}
-
-		if ( ! XIO::CheckFileSpace ( fileRef, 2 ) ) return;	// Quit, don't throw, if the file ends unexpectedly.
-		
-		XMP_Uns16 marker = XIO::ReadUns16_BE ( fileRef );	// Read the next marker.
-		if ( marker == 0xFFFF ) {
-			// Have a pad byte, skip it. These are almost unheard of, so efficiency isn't critical.
-			fileRef->Seek ( -1, kXMP_SeekFromCurrent );	// Skip the first 0xFF, read the second again.
-			continue;
-		}
-
-		if ( (marker == 0xFFDA) || (marker == 0xFFD9) ) break;	// Quit reading at the first SOS marker or at EOI.
-
-		if ( (marker == 0xFF01) ||	// Ill-formed file if we encounter a TEM or RSTn marker.
-			 ((0xFFD0 <= marker) && (marker <= 0xFFD7)) ) return;
-
-		XMP_Uns16 contentLen = XIO::ReadUns16_BE ( fileRef );	// Read this segment's length.
-		if ( contentLen < 2 ) XMP_Throw ( "Invalid JPEG segment length", kXMPErr_BadJPEG );
-		contentLen -= 2;	// Reduce to just the content length.
-		
-		XMP_Int64 contentOrigin = fileRef->Offset();
-		size_t signatureLen;
-
-		if ( (marker == 0xFFED) && (contentLen >= kPSIRSignatureLength) ) {
-
-			// This is an APP13 marker, is it the Photoshop image resources?
-
-			signatureLen = fileRef->Read ( buffer, kPSIRSignatureLength );
-			if ( (signatureLen == kPSIRSignatureLength) &&
-				 CheckBytes ( &buffer[0], kPSIRSignatureString, kPSIRSignatureLength ) ) {
-
-				size_t psirLen = contentLen - kPSIRSignatureLength;
-				fileRef->Seek ( (contentOrigin + kPSIRSignatureLength), kXMP_SeekFromStart );
-				fileRef->ReadAll ( buffer, (XMP_Int32)psirLen );
-				this->psirContents.append( (char *) buffer, psirLen );
-				continue;	// Move on to the next marker.
+	const bool readExtXMP = (this->indexState == kIndex_Complete);
+	size_t totalPortionLen = 0;
 
+	if ( readExtXMP ) {
+		for ( size_t i = 0; i < this->segments.size(); ++i ) {
+			const SegmentInfo & segment = this->segments[i];
+			if ( (segment.kind == kSegment_ExtXMP) && (segment.contentLen >= kExtXMPPrefixLength) ) {
+				totalPortionLen += segment.contentLen - kExtXMPPrefixLength;
 			}
+		}
+	}
 
-		} else if ( (marker == 0xFFE1) && (contentLen >= kExifSignatureLength) ) {	// Check for the shortest signature.
-
-			// This is an APP1 marker, is it the Exif, main XMP, or extended XMP?
-			// ! Check in that order, which is in increasing signature string length.
-			
-			XMP_Assert ( (kExifSignatureLength < kMainXMPSignatureLength) &&
-						 (kMainXMPSignatureLength < kExtXMPSignatureLength) );
-			signatureLen = fileRef->Read ( buffer, kExtXMPSignatureLength );	// Read for the longest signature.
-
-			if ( (signatureLen >= kExifSignatureLength) &&
-				 (CheckBytes ( &buffer[0], kExifSignatureString, kExifSignatureLength ) ||
-				  CheckBytes ( &buffer[0], kExifSignatureAltStr, kExifSignatureLength )) ) {
-
-				size_t exifLen = contentLen - kExifSignatureLength;
-				fileRef->Seek ( (contentOrigin + kExifSignatureLength), kXMP_SeekFromStart );
-				fileRef->ReadAll ( buffer, (XMP_Int32)exifLen );
-				this->exifContents.append ( (char*)buffer, exifLen );
-				continue;	// Move on to the next marker.
-
-			}
-			
-			if ( (signatureLen >= kMainXMPSignatureLength) &&
-				 CheckBytes ( &buffer[0], kMainXMPSignatureString, kMainXMPSignatureLength ) ) {
-
-				this->containsXMP = true;	// Found the standard XMP packet.
-				size_t xmpLen = contentLen - kMainXMPSignatureLength;
-				fileRef->Seek ( (contentOrigin + kMainXMPSignatureLength), kXMP_SeekFromStart );
-				fileRef->ReadAll ( buffer, (XMP_Int32)xmpLen );
-				this->xmpPacket.assign ( (char*)buffer, xmpLen );
-				this->packetInfo.offset = contentOrigin + kMainXMPSignatureLength;
-				this->packetInfo.length = (XMP_Int32)xmpLen;
-				this->packetInfo.padSize   = 0;	// Assume the rest for now, set later in ProcessXMP.
-				this->packetInfo.charForm  = kXMP_CharUnknown;
-				this->packetInfo.writeable = true;
-				continue;	// Move on to the next marker.
-
-			}
-			
-			if ( (signatureLen >= kExtXMPSignatureLength) &&
-				 CheckBytes ( &buffer[0], kExtXMPSignatureString, kExtXMPSignatureLength ) ) {
+	for ( size_t i = 0; i < this->segments.size(); ++i ) {
 
-				fileRef->Seek ( contentOrigin, kXMP_SeekFromStart );
-				fileRef->ReadAll ( buffer, contentLen );
-				CacheExtendedXMP ( &extXMP, buffer, contentLen );
-				continue;	// Move on to the next marker.
+		if ( checkAbort && abortProc(abortArg) ) {
+			XMP_Throw ( "JPEG_MetaHandler::CacheFileData - User abort", kXMPErr_UserAbort );
+		}
 
-			}
+		const SegmentInfo & segment = this->segments[i];
+		XMP_Int64 contentOrigin = segment.offset + 4;
+		size_t contentLen = segment.contentLen;
+
+		switch ( segment.kind ) {
+
+			case kSegment_PSIR :
+				{
+					size_t psirLen = contentLen - kPSIRSignatureLength;
+					fileRef->Seek ( (contentOrigin + kPSIRSignatureLength), kXMP_SeekFromStart );
+					fileRef->ReadAll ( buffer, (XMP_Int32)psirLen );
+					this->psirContents.append( (char *) buffer, psirLen );
+				}
+				break;
+
+			case kSegment_Exif :
+				{
+					size_t exifLen = contentLen - kExifSignatureLength;
+					fileRef->Seek ( (contentOrigin + kExifSignatureLength), kXMP_SeekFromStart );
+					fileRef->ReadAll ( buffer, (XMP_Int32)exifLen );
+					this->exifContents.append ( (char*)buffer, exifLen );
+				}
+				break;
+
+			case kSegment_MainXMP :
+				{
+					this->containsXMP = true;	// Found the standard XMP packet.
+					size_t xmpLen = contentLen - kMainXMPSignatureLength;
+					fileRef->Seek ( (contentOrigin + kMainXMPSignatureLength), kXMP_SeekFromStart );
+					fileRef->ReadAll ( buffer, (XMP_Int32)xmpLen );
+					this->xmpPacket.assign ( (char*)buffer, xmpLen );
+					this->packetInfo.offset = contentOrigin + kMainXMPSignatureLength;
+					this->packetInfo.length = (XMP_Int32)xmpLen;
+					this->packetInfo.padSize   = 0;	// Assume the rest for now, set later in ProcessXMP.
+					this->packetInfo.charForm  = kXMP_CharUnknown;
+					this->packetInfo.writeable = true;
+				}
+				break;
+
+			case kSegment_ExtXMP :
+				if ( readExtXMP ) ReadExtendedXMP ( fileRef, contentOrigin, contentLen, totalPortionLen, &extXMP );
+				break;
+
+			default :
+				break;	// Not metadata, nothing to read.
 
 		}
-		
-		// None of the above, seek to the next marker.
-		fileRef->Seek ( (contentOrigin + contentLen) , kXMP_SeekFromStart );
 
 	}
 
-	if ( ! extXMP.empty() ) {
+	// Keep the complete extended XMP streams for ProcessXMP. The portions must exactly cover the
+	// full length, without gaps or overlaps.
 
-		// We have extended XMP. Find out which ones are complete, collapse them into a single
-		// string, and save them for ProcessXMP.
+	for ( size_t i = 0; i < extXMP.size(); ++i ) {
 
-		ExtendedXMPInfo::iterator guidPos = extXMP.begin();
-		ExtendedXMPInfo::iterator guidEnd = extXMP.end();
+		ExtXMPStream & thisStream = extXMP[i];
+		std::sort ( thisStream.portions.begin(), thisStream.portions.end() );
 
-		for ( ; guidPos != guidEnd; ++guidPos ) {
-
-			ExtXMPContent & thisContent = guidPos->second;
-			ExtXMPPortions::iterator partZero = thisContent.portions.begin();
-			ExtXMPPortions::iterator partEnd  = thisContent.portions.end();
-			ExtXMPPortions::iterator partPos  = partZero;
+		#if Trace_UnlimitedJPEG
+			printf ( "Extended XMP portions for GUID %.32s, full length %d\n", thisStream.guid.data, thisStream.length );
+		#endif
 
+		size_t j = 0, nextOffset = 0;
+		for ( ; j < thisStream.portions.size(); ++j ) {
+			const ExtXMPPortion & portion = thisStream.portions[j];
 			#if Trace_UnlimitedJPEG
-				printf ( "Extended XMP portions for GUID %.32s, full length %d\n",
-					     guidPos->first.data, guidPos->second.length );
-				printf ( "  Offset %d, length %d, next offset %d\n",
-						 partZero->first, partZero->second.size(), (partZero->first + partZero->second.size()) );
+				printf ( "  Offset %d, length %d\n", portion.first, portion.second );
 			#endif
+			if ( portion.first != nextOffset ) break;	// Quit if not contiguous.
+			nextOffset += portion.second;
+		}
 
-			for ( ++partPos; partPos != partEnd; ++partPos ) {
-				#if Trace_UnlimitedJPEG
-					printf ( "  Offset %d, length %d, next offset %d\n",
-							 partPos->first, partPos->second.size(), (partPos->first + partPos->second.size()) );
-				#endif
-				if ( partPos->first != partZero->second.size() ) break;	// Quit if not contiguous.
-				partZero->second.append ( partPos->second );
-			}
-
-			if ( (partPos == partEnd) && (partZero->first == 0) && (partZero->second.size() == thisContent.length) ) {
-				// This is a complete extended XMP stream.
-				this->extendedXMP.insert ( ExtendedXMPMap::value_type ( guidPos->first, partZero->second ) );
-				#if Trace_UnlimitedJPEG
-					printf ( "Full extended XMP for GUID %.32s, full length %d\n",
-							 guidPos->first.data, partZero->second.size() );
-				#endif
-			}
-
+		if ( (j == thisStream.portions.size()) && (nextOffset == thisStream.length) ) {
+			// This is a complete extended XMP stream.
+			this->extendedXMP[thisStream.guid].swap ( thisStream.content );
+			#if Trace_UnlimitedJPEG
+				printf ( "Full extended XMP for GUID %.32s, full length %d\n", thisStream.guid.data, thisStream.length );
+			#endif
 		}
 
 	}
@@ -545,6 +634,7 @@ void JPEG_MetaHandler::ProcessXMP()
 	if ( this->parent ){
 		readOnly = ((this->parent->openFlags & kXMPFiles_OpenForUpdate) == 0);
 	}
+	bool fastRead = readOnly && XMP_OptionIsSet ( this->parent->openFlags, kXMPFiles_OpenFastRead );
 	if ( readOnly ) {
 		if ( this->exifMgr == 0 ) this->exifMgr = new TIFF_MemoryReader();
 		this->psirMgr = new PSIR_MemoryReader();
@@ -605,6 +695,7 @@ void JPEG_MetaHandler::ProcessXMP()
 	// should they want to proceed with that.
 
 	bool haveXMP = false;
+	bool xmpParsed = false;
 
 	if ( ! this->xmpPacket.empty() ) {
 		XMP_Assert ( this->containsXMP );
@@ -613,6 +704,7 @@ void JPEG_MetaHandler::ProcessXMP()
 		XMP_StringLen packetLen = (XMP_StringLen)this->xmpPacket.size();
 		try {
 			this->xmpObj.ParseFromBuffer ( packetStr, packetLen );
+			xmpParsed = true;
 		} catch ( ... ) { /* Ignore parsing failures, someday we hope to get partial XMP back. */ }
 		haveXMP = true;
 	}
@@ -651,7 +743,14 @@ void JPEG_MetaHandler::ProcessXMP()
 
 	}
 
-	// Process the legacy metadata.
+	// Process the legacy metadata. A fast read does not parse the IPTC if the XMP is known to be
+	// current, the import would keep the XMP's values anyway.
+
+	if ( fastRead && xmpParsed && XMPIsAuthoritative ( exif, iptcDigestState, this->xmpObj, options ) ) {
+		haveIPTC = false;
+		iptcInfo.dataLen = 0;
+		options &= ~k2XMP_FileHadIPTC;
+	}
 
 	if ( haveIPTC && (! haveXMP) && (iptcDigestState == kDigestMatches) ) iptcDigestState = kDigestMissing;
 	if (iptcInfo.dataLen) iptc.ParseMemoryDataSets ( iptcInfo.dataPtr, iptcInfo.dataLen );
@@ -661,6 +760,122 @@ void JPEG_MetaHandler::ProcessXMP()
 
 }	// JPEG_MetaHandler::ProcessXMP
 
+// =================================================================================================
+// AddChangedRanges
+// ================
+//
+// Compare the new content of a marker segment with the original, add ranges for the bytes that
+// differ. Nearby differences are merged, a seek and write costs more than rewriting a few equal
+// bytes. A shorter new content is followed by zeros out to the old length, the TIFF stream ignores
+// bytes beyond its last offset.
+
+static void AddChangedRanges ( XMP_Int64 fileOffset, const XMP_Uns8 * newPtr, size_t newLen,
+							   const XMP_Uns8 * oldPtr, size_t oldLen, JPEG_MetaHandler::UpdatePlan * plan )
+{
+	static const size_t kMergeGap = 64;
+
+	const size_t commonLen = std::min ( newLen, oldLen );
+	size_t i = 0;
+
+	while ( true ) {
+
+		while ( (i < commonLen) && (newPtr[i] == oldPtr[i]) ) ++i;
+		if ( i >= newLen ) break;
+
+		size_t start = i, lastDiff = i;
+		for ( ++i; i < newLen; ++i ) {
+			if ( (i >= commonLen) || (newPtr[i] != oldPtr[i]) ) {
+				lastDiff = i;
+			} else if ( (i - lastDiff) > kMergeGap ) {
+				break;
+			}
+		}
+
+		plan->push_back ( JPEG_MetaHandler::UpdateRange ( (fileOffset + start), (newPtr + start), (XMP_Uns32)(lastDiff + 1 - start) ) );
+		i = lastDiff + 1;
+
+	}
+
+	if ( oldLen > newLen ) {
+		size_t zeroStart = newLen, zeroEnd = oldLen;
+		while ( (zeroStart < zeroEnd) && (oldPtr[zeroStart] == 0) ) ++zeroStart;
+		while ( (zeroEnd > zeroStart) && (oldPtr[zeroEnd-1] == 0) ) --zeroEnd;
+		if ( zeroStart < zeroEnd ) {
+			plan->push_back ( JPEG_MetaHandler::UpdateRange ( (fileOffset + zeroStart), 0, (XMP_Uns32)(zeroEnd - zeroStart) ) );
+		}
+	}
+
+}	// AddChangedRanges
+
+// =================================================================================================
+// JPEG_MetaHandler::PlanInPlaceUpdate
+// ===================================
+//
+// Decide whether the update can be written into the existing marker segments, without moving any
+// other part of the file. This can only happen if all of the following are true:
+//	- There is a standard packet in the file.
+//	- There is no extended XMP in the file.
+//	- The new XMP can fit in the old space, without extensions. It has been serialized to the old
+//	  packet length by UpdateFile, using the packet padding.
+//	- A changed Exif fits in its one APP1 segment. That can use trailing space trimmed by ProcessXMP.
+//	- A changed PSIR (the IPTC is in the PSIR) is the same size as its one APP13 segment. Unlike the
+//	  TIFF stream, the image resources can't be followed by padding.
+//
+// The Exif and PSIR are updated in memory here. That is harmless if the plan fails, WriteTempFile
+// gets the same streams from a second UpdateMemoryStream or UpdateMemoryResources call.
+
+bool JPEG_MetaHandler::PlanInPlaceUpdate ( UpdatePlan * plan )
+{
+	plan->clear();
+
+	XMP_Int64 oldPacketOffset = this->packetInfo.offset;
+	XMP_Int32 oldPacketLength = this->packetInfo.length;
+
+	if ( oldPacketOffset == kXMPFiles_UnknownOffset ) oldPacketOffset = 0;	// ! Simplify checks.
+	if ( oldPacketLength == kXMPFiles_UnknownLength ) oldPacketLength = 0;
+
+	bool fileHadXMP = ((oldPacketOffset != 0) && (oldPacketLength != 0));
+	if ( (! fileHadXMP) || (this->xmpPacket.size() > (size_t)oldPacketLength) ) return false;
+	if ( ! this->extendedXMP.empty() ) return false;
+
+	if ( (this->exifMgr != 0) && this->exifMgr->IsLegacyChanged() ) {
+
+		void* exifPtr;
+		XMP_Uns32 exifLen = this->exifMgr->UpdateMemoryStream ( &exifPtr );
+		const SegmentInfo * exifSegment = this->FindOnlySegment ( kSegment_Exif );
+		if ( (exifSegment == 0) || (exifLen == 0) ) return false;
+		if ( exifLen > (exifSegment->contentLen - kExifSignatureLength) ) return false;
+
+		AddChangedRanges ( (exifSegment->offset + 4 + kExifSignatureLength), (XMP_Uns8*)exifPtr, exifLen,
+						   (const XMP_Uns8*)this->exifContents.data(), this->exifContents.size(), plan );
+
+	}
+
+	if ( (this->psirMgr != 0) && this->psirMgr->IsLegacyChanged() ) {
+
+		void* psirPtr;
+		XMP_Uns32 psirLen = this->psirMgr->UpdateMemoryResources ( &psirPtr );
+		const SegmentInfo * psirSegment = this->FindOnlySegment ( kSegment_PSIR );
+		if ( (psirSegment == 0) || (psirLen != (psirSegment->contentLen - kPSIRSignatureLength)) ) return false;
+
+		AddChangedRanges ( (psirSegment->offset + 4 + kPSIRSignatureLength), (XMP_Uns8*)psirPtr, psirLen,
+						   (const XMP_Uns8*)this->psirContents.data(), this->psirContents.size(), plan );
+
+	}
+
+	if ( this->xmpPacket.size() < (size_t)oldPacketLength ) {
+		// They ought to match, cheap to be sure.
+		size_t extraSpace = (size_t)oldPacketLength - this->xmpPacket.size();
+		this->xmpPacket.append ( extraSpace, ' ' );
+	}
+
+	XMP_Assert ( this->xmpPacket.size() == (size_t)oldPacketLength );	// ! Done by common PutXMP logic.
+	plan->push_back ( UpdateRange ( oldPacketOffset, (const XMP_Uns8*)this->xmpPacket.data(), (XMP_Uns32)this->xmpPacket.size() ) );
+
+	return true;
+
+}	// JPEG_MetaHandler::PlanInPlaceUpdate
+
 // =================================================================================================
 // JPEG_MetaHandler::UpdateFile
 // ============================
@@ -680,7 +895,9 @@ void JPEG_MetaHandler::UpdateFile ( bool doSafeUpdate )
 	// Update the IPTC-IIM and native TIFF/Exif metadata. ExportPhotoData also trips the tiff: and
 	// exif: copies from the XMP, so reserialize the now final XMP packet.
 
+	XMPFiles_Metrics::PhaseTimer exportTimer ( this->parent->format, kXMPFiles_Phase_ExportXMPtoJTP );
 	ExportPhotoData ( kXMP_JPEGFile, &this->xmpObj, this->exifMgr, this->iptcMgr, this->psirMgr );
+	exportTimer.Stop();
 
 	try {
 		XMP_OptionBits options = kXMP_UseCompactFormat;
@@ -690,44 +907,38 @@ void JPEG_MetaHandler::UpdateFile ( bool doSafeUpdate )
 		this->xmpObj.SerializeToBuffer ( &this->xmpPacket, kXMP_UseCompactFormat );
 	}
 
-	// Decide whether to do an in-place update. This can only happen if all of the following are true:
-	//	- There is a standard packet in the file.
-	//	- There is no extended XMP in the file.
-	//	- The are no changes to the legacy Exif or PSIR portions. (The IPTC is in the PSIR.)
-	//	- The new XMP can fit in the old space, without extensions.
-
-	bool doInPlace = (fileHadXMP && (this->xmpPacket.size() <= (size_t)oldPacketLength));
+	// Decide whether to do an in-place update, see PlanInPlaceUpdate. The plan only contains the
+	// byte ranges that differ from the file, nothing is written unless everything fits.
 
-	if ( ! this->extendedXMP.empty() ) doInPlace = false;
-
-	if ( (this->exifMgr != 0) && (this->exifMgr->IsLegacyChanged()) ) doInPlace = false;
-	if ( (this->psirMgr != 0) && (this->psirMgr->IsLegacyChanged()) ) doInPlace = false;
+	UpdatePlan plan;
+	bool doInPlace = this->PlanInPlaceUpdate ( &plan );
 
 	if ( doInPlace ) {
 
-		#if GatherPerformanceData
-			sAPIPerf->back().extraInfo += ", JPEG in-place update";
-		#endif
-
-		if ( this->xmpPacket.size() < (size_t)this->packetInfo.length ) {
-			// They ought to match, cheap to be sure.
-			size_t extraSpace = (size_t)this->packetInfo.length - this->xmpPacket.size();
-			this->xmpPacket.append ( extraSpace, ' ' );
-		}
+		XMPFiles_Metrics::NoteUpdate ( this->parent->format, true );
 
+		static const XMP_Uns8 kZeros [256] = { 0 };
 		XMP_IO* liveFile = this->parent->ioRef;
-		std::string & newPacket = this->xmpPacket;
 
-		XMP_Assert ( newPacket.size() == (size_t)oldPacketLength );	// ! Done by common PutXMP logic.
-
-		liveFile->Seek ( oldPacketOffset, kXMP_SeekFromStart  );
-		liveFile->Write ( newPacket.c_str(), (XMP_Int32)newPacket.size() );
+		std::sort ( plan.begin(), plan.end() );	// Write in file order for some locality.
+
+		for ( size_t i = 0; i < plan.size(); ++i ) {
+			const UpdateRange & range = plan[i];
+			liveFile->Seek ( range.offset, kXMP_SeekFromStart );
+			if ( range.dataPtr != 0 ) {
+				liveFile->Write ( range.dataPtr, range.dataLen );
+			} else {
+				for ( XMP_Uns32 zeroLen = range.dataLen; zeroLen > 0; ) {
+					XMP_Uns32 ioCount = std::min ( zeroLen, (XMP_Uns32)sizeof(kZeros) );
+					liveFile->Write ( kZeros, ioCount );
+					zeroLen -= ioCount;
+				}
+			}
+		}
 
 	} else {
 
-		#if GatherPerformanceData
-			sAPIPerf->back().extraInfo += ", JPEG copy update";
-		#endif
+		XMPFiles_Metrics::NoteUpdate ( this->parent->format, false );
 
 		XMP_IO* origRef = this->parent->ioRef;
 		XMP_IO* tempRef = origRef->DeriveTemp();
@@ -751,6 +962,45 @@ void JPEG_MetaHandler::UpdateFile ( bool doSafeUpdate )
 
 }	// JPEG_MetaHandler::UpdateFile
 
+// =================================================================================================
+// JPEG_MetaHandler::CopySegments
+// ==============================
+//
+// Copy a range of indexed segments to the temp file, optionally skipping the metadata segments.
+// Segments that are adjacent in the source are copied with one XIO::Copy.
+
+void JPEG_MetaHandler::CopySegments ( XMP_IO* tempRef, size_t first, size_t limit, bool skipMetadata )
+{
+	XMP_IO* origRef = this->parent->ioRef;
+
+	XMP_AbortProc abortProc  = this->parent->abortProc;
+	void *        abortArg   = this->parent->abortArg;
+
+	size_t i = first;
+
+	while ( i < limit ) {
+
+		if ( skipMetadata && (this->segments[i].kind != kSegment_Other) ) {
+			++i;
+			continue;
+		}
+
+		XMP_Int64 runOrigin = this->segments[i].offset;
+		XMP_Int64 runEnd = runOrigin + 4 + this->segments[i].contentLen;
+
+		for ( ++i; i < limit; ++i ) {
+			const SegmentInfo & segment = this->segments[i];
+			if ( (segment.offset != runEnd) || (skipMetadata && (segment.kind != kSegment_Other)) ) break;
+			runEnd += 4 + segment.contentLen;
+		}
+
+		origRef->Seek ( runOrigin, kXMP_SeekFromStart );
+		XIO::Copy ( origRef, tempRef, (runEnd - runOrigin), abortProc, abortArg );
+
+	}
+
+}	// JPEG_MetaHandler::CopySegments
+
 // =================================================================================================
 // JPEG_MetaHandler::WriteTempFile
 // ===============================
@@ -761,29 +1011,29 @@ void JPEG_MetaHandler::UpdateFile ( bool doSafeUpdate )
 // segments are copied first. Then the new Exif, XMP, and PSIR marker segments are written. Then the
 // rest of the file is copied, skipping the old Exif, XMP, and PSIR. The checking for old metadata
 // stops at the first SOFn marker.
+//
+// The segments come from the index made by CacheFileData, see CopySegments.
 
 void JPEG_MetaHandler::WriteTempFile ( XMP_IO* tempRef )
 {
 	XMP_IO* origRef = this->parent->ioRef;
 
-	XMP_AbortProc abortProc  = this->parent->abortProc;
-	void *        abortArg   = this->parent->abortArg;
-	const bool    checkAbort = (abortProc != 0);
-
-	XMP_Uns16 marker, contentLen;
+	XMP_Uns16 marker;
 
-	static const size_t kBufferSize = 64*1024;	// Enough for a segment with maximum contents.
-	XMP_Uns8 buffer [kBufferSize];
-	
 	XMP_Int64 origLength = origRef->Length();
 	if ( origLength == 0 ) return;	// Tolerate empty files.
 	if ( origLength < 4 ) {
 		XMP_Throw ( "JPEG must have at least SOI and EOI markers", kXMPErr_BadJPEG );
 	}
 
+	if ( this->indexState == kIndex_None ) this->IndexSegments();
+	if ( this->indexState == kIndex_BadMarker ) XMP_Throw ( "Unexpected TEM or RSTn marker", kXMPErr_BadJPEG );
+
 	if ( ! skipReconcile ) {
 		// Update the IPTC-IIM and native TIFF/Exif metadata, and reserialize the now final XMP packet.
+		XMPFiles_Metrics::PhaseTimer exportTimer ( this->parent->format, kXMPFiles_Phase_ExportXMPtoJTP );
 		ExportPhotoData ( kXMP_JPEGFile, &this->xmpObj, this->exifMgr, this->iptcMgr, this->psirMgr );
+		exportTimer.Stop();
 		this->xmpObj.SerializeToBuffer ( &this->xmpPacket, kXMP_UseCompactFormat );
 	}
 
@@ -796,33 +1046,9 @@ void JPEG_MetaHandler::WriteTempFile ( XMP_IO* tempRef )
 
 	// Copy any leading APP0 marker segments.
 
-	while ( true ) {
-
-		if ( checkAbort && abortProc(abortArg) ) {
-			XMP_Throw ( "JPEG_MetaHandler::WriteFile - User abort", kXMPErr_UserAbort );
-		}
-		
-		if ( ! XIO::CheckFileSpace ( origRef, 2 ) ) break;	// Tolerate a file that ends abruptly.
-		
-		marker = XIO::ReadUns16_BE ( origRef );	// Read the next marker.
-		if ( marker == 0xFFFF ) {
-			// Have a pad byte, skip it. These are almost unheard of, so efficiency isn't critical.
-			origRef->Seek ( -1, kXMP_SeekFromCurrent );	// Skip the first 0xFF, read the second again.
-			continue;
-		}
-
-		if ( marker != 0xFFE0 ) break;	// Have a non-APP0 marker.
-		XIO::WriteUns16_BE ( tempRef, marker );	// Write the APP0 marker.
-		
-		contentLen = XIO::ReadUns16_BE ( origRef );	// Copy the APP0 segment's length.
-		XIO::WriteUns16_BE ( tempRef, contentLen );
-
-		if ( contentLen < 2 ) XMP_Throw ( "Invalid JPEG segment length", kXMPErr_BadJPEG );
-		contentLen -= 2;	// Reduce to just the content length.
-		origRef->ReadAll ( buffer, contentLen );	// Copy the APP0 segment's content.
-		tempRef->Write ( buffer, contentLen );
-
-	}
+	size_t firstNonAPP0 = 0;
+	while ( (firstNonAPP0 < this->segments.size()) && (this->segments[firstNonAPP0].marker == 0xFFE0) ) ++firstNonAPP0;
+	this->CopySegments ( tempRef, 0, firstNonAPP0, false );
 
 	// Write the new Exif APP1 marker segment.
 
@@ -899,91 +1125,17 @@ void JPEG_MetaHandler::WriteTempFile ( XMP_IO* tempRef )
 	}
 
 	// Copy remaining marker segments, skipping old metadata, to the first SOS marker or to EOI.
-	origRef->Seek ( -2, kXMP_SeekFromCurrent );	// Back up to the marker from the end of the APP0 copy loop.
-	
-	while ( true ) {
-
-		if ( checkAbort && abortProc(abortArg) ) {
-			XMP_Throw ( "JPEG_MetaHandler::WriteFile - User abort", kXMPErr_UserAbort );
-		}
-
-		if ( ! XIO::CheckFileSpace ( origRef, 2 ) ) break;	// Tolerate a file that ends abruptly.
-		
-		marker = XIO::ReadUns16_BE ( origRef );	// Read the next marker.
-		if ( marker == 0xFFFF ) {
-			// Have a pad byte, skip it. These are almost unheard of, so efficiency isn't critical.
-			origRef->Seek ( -1, kXMP_SeekFromCurrent );	// Skip the first 0xFF, read the second again.
-			continue;
-		}
-
-		if ( (marker == 0xFFDA) || (marker == 0xFFD9) ) {	// Quit at the first SOS marker or at EOI.
-			origRef->Seek ( -2, kXMP_SeekFromCurrent );	// The tail copy must include this marker.
-			break;
-		}
-
-		if ( (marker == 0xFF01) ||	// Ill-formed file if we encounter a TEM or RSTn marker.
-			 ((0xFFD0 <= marker) && (marker <= 0xFFD7)) ) {
-			XMP_Throw ( "Unexpected TEM or RSTn marker", kXMPErr_BadJPEG );
-		}
-
-		contentLen = XIO::ReadUns16_BE ( origRef );	// Read this segment's length.
-		if ( contentLen < 2 ) XMP_Throw ( "Invalid JPEG segment length", kXMPErr_BadJPEG );
-		contentLen -= 2;	// Reduce to just the content length.
-		
-		XMP_Int64 contentOrigin = origRef->Offset();
-		bool copySegment = true;
-		size_t signatureLen;
-
-		if ( (marker == 0xFFED) && (contentLen >= kPSIRSignatureLength) ) {
-
-			// This is an APP13 segment, skip if it is the old PSIR.
-			signatureLen = origRef->Read ( buffer, kPSIRSignatureLength );
-			if ( (signatureLen == kPSIRSignatureLength) &&
-				 CheckBytes ( &buffer[0], kPSIRSignatureString, kPSIRSignatureLength ) ) {
-				copySegment = false;
-			}
-
-		} else if ( (marker == 0xFFE1) && (contentLen >= kExifSignatureLength) ) {	// Check for the shortest signature.
-
-			// This is an APP1 segment, skip if it is the old Exif or XMP.
-			
-			XMP_Assert ( (kExifSignatureLength < kMainXMPSignatureLength) &&
-						 (kMainXMPSignatureLength < kExtXMPSignatureLength) );
-			signatureLen = origRef->Read ( buffer, kExtXMPSignatureLength );	// Read for the longest signature.
-
-			if ( (signatureLen >= kExifSignatureLength) &&
-				 (CheckBytes ( &buffer[0], kExifSignatureString, kExifSignatureLength ) ||
-				  CheckBytes ( &buffer[0], kExifSignatureAltStr, kExifSignatureLength )) ) {
-				copySegment = false;
-			}
-			
-			if ( copySegment && (signatureLen >= kMainXMPSignatureLength) &&
-				 CheckBytes ( &buffer[0], kMainXMPSignatureString, kMainXMPSignatureLength ) ) {
-				copySegment = false;
-			}
-			
-			if ( copySegment && (signatureLen == kExtXMPSignatureLength) &&
-				CheckBytes ( &buffer[0], kExtXMPSignatureString, kExtXMPSignatureLength ) ) {
-				copySegment = false;
-			}
-			
-		}
-		
-		if ( ! copySegment ) {
-			origRef->Seek ( (contentOrigin + contentLen), kXMP_SeekFromStart );
-		} else {
-			XIO::WriteUns16_BE ( tempRef, marker );
-			XIO::WriteUns16_BE ( tempRef, (contentLen + 2) );
-			origRef->Seek ( contentOrigin, kXMP_SeekFromStart );
-			origRef->ReadAll ( buffer, contentLen );
-			tempRef->Write ( buffer, contentLen );
-		}
 
-	}
+	this->CopySegments ( tempRef, firstNonAPP0, this->segments.size(), true );
 
-	// Copy the remainder of the source file.
+	// Copy the remainder of the source file. The index no longer describes the file once the
+	// temp is absorbed.
 
-	XIO::Copy ( origRef, tempRef, (origLength - origRef->Offset()) );
+	origRef->Seek ( this->segmentsEnd, kXMP_SeekFromStart );
+	XIO::Copy ( origRef, tempRef, (origLength - this->segmentsEnd) );
 	this->needsUpdate = false;
 
+	this->segments.clear();
+	this->indexState = kIndex_None;
+
 }	// JPEG_MetaHandler::WriteTempFile
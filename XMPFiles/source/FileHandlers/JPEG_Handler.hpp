@@ -57,6 +57,11 @@ public:
 
 	struct GUID_32 {	// A hack to get an assignment operator for an array.
 		char data [32];
+		GUID_32() {};
+		GUID_32 ( const GUID_32 & in )
+		{
+			memcpy ( this->data, in.data, sizeof(this->data) );	// AUDIT: Use of sizeof(this->data) is safe.
+		};
 		void operator= ( const GUID_32 & in )
 		{
 			memcpy ( this->data, in.data, sizeof(this->data) );	// AUDIT: Use of sizeof(this->data) is safe.
@@ -74,9 +79,29 @@ public:
 	JPEG_MetaHandler ( XMPFiles * parent );
 	virtual ~JPEG_MetaHandler();
 
+	struct UpdateRange {	// One write of an in-place update, a null dataPtr means write zeros.
+		XMP_Int64 offset;
+		const XMP_Uns8 * dataPtr;
+		XMP_Uns32 dataLen;
+		UpdateRange ( XMP_Int64 _offset, const XMP_Uns8 * _dataPtr, XMP_Uns32 _dataLen )
+			: offset(_offset), dataPtr(_dataPtr), dataLen(_dataLen) {};
+		bool operator< ( const UpdateRange & right ) const { return (this->offset < right.offset); };
+	};
+
+	typedef std::vector < UpdateRange > UpdatePlan;
+
+	enum {	// The kinds of marker segment, from the APP1 or APP13 signature.
+		kSegment_Other   = 0,
+		kSegment_Exif    = 1,
+		kSegment_PSIR    = 2,
+		kSegment_MainXMP = 3,
+		kSegment_ExtXMP  = 4
+	};
+
 private:
 
-	JPEG_MetaHandler() : exifMgr(0), psirMgr(0), iptcMgr(0), skipReconcile(false) {};	// Hidden on purpose.
+	JPEG_MetaHandler() : exifMgr(0), psirMgr(0), iptcMgr(0), skipReconcile(false),
+						 segmentsEnd(0), indexState(kIndex_None) {};	// Hidden on purpose.
 
 	std::string exifContents;
 	std::string psirContents;
@@ -87,10 +112,39 @@ private:
 
 	bool skipReconcile;	// ! Used between UpdateFile and WriteFile.
 
+	// The marker segments before the first SOS or EOI, found by one buffered scan in IndexSegments.
+	// CacheFileData, PlanInPlaceUpdate, and WriteTempFile all work from this index. It describes
+	// the original file, WriteTempFile clears it.
+
+	struct SegmentInfo {
+		XMP_Int64 offset;		// The file offset of the marker, after any fill bytes.
+		XMP_Uns16 marker;
+		XMP_Uns16 contentLen;	// The length of the content, not including the marker and length.
+		XMP_Uns8  kind;			// One of the kSegment_* constants.
+		SegmentInfo ( XMP_Int64 _offset, XMP_Uns16 _marker, XMP_Uns16 _contentLen, XMP_Uns8 _kind )
+			: offset(_offset), marker(_marker), contentLen(_contentLen), kind(_kind) {};
+	};
+
+	enum {	// Why the scan stopped.
+		kIndex_None      = 0,	// Not scanned.
+		kIndex_Complete  = 1,	// At an SOS or EOI marker.
+		kIndex_Truncated = 2,	// At the end of the file.
+		kIndex_BadMarker = 3	// At a TEM or RSTn marker, the file is ill-formed.
+	};
+
+	std::vector < SegmentInfo > segments;
+	XMP_Int64 segmentsEnd;	// The offset where the scan stopped, the start of the image data.
+	XMP_Uns8  indexState;
+
+	void IndexSegments();
+	const SegmentInfo * FindOnlySegment ( XMP_Uns8 kind ) const;
+	void CopySegments ( XMP_IO* tempRef, size_t first, size_t limit, bool skipMetadata );
+
+	bool PlanInPlaceUpdate ( UpdatePlan * plan );
+
 	typedef std::map < GUID_32, std::string > ExtendedXMPMap;
 
 	ExtendedXMPMap extendedXMP;	// ! Only contains those with complete data.
-//	void CacheExtendedXMP ( ExtendedXMPInfo * extXMP, XMP_Uns8 * buffer, size_t bufferLen );
 
 };	// JPEG_MetaHandler
 
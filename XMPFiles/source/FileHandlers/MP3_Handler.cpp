@@ -20,6 +20,7 @@
 
 #include "XMPFiles/source/FileHandlers/MP3_Handler.hpp"
 
+#include <algorithm>
 #include <sstream>
 
 // =================================================================================================
@@ -40,6 +41,64 @@ struct ReconProps {
 const static XMP_Uns32 XMP_V23_ID = 0x50524956;	// PRIV
 const static XMP_Uns32 XMP_V22_ID = 0x50525600;	// PRV
 
+// Padding policy for a tag that has to grow. The audio data behind the tag is moved then, so leave
+// room for the next edit: at least 2K, or half the XMP frame since that is what usually grows. A
+// tag is only shrunk for kXMPFiles_OptimizeFileLayout, and only if that saves more than 8K.
+const static XMP_Int64 kID3_MinPadding = 2*1024;
+const static XMP_Int64 kID3_PaddingRounding = 1024;
+const static XMP_Int64 kID3_ShrinkThreshold = 8*1024;
+
+static XMP_Int64 ID3PaddingFor ( XMP_Int64 xmpFrameSize )
+{
+	XMP_Int64 padding = std::max ( kID3_MinPadding, (xmpFrameSize / 2) );
+	return (padding + kID3_PaddingRounding - 1) & ~(kID3_PaddingRounding - 1);
+}
+
+// =================================================================================================
+// ID3TagWindow
+// ============
+//
+// Holds a window of the tag in memory so the frames are parsed without a read per frame. A tag
+// that fits into kWindowSize is read at once. Beyond that the window is refilled at the first frame
+// that is not in it, the content of binary frames is never requested and thus skipped.
+
+class ID3TagWindow {
+public:
+
+	enum { kWindowSize = 64*1024 };
+
+	ID3TagWindow ( XMP_IO* _fileRef, XMP_Int64 _tagEnd )
+		: fileRef(_fileRef), tagEnd(_tagEnd), windowPos(0), windowLen(0) {};
+
+	// Returns the bytes in [pos, pos+len). Reads up to the tag end if possible, beyond it only
+	// as far as the request demands (a broken frame size is caught by the padding check).
+	const char* Get ( XMP_Int64 pos, XMP_Int64 len )
+	{
+		if ( len == 0 ) return 0;
+		if ( (pos < this->windowPos) || ((pos + len) > (this->windowPos + this->windowLen)) ) {
+			XMP_Int64 readLen = std::max ( len, std::min ( (XMP_Int64)kWindowSize, (this->tagEnd - pos) ) );
+			if ( this->window.size() < (size_t)readLen ) this->window.resize ( (size_t)readLen );
+			this->fileRef->Seek ( pos, kXMP_SeekFromStart );
+			this->fileRef->ReadAll ( &this->window[0], (XMP_Uns32)readLen );
+			this->windowPos = pos;
+			this->windowLen = readLen;
+		}
+		return &this->window[(size_t)(pos - this->windowPos)];
+	}
+
+private:
+
+	XMP_IO* fileRef;
+	XMP_Int64 tagEnd;
+
+	std::vector<char> window;
+	XMP_Int64 windowPos;
+	XMP_Int64 windowLen;
+
+};	// ID3TagWindow
+
+// =================================================================================================
+
 const static ReconProps reconProps[] = {
 	{ "TPE1", "TP1", kXMP_NS_DM,	"artist" },
 	{ "TALB", "TAL", kXMP_NS_DM,	"album"  },
@@ -214,16 +273,24 @@ void MP3_MetaHandler::CacheFileData()
 		frameHeaderSize = ID3v2Frame::kV22_FrameHeaderSize;
 	}
 
-	while ( file->Offset() < this->oldTagSize ) {
+	ID3TagWindow tagWindow ( file, this->oldTagSize );
+	XMP_Int64 framePos = file->Offset();
+
+	while ( framePos < this->oldTagSize ) {
 
 		curFrame = new ID3v2Frame();
 
 		try {
-			XMP_Int64 frameSize = curFrame->read ( file, this->majorVersion );
-			if ( frameSize == 0 ) {
+			XMP_Int32 headerSize = curFrame->parseHeader ( tagWindow.Get ( framePos, frameHeaderSize ), framePos, this->majorVersion );
+			if ( headerSize == 0 ) {
 				delete curFrame; // ..since not becoming part of vector for latter delete.
 				break;			 // not a throw. There's nothing wrong with padding.
 			}
+			// binary frames stay in the file, UpdateFile reads them only if they have to move
+			if ( ! curFrame->isBinary() ) {
+				curFrame->setContent ( tagWindow.Get ( (framePos + headerSize), curFrame->contentSize ) );
+			}
+			framePos += (headerSize + curFrame->contentSize);
 			this->containsXMP = true;
 		} catch ( ... ) {
 			delete curFrame;
@@ -244,7 +311,7 @@ void MP3_MetaHandler::CacheFileData()
 			this->framesMap[xmpID] = curFrame;
 	
 			this->packetInfo.length = curFrame->contentSize - 4; // content minus "XMP\0"
-			this->packetInfo.offset = ( file->Offset() - this->packetInfo.length );
+			this->packetInfo.offset = ( framePos - this->packetInfo.length );
 	
 			this->xmpPacket.erase(); //safety
 			this->xmpPacket.assign( &curFrame->content[4], curFrame->contentSize - 4 );
@@ -253,28 +320,26 @@ void MP3_MetaHandler::CacheFileData()
 		}
 
 		// No space for another frame? => assume into ID3v2.4 padding.
-		XMP_Int64 newPos = file->Offset();
-		XMP_Int64 spaceLeft = this->oldTagSize - newPos;	// Depends on first check below!
-		if ( (newPos > this->oldTagSize) || (spaceLeft < frameHeaderSize ) ) break;
+		XMP_Int64 spaceLeft = this->oldTagSize - framePos;	// Depends on first check below!
+		if ( (framePos > this->oldTagSize) || (spaceLeft < frameHeaderSize ) ) break;
 
 	}
 
 	////////////////////////////////////////////////////
 	// padding
 
-	this->oldPadding = this->oldTagSize - file->Offset();
+	this->oldPadding = this->oldTagSize - framePos;
 	this->oldFramesSize = this->oldTagSize - ID3Header::kID3_TagHeaderSize - this->oldPadding;
 
 	XMP_Validate ( (this->oldPadding >= 0), "illegal oldTagSize or padding value", kXMPErr_BadFileFormat );
 
 	for ( XMP_Int64 i = this->oldPadding; i > 0; ) {
-		if ( i >= 8 ) {
-			if ( XIO::ReadInt64_BE(file) != 0 ) XMP_Throw ( "padding not nulled out", kXMPErr_BadFileFormat );
-			i -= 8;
-			continue;
+		XMP_Int64 blockLen = std::min ( (XMP_Int64)ID3TagWindow::kWindowSize, i );
+		const char* block = tagWindow.Get ( (this->oldTagSize - i), blockLen );
+		for ( XMP_Int64 j = 0; j < blockLen; ++j ) {
+			if ( block[j] != 0 ) XMP_Throw ( "padding not nulled out", kXMPErr_BadFileFormat );
 		}
-		if ( XIO::ReadUns8(file) != 0) XMP_Throw ( "padding(2) not nulled out", kXMPErr_BadFileFormat );
-		i--;
+		i -= blockLen;
 	}
 
 	//// read ID3v1 tag
@@ -675,17 +740,28 @@ void MP3_MetaHandler::UpdateFile ( bool doSafeUpdate )
 		if ( framesVector[i]->active ) newFramesSize += (frameHeaderSize + framesVector[i]->contentSize);
 	}
 
+	// The audio data is only moved if the frames no longer fit, or on request when shrinking the
+	// tag saves more than 8K. Otherwise the tag keeps its size and the frames fill what we got.
+	bool optimizeFileLayout = XMP_OptionIsSet ( this->parent->openFlags, kXMPFiles_OptimizeFileLayout );
 	mustShift = (newFramesSize > (XMP_Int64)(oldTagSize - ID3Header::kID3_TagHeaderSize)) ||
-	//optimization: If more than 8K can be saved by rewriting the MP3, go do it:
-				((newFramesSize + 8*1024) < oldTagSize );
+				(optimizeFileLayout && ((newFramesSize + kID3_ShrinkThreshold) < oldTagSize));
 
 	if ( ! mustShift )	{	// fill what we got
 		newTagSize = oldTagSize;
-	} else { // if need to shift anyway, get some nice 2K padding
-		newTagSize = newFramesSize + 2048 + ID3Header::kID3_TagHeaderSize;
+	} else { // if need to shift anyway, leave room for the next edit
+		newTagSize = newFramesSize + ID3PaddingFor ( framesMap[xmpID]->contentSize ) + ID3Header::kID3_TagHeaderSize;
 	}
 	newPadding = newTagSize - ID3Header::kID3_TagHeaderSize - newFramesSize;
 
+	// binary frames were not read, load those that move before anything is written
+	XMP_Int64 framePos = ID3Header::kID3_TagHeaderSize;
+	for ( XMP_Uns32 i = 0; i < framesVector.size(); i++ ) {
+		ID3v2Frame* curFrame = framesVector[i];
+		if ( ! curFrame->active ) continue;
+		if ( (! curFrame->hasContent()) && (curFrame->offset != framePos) ) curFrame->readContent ( file, majorVersion );
+		framePos += (frameHeaderSize + curFrame->contentSize);
+	}
+
 	// shifting needed? -> shift
 	if ( mustShift ) {
 		XMP_Int64 filesize = file ->Length();
@@ -696,25 +772,37 @@ void MP3_MetaHandler::UpdateFile ( bool doSafeUpdate )
 		}
 	}
 
-	// correct size stuff, write out header
-	file ->Rewind();
-	id3Header.write ( file, newTagSize );
+	// correct size stuff, write out header (the tag region in front of the audio is never moved)
+	if ( (! this->hasID3Tag) || (newTagSize != oldTagSize) ) {
+		file ->Rewind();
+		id3Header.write ( file, newTagSize );
+	}
 
-	// write out tags
+	// write out tags, leading frames that are unchanged and still in place are left alone
+	framePos = ID3Header::kID3_TagHeaderSize;
 	for ( XMP_Uns32 i = 0; i < framesVector.size(); i++ ) {
-		if ( framesVector[i]->active ) framesVector[i]->write ( file, majorVersion );
+		ID3v2Frame* curFrame = framesVector[i];
+		if ( ! curFrame->active ) continue;
+		if ( curFrame->changed || (curFrame->offset != framePos) ) {
+			file->Seek ( framePos, kXMP_SeekFromStart );
+			curFrame->write ( file, majorVersion );
+		}
+		framePos += (frameHeaderSize + curFrame->contentSize);
 	}
-
-	// write out padding:
-	for ( XMP_Int64 i = newPadding; i > 0; ) {
-		const XMP_Uns64 zero = 0;
-		if ( i >= 8 ) {
-			file->Write ( &zero, 8  );
-			i -= 8;
-			continue;
+	XMP_Assert ( framePos == (ID3Header::kID3_TagHeaderSize + newFramesSize) );
+
+	// write out padding, in place only the part that held frames before needs to be zeroed
+	XMP_Int64 zeroEnd = newTagSize;
+	if ( ! mustShift ) zeroEnd = std::min ( newTagSize, (oldTagSize - oldPadding) );
+	if ( framePos < zeroEnd ) {
+		const size_t kZeroBlockSize = 64*1024;
+		std::vector<XMP_Uns8> zeros ( (size_t) std::min ( (XMP_Int64)kZeroBlockSize, (zeroEnd - framePos) ), 0 );
+		file->Seek ( framePos, kXMP_SeekFromStart );
+		for ( XMP_Int64 i = zeroEnd - framePos; i > 0; ) {
+			XMP_Uns32 ioCount = (XMP_Uns32) std::min ( (XMP_Int64)zeros.size(), i );
+			file->Write ( &zeros[0], ioCount );
+			i -= ioCount;
 		}
-		file->Write ( &zero, 1  );
-		i--;
 	}
 
 	// check end of file for ID3v1 tag
@@ -1945,8 +1945,9 @@ static void CheckFinalBox ( XMP_IO* fileRef, XMP_AbortProc abortProc, void * abo
 //
 // There are 3 file variants: normal ISO Base Media, modern QuickTime, and classic QuickTime. The
 // XMP is placed differently between the ISO and two QuickTime forms, and there is different but not
-// colliding native metadata. The entire 'moov' subtree is cached, along with the top level 'uuid'
-// box of XMP if present.
+// colliding native metadata. The 'moov' subtree is cached, along with the top level 'uuid' box of
+// XMP if present. A large 'moov' is cached without the sample tables, see MOOV_Manager::ReadMoovBox.
+// That also lets a read-only open take a 'moov' box over TopBoxSizeLimit.
 
 void MPEG4_MetaHandler::CacheFileData()
 {
@@ -1997,13 +1998,12 @@ void MPEG4_MetaHandler::CacheFileData()
 		if ( (! moovFound) && (currBox.boxType == ISOMedia::k_moov) ) {
 
 			XMP_Uns64 fullMoovSize = currBox.headerSize + currBox.contentSize;
-			if ( fullMoovSize > TopBoxSizeLimit) {	// From here on we know 32-bit offsets are safe.
+			XMP_Uns64 moovSizeLimit = ( isUpdate ) ? TopBoxSizeLimit : 0xFFFFFFFFUL;	// An update rewrites all of it.
+			if ( fullMoovSize > moovSizeLimit ) {	// From here on we know 32-bit offsets are safe.
 				XMP_Throw ( "Oversize 'moov' box", kXMPErr_EnforceFailure );
 			}
 
-			this->moovMgr.fullSubtree.assign ( (XMP_Uns32)fullMoovSize, 0 );
-			fileRef->Seek ( boxPos, kXMP_SeekFromStart );
-			fileRef->Read ( &this->moovMgr.fullSubtree[0], (XMP_Uns32)fullMoovSize );
+			this->moovMgr.ReadMoovBox ( fileRef, boxPos, (XMP_Uns32)fullMoovSize );
 
 			this->moovBoxPos = boxPos;
 			this->moovBoxSize = (XMP_Uns32)fullMoovSize;
@@ -2620,6 +2620,12 @@ void MPEG4_MetaHandler::OptimizeFileLayout()
 
 	if ( ! needsOptimization ) return;
 
+	// The 'moov' tree is parsed by ProcessXMP, which need not have been called. The 'stco' and 'co64'
+	// tables get adjusted, so they must be in memory.
+
+	if ( ! this->processedXMP ) this->moovMgr.ParseMemoryTree ( this->fileMode );
+	this->moovMgr.ReadSkippedBoxes ( originalFile );
+
 	// The file needs to be optimized. Make sure that a file over 4 GB has 'co64', not 'stco' boxes.
 	// These are needed to hold 64-bit offsets. We don't go to the effort of changing from 'stco'
 	// to 'co64', the file needs to be OK from the start. (Yes, this eliminates a marginal case of
@@ -2819,6 +2825,190 @@ void MPEG4_MetaHandler::OptimizeFileLayout()
 
 }	// MPEG4_MetaHandler::OptimizeFileLayout
 
+// =================================================================================================
+// MPEG4_MetaHandler::UpdateLeadingBoxes
+// =====================================
+//
+// Used by UpdateFile when the file layout is to be optimized and the 'moov' box is in front of all
+// 'mdat' boxes. The new 'moov' box and XMP 'uuid' box, either can be null, are written over the run
+// of top level boxes starting at the old 'moov' box. The run covers the old XMP 'uuid' box and any
+// 'free', 'skip', or 'wide' boxes. If the run is too small the rest of the file is moved down in
+// place, leaving some padding for later growth, and the 'stco' and 'co64' offsets are adjusted.
+// Either way OptimizeFileLayout has nothing left to do, instead of copying the whole file.
+//
+// Returns false without changing the file if the layout does not fit this, UpdateTopLevelBox and
+// OptimizeFileLayout then do the update.
+
+static const XMP_Uns32 kLeadingPadding = 4*1024;	// The 'free' box left after the boxes when moving the media.
+
+struct ChunkOffsetTable {
+	XMP_Uns64 fileOffset;	// The new file offset of the first entry.
+	const XMP_Uns8 * entries;
+	XMP_Uns32 count, entrySize;
+	ChunkOffsetTable ( XMP_Uns64 _fileOffset, const XMP_Uns8 * _entries, XMP_Uns32 _count, XMP_Uns32 _entrySize )
+		: fileOffset(_fileOffset), entries(_entries), count(_count), entrySize(_entrySize) {};
+};
+
+typedef std::vector < ChunkOffsetTable > ChunkOffsetTableList;
+
+bool MPEG4_MetaHandler::UpdateLeadingBoxes ( const XMP_Uns8 * newMoov, XMP_Uns32 newMoovSize,
+											 const XMP_Uns8 * newUuid, XMP_Uns32 newUuidSize )
+{
+	if ( (newMoov == 0) && (newUuid == 0) ) return false;
+	if ( this->moovBoxSize == 0 ) return false;
+
+	XMP_IO* fileRef = this->parent->ioRef;
+	XMP_Uns64 fileSize = fileRef->Length();
+
+	XMP_Uns64 currPos, nextPos;
+	ISOMedia::BoxInfo currBox;
+
+	for ( currPos = 0; currPos < this->moovBoxPos; currPos = nextPos ) {
+		nextPos = ISOMedia::GetBoxInfo ( fileRef, currPos, fileSize, &currBox, true /* throw errors */ );
+		if ( currBox.boxType == ISOMedia::k_mdat ) return false;	// OptimizeFileLayout must reorder.
+	}
+	if ( currPos != this->moovBoxPos ) return false;	// Sanity check, the 'moov' must be a top level box.
+
+	// Find the run of boxes that can be overwritten. The 'moov' box is left alone if unchanged.
+
+	XMP_Uns64 spanStart = this->moovBoxPos;
+	if ( newMoov == 0 ) spanStart += this->moovBoxSize;
+
+	XMP_Uns64 spanEnd = this->moovBoxPos + this->moovBoxSize;
+	bool haveOldUuid = (this->xmpBoxSize == 0);	// True if there is none to absorb.
+
+	while ( spanEnd < fileSize ) {
+		nextPos = ISOMedia::GetBoxInfo ( fileRef, spanEnd, fileSize, &currBox, true /* throw errors */ );
+		bool isFree = (currBox.boxType == ISOMedia::k_free) || (currBox.boxType == ISOMedia::k_skip) ||
+					  (currBox.boxType == ISOMedia::k_wide);
+		bool isOldUuid = (newUuid != 0) && (spanEnd == this->xmpBoxPos);
+		if ( ! (isFree | isOldUuid) ) break;
+		if ( isOldUuid ) haveOldUuid = true;
+		spanEnd = nextPos;
+	}
+
+	if ( (newUuid != 0) && (! haveOldUuid) ) return false;	// The old XMP 'uuid' box is elsewhere.
+	if ( spanEnd >= fileSize ) return false;	// Nothing follows, UpdateTopLevelBox just extends the file.
+
+	XMP_Uns64 newSize = (XMP_Uns64)newMoovSize + newUuidSize;
+	XMP_Uns64 oldSize = spanEnd - spanStart;
+	XMP_Uns64 shift = 0;
+
+	if ( (newSize > oldSize) || ((newSize < oldSize) && ((oldSize - newSize) < 8)) ) {
+		shift = newSize + kLeadingPadding - oldSize;
+	}
+	if ( (oldSize + shift - newSize) > 0xFFFFFFFF ) return false;	// Too much for WipeBoxFree.
+
+	ChunkOffsetTableList offsetTables;
+
+	if ( shift != 0 ) {
+
+		// Gather the 'stco' and 'co64' tables before anything is written, they must all be in
+		// memory. The media after the run moves by the shift, the 'moov' box does not.
+
+		if ( newMoov == 0 ) this->moovMgr.ReadSkippedBoxes ( fileRef );
+
+		MOOV_Manager::BoxRef  moovRef, trakRef, tempRef, tableRef;
+		MOOV_Manager::BoxInfo boxInfo;
+
+		moovRef = this->moovMgr.GetBox ( "moov", &boxInfo );
+		if ( moovRef == 0 ) return false;
+
+		for ( size_t i = 0, limit = boxInfo.childCount; i < limit; ++i ) {
+
+			trakRef = this->moovMgr.GetNthChild ( moovRef, i, &boxInfo );
+			if ( boxInfo.boxType != ISOMedia::k_trak ) continue;
+
+			tempRef = this->moovMgr.GetTypeChild ( trakRef, ISOMedia::k_mdia, 0 );
+			if ( tempRef == 0 ) continue;
+			tempRef = this->moovMgr.GetTypeChild ( tempRef, ISOMedia::k_minf, 0 );
+			if ( tempRef == 0 ) continue;
+			tempRef = this->moovMgr.GetTypeChild ( tempRef, ISOMedia::k_stbl, 0 );
+			if ( tempRef == 0 ) continue;
+
+			XMP_Uns32 entrySize = 4;
+			tableRef = this->moovMgr.GetTypeChild ( tempRef, ISOMedia::k_stco, &boxInfo );
+			if ( tableRef == 0 ) {
+				tableRef = this->moovMgr.GetTypeChild ( tempRef, ISOMedia::k_co64, &boxInfo );
+				if ( tableRef == 0 ) continue;
+				entrySize = 8;
+			}
+
+			if ( boxInfo.contentSize < 4+4 ) return false;	// Leave bad tables to OptimizeFileLayout.
+			XMP_Uns32 offsetCount = GetUns32BE ( boxInfo.content + 4 );
+			if ( ((boxInfo.contentSize - 4-4) / entrySize) < offsetCount ) return false;
+
+			if ( (entrySize == 4) && ((fileSize + shift) > 0xFFFFFFFF) ) return false;	// Needs 'co64'.
+
+			XMP_Uns64 tableOffset = this->moovBoxPos +
+									(XMP_Uns64) this->moovMgr.GetParsedOffset ( tableRef ) +
+									(XMP_Uns64) this->moovMgr.GetHeaderSize ( tableRef ) + 4+4;
+			offsetTables.push_back ( ChunkOffsetTable ( tableOffset, (boxInfo.content + 4+4), offsetCount, entrySize ) );
+
+		}
+
+		// Move everything after the run down. XIO::Move goes from the end, it is safe within a file.
+		// Don't pass the abort proc, stopping part way would leave the file corrupt.
+
+		XMP_ProgressTracker * progressTracker = this->parent->progressTracker;
+		if ( progressTracker != 0 ) progressTracker->AddTotalWork ( (float)(fileSize - spanEnd) );
+
+		XIO::Move ( fileRef, spanEnd, fileRef, (spanEnd + shift), (fileSize - spanEnd) );
+
+	}
+
+	// Write the new boxes and make the rest of the run free.
+
+	fileRef->Seek ( spanStart, kXMP_SeekFromStart );
+	if ( newMoov != 0 ) fileRef->Write ( newMoov, newMoovSize );
+	if ( newUuid != 0 ) fileRef->Write ( newUuid, newUuidSize );
+	this->moovMgr.WipeBoxFree ( fileRef, (spanStart + newSize), (XMP_Uns32)(oldSize + shift - newSize) );
+
+	if ( shift == 0 ) return true;
+
+	// Adjust the chunk offsets into the moved part of the file, in place.
+
+	XMP_Uns8 buffer [64*1024];
+
+	for ( size_t i = 0, limit = offsetTables.size(); i < limit; ++i ) {
+
+		const ChunkOffsetTable & table = offsetTables[i];
+		const XMP_Uns32 entriesPerBlock = sizeof(buffer) / table.entrySize;
+
+		fileRef->Seek ( table.fileOffset, kXMP_SeekFromStart );
+
+		for ( XMP_Uns32 done = 0, blockCount = 0; done < table.count; done += blockCount ) {
+
+			blockCount = table.count - done;
+			if ( blockCount > entriesPerBlock ) blockCount = entriesPerBlock;
+			const XMP_Uns8 * entry = table.entries + ((size_t)done * table.entrySize);
+
+			if ( table.entrySize == 4 ) {
+				for ( XMP_Uns32 j = 0; j < blockCount; ++j ) {
+					XMP_Uns32 offset = GetUns32BE ( entry + j*4 );
+					if ( offset >= spanEnd ) offset += (XMP_Uns32)shift;
+					PutUns32BE ( offset, &buffer[j*4] );
+				}
+			} else {
+				for ( XMP_Uns32 j = 0; j < blockCount; ++j ) {
+					XMP_Uns64 offset = GetUns64BE ( entry + j*8 );
+					if ( offset >= spanEnd ) offset += shift;
+					PutUns64BE ( offset, &buffer[j*8] );
+				}
+			}
+
+			fileRef->Write ( buffer, (blockCount * table.entrySize) );
+
+		}
+
+	}
+
+	if ( this->tmcdInfo.sampleOffset >= spanEnd ) this->tmcdInfo.sampleOffset += shift;
+
+	return true;
+
+}	// MPEG4_MetaHandler::UpdateLeadingBoxes
+
 // =================================================================================================
 // MPEG4_MetaHandler::UpdateFile
 // =============================
@@ -2952,13 +3142,40 @@ void MPEG4_MetaHandler::UpdateFile ( bool doSafeUpdate )
 
 	}
 
-	// Update the 'moov' subtree if necessary, and finally update the timecode sample.
+	// The uuid form of XMP has the 16-byte UUID in front of the XMP packet. Form the complete box
+	// (including size/type header) for UpdateTopLevelBox or UpdateLeadingBoxes.
+
+	RawDataBlock uuidBox;
+	if ( useUuidXMP & (! inPlaceXMP) ) {
+		XMP_Uns32 uuidSize = 4 + 4 + 16 + (XMP_Uns32)this->xmpPacket.size();
+		uuidBox.assign ( uuidSize, 0 );
+		PutUns32BE ( uuidSize, &uuidBox[0] );
+		PutUns32BE ( ISOMedia::k_uuid, &uuidBox[4] );
+		memcpy ( &uuidBox[8], ISOMedia::k_xmpUUID, 16 );
+		memcpy ( &uuidBox[24], this->xmpPacket.c_str(), this->xmpPacket.size() );
+	}
 
-	if ( this->moovMgr.IsChanged() ) {
-		this->moovMgr.UpdateMemoryTree();
+	bool moovChanged = this->moovMgr.IsChanged();
+	if ( moovChanged ) {
+		this->moovMgr.UpdateMemoryTree ( fileRef );
 		if ( progressTracker != 0 ) {
 			progressTracker->AddTotalWork ( (float)this->moovMgr.fullSubtree.size() );
 		}
+	}
+
+	// When optimizing, first try to keep the 'moov' and XMP 'uuid' boxes where they are, this avoids
+	// a rewrite of the whole file by OptimizeFileLayout.
+
+	bool leadingUpdated = false;
+	if ( optimizeFileLayout && (moovChanged || (! uuidBox.empty())) ) {
+		leadingUpdated = this->UpdateLeadingBoxes (
+			( moovChanged ? &this->moovMgr.fullSubtree[0] : 0 ), ( moovChanged ? (XMP_Uns32)this->moovMgr.fullSubtree.size() : 0 ),
+			( uuidBox.empty() ? 0 : &uuidBox[0] ), (XMP_Uns32)uuidBox.size() );
+	}
+
+	// Update the 'moov' subtree if necessary, and finally update the timecode sample.
+
+	if ( moovChanged && (! leadingUpdated) ) {
 		this->UpdateTopLevelBox ( moovBoxPos, moovBoxSize, &this->moovMgr.fullSubtree[0],
 								  (XMP_Uns32)this->moovMgr.fullSubtree.size() );
 	}
@@ -2971,19 +3188,8 @@ void MPEG4_MetaHandler::UpdateFile ( bool doSafeUpdate )
 
 	// Update the 'uuid' XMP box if necessary.
 
-	if ( useUuidXMP & (! inPlaceXMP) ) {
-
-		// The uuid form of XMP has the 16-byte UUID in front of the XMP packet. Form the complete
-		// box (including size/type header) for UpdateTopLevelBox.
-		RawDataBlock uuidBox;
-		XMP_Uns32 uuidSize = 4 + 4 + 16 + (XMP_Uns32)this->xmpPacket.size();
-		uuidBox.assign ( uuidSize, 0 );
-		PutUns32BE ( uuidSize, &uuidBox[0] );
-		PutUns32BE ( ISOMedia::k_uuid, &uuidBox[4] );
-		memcpy ( &uuidBox[8], ISOMedia::k_xmpUUID, 16 );
-		memcpy ( &uuidBox[24], this->xmpPacket.c_str(), this->xmpPacket.size() );
-		this->UpdateTopLevelBox ( this->xmpBoxPos, this->xmpBoxSize, &uuidBox[0], uuidSize );
-
+	if ( (! uuidBox.empty()) && (! leadingUpdated) ) {
+		this->UpdateTopLevelBox ( this->xmpBoxPos, this->xmpBoxSize, &uuidBox[0], (XMP_Uns32)uuidBox.size() );
 	}
 
 	// Finally, optimize the file layout if asked.
@@ -81,6 +81,8 @@ private:
 	void UpdateTopLevelBox ( XMP_Uns64 oldOffset, XMP_Uns32 oldSize, const XMP_Uns8 * newBox, XMP_Uns32 newSize );
 
 	void OptimizeFileLayout();
+	bool UpdateLeadingBoxes ( const XMP_Uns8 * newMoov, XMP_Uns32 newMoovSize,
+							  const XMP_Uns8 * newUuid, XMP_Uns32 newUuidSize );
 
 	XMP_Uns8 fileMode;
 	bool havePreferredXMP;
@@ -98,8 +98,12 @@ void PNG_MetaHandler::CacheFileData()
 	 encounters but if it opened with kXMPFiles_OpenForUpdate, then it will throw exception if
 	 garbage data present after IEND chunk.
 	 see bug [CTAIDS-4119487]
+
+	 A fast read does not look for the XMP after the image data.
     */
-    if(PNG_Support::FindAndReadXMPChunk ( fileRef, this->xmpPacket, this->packetInfo.offset, XMP_OptionIsSet(this->parent->openFlags, kXMPFiles_OpenForRead)))
+    const bool readOnly = ! XMP_OptionIsSet ( this->parent->openFlags, kXMPFiles_OpenForUpdate );
+    const bool fastRead = readOnly && XMP_OptionIsSet ( this->parent->openFlags, kXMPFiles_OpenFastRead );
+    if(PNG_Support::FindAndReadXMPChunk ( fileRef, this->xmpPacket, this->packetInfo.offset, XMP_OptionIsSet(this->parent->openFlags, kXMPFiles_OpenForRead), fastRead))
     {
         this->packetInfo.length = static_cast<XMP_Int32>(this->xmpPacket.size());
         this->containsXMP = true;
@@ -12,6 +12,7 @@
 #include "public/include/XMP_IO.hpp"
 
 #include "XMPFiles/source/XMPFiles_Impl.hpp"
+#include "XMPFiles/source/XMPFiles_Metrics.hpp"
 #include "source/XIO.hpp"
 
 #include "XMPFiles/source/FileHandlers/PSD_Handler.hpp"
@@ -196,6 +197,7 @@ void PSD_MetaHandler::ProcessXMP()
 	bool readOnly = false;
 	if ( this->parent )
 		readOnly = ((this->parent->openFlags & kXMPFiles_OpenForUpdate) == 0);
+	bool fastRead = readOnly && XMP_OptionIsSet ( this->parent->openFlags, kXMPFiles_OpenFastRead );
 
 	if ( readOnly ) {
 		this->iptcMgr = new IPTC_Reader();
@@ -243,6 +245,7 @@ void PSD_MetaHandler::ProcessXMP()
 	// should they want to proceed with that.
 
 	bool haveXMP = false;
+	bool xmpParsed = false;
 
 	if ( ! this->xmpPacket.empty() ) {
 		XMP_Assert ( this->containsXMP );
@@ -251,11 +254,19 @@ void PSD_MetaHandler::ProcessXMP()
 		XMP_StringLen packetLen = (XMP_StringLen)this->xmpPacket.size();
 		try {
 			this->xmpObj.ParseFromBuffer ( packetStr, packetLen );
+			xmpParsed = true;
 		} catch ( ... ) { /* Ignore parsing failures, someday we hope to get partial XMP back. */ }
 		haveXMP = true;
 	}
 
-	// Process the legacy metadata.
+	// Process the legacy metadata. A fast read does not parse the IPTC if the XMP is known to be
+	// current, the import would keep the XMP's values anyway.
+
+	if ( fastRead && xmpParsed && XMPIsAuthoritative ( exif, iptcDigestState, this->xmpObj, options ) ) {
+		haveIPTC = false;
+		iptcInfo.dataLen = 0;
+		options &= ~k2XMP_FileHadIPTC;
+	}
 
 	if ( haveIPTC && (! haveXMP) && (iptcDigestState == kDigestMatches) ) iptcDigestState = kDigestMissing;
 	if (iptcInfo.dataLen) iptc.ParseMemoryDataSets ( iptcInfo.dataPtr, iptcInfo.dataLen );
@@ -283,7 +294,9 @@ void PSD_MetaHandler::UpdateFile ( bool doSafeUpdate )
 	// Update the IPTC-IIM and native TIFF/Exif metadata. ExportPhotoData also trips the tiff: and
 	// exif: copies from the XMP, so reserialize the now final XMP packet.
 
+	XMPFiles_Metrics::PhaseTimer exportTimer ( this->parent->format, kXMPFiles_Phase_ExportXMPtoJTP );
 	ExportPhotoData ( kXMP_PhotoshopFile, &this->xmpObj, this->exifMgr, this->iptcMgr, &this->psirMgr );
+	exportTimer.Stop();
 
 	try {
 		XMP_OptionBits options = kXMP_UseCompactFormat;
@@ -297,16 +310,17 @@ void PSD_MetaHandler::UpdateFile ( bool doSafeUpdate )
 	//	- There is an XMP packet in the file.
 	//	- The are no changes to the legacy image resources. (The IPTC and EXIF are in the PSIR.)
 	//	- The new XMP can fit in the old space.
+	// Otherwise try to rewrite just the image resource section, see FitResourcesInPlace. Only if
+	// that fails is the layer and image data copied to a temp file.
 
 	bool doInPlace = (fileHadXMP && (this->xmpPacket.size() <= (size_t)oldPacketLength));
 	if ( this->psirMgr.IsLegacyChanged() ) doInPlace = false;
+	bool rewriteResources = (! doInPlace) && this->FitResourcesInPlace();
 	XMP_ProgressTracker* progressTracker = this->parent->progressTracker;
 
 	if ( doInPlace ) {
 
-		#if GatherPerformanceData
-			sAPIPerf->back().extraInfo += ", PSD in-place update";
-		#endif
+		XMPFiles_Metrics::NoteUpdate ( this->parent->format, true );
 
 		if ( this->xmpPacket.size() < (size_t)this->packetInfo.length ) {
 			// They ought to match, cheap to be sure.
@@ -323,11 +337,17 @@ void PSD_MetaHandler::UpdateFile ( bool doSafeUpdate )
 		liveFile->Write ( this->xmpPacket.c_str(), (XMP_StringLen)this->xmpPacket.size() );
 		if ( progressTracker != 0 ) progressTracker->WorkComplete();
 
+	} else if ( rewriteResources ) {
+
+		XMPFiles_Metrics::NoteUpdate ( this->parent->format, true );
+
+		if ( progressTracker != 0 ) progressTracker->BeginWork ( (float)this->psirMgr.GetParsedFileLength() );
+		this->psirMgr.UpdateFileResourcesInPlace ( this->parent->ioRef );
+		if ( progressTracker != 0 ) progressTracker->WorkComplete();
+
 	} else {
 
-		#if GatherPerformanceData
-			sAPIPerf->back().extraInfo += ", PSD copy update";
-		#endif
+		XMPFiles_Metrics::NoteUpdate ( this->parent->format, false );
 
 		XMP_IO* origRef = this->parent->ioRef;
 		XMP_IO* tempRef = origRef->DeriveTemp();
@@ -351,6 +371,50 @@ void PSD_MetaHandler::UpdateFile ( bool doSafeUpdate )
 
 }	// PSD_MetaHandler::UpdateFile
 
+// =================================================================================================
+// PSD_MetaHandler::FitResourcesInPlace
+// ====================================
+//
+// See if the updated image resources can be written over the old section, leaving the layer and
+// image data alone. The XMP packet's padding absorbs the difference, it may shrink down to the
+// minimal serialization or grow by up to kMaxResourceSlack beyond the standard padding. More slack
+// than that is reclaimed by a rewrite. On success the XMP image resource and packet are set.
+
+bool PSD_MetaHandler::FitResourcesInPlace()
+{
+	static const XMP_Int64 kMaxResourceSlack = 64*1024;
+
+	std::string newPacket;
+	this->xmpObj.SerializeToBuffer ( &newPacket, kXMP_UseCompactFormat );
+	this->psirMgr.SetImgRsrc ( kPSIR_XMP, newPacket.c_str(), (XMP_StringLen)newPacket.size() );
+
+	XMP_Int64 slack = (XMP_Int64)this->psirMgr.GetParsedFileLength() - (XMP_Int64)this->psirMgr.GetUpdatedLength();
+	XMP_Int64 packetLen = (XMP_Int64)newPacket.size() + slack;
+
+	if ( (slack & 1) != 0 ) return false;	// ! The resources are even length, keep the XMP's parity.
+	if ( (packetLen <= 0) || (slack > kMaxResourceSlack) ) return false;
+
+	if ( slack != 0 ) {
+		try {
+			this->xmpObj.SerializeToBuffer ( &newPacket, (kXMP_UseCompactFormat | kXMP_ExactPacketLength),
+											 (XMP_StringLen)packetLen );
+		} catch ( ... ) {
+			return false;	// Too small for the XMP.
+		}
+		this->psirMgr.SetImgRsrc ( kPSIR_XMP, newPacket.c_str(), (XMP_StringLen)newPacket.size() );
+	}
+
+	XMP_Assert ( this->psirMgr.GetUpdatedLength() == this->psirMgr.GetParsedFileLength() );
+
+	this->xmpPacket.swap ( newPacket );
+	this->packetInfo.offset = kXMPFiles_UnknownOffset;
+	this->packetInfo.length = (XMP_StringLen)this->xmpPacket.size();
+	FillPacketInfo ( this->xmpPacket, &this->packetInfo );
+
+	return true;
+
+}	// PSD_MetaHandler::FitResourcesInPlace
+
 // =================================================================================================
 // PSD_MetaHandler::WriteTempFile
 // ==============================
@@ -376,7 +440,9 @@ void PSD_MetaHandler::WriteTempFile ( XMP_IO* tempRef )
 
 	if ( ! skipReconcile ) {
 		// Update the IPTC-IIM and native TIFF/Exif metadata, and reserialize the now final XMP packet.
+		XMPFiles_Metrics::PhaseTimer exportTimer ( this->parent->format, kXMPFiles_Phase_ExportXMPtoJTP );
 		ExportPhotoData ( kXMP_JPEGFile, &this->xmpObj, this->exifMgr, this->iptcMgr, &this->psirMgr );
+		exportTimer.Stop();
 		this->xmpObj.SerializeToBuffer ( &this->xmpPacket, kXMP_UseCompactFormat );
 	}
 
@@ -66,6 +66,8 @@ private:
 
 	XMP_Uns32 imageWidth, imageHeight;	// Pixel dimensions, used with thumbnail info.
 
+	bool FitResourcesInPlace();
+
 };	// PSD_MetaHandler
 
 // =================================================================================================
@@ -69,7 +69,7 @@ bool SWF_CheckFormat ( XMP_FileFormat format,
 // ================================
 
 SWF_MetaHandler::SWF_MetaHandler ( XMPFiles * _parent )
-	: isCompressed(false), hasFileAttributes(false), hasMetadata(false), brokenSWF(false), expandedSize(0), firstTagOffset(0)
+	: isCompressed(false), hasFileAttributes(false), hasMetadata(false), brokenSWF(false), firstTagOffset(0)
 {
 	this->parent = _parent;
 	this->handlerFlags = kSWF_HandlerFlags;
@@ -86,14 +86,38 @@ SWF_MetaHandler::~SWF_MetaHandler()
 	// Nothing to do at this time.
 }
 
+// =================================================================================================
+// ReadTagContent
+// ==============
+//
+// Read the content of a tag into memory, in pieces so that a bad length can't force a huge
+// allocation. Returns false if the stream ends first.
+
+static bool ReadTagContent ( SWF_IO::StreamReader & swfStream, XMP_Uns32 length, RawDataBlock * content )
+{
+	XMP_Uns8 buffer [4*1024];
+	
+	while ( length > 0 ) {
+		XMP_Uns32 ioCount = length;
+		if ( ioCount > sizeof(buffer) ) ioCount = sizeof(buffer);
+		XMP_Uns32 readCount = swfStream.Read ( buffer, ioCount );
+		content->insert ( content->end(), &buffer[0], &buffer[readCount] );
+		if ( readCount < ioCount ) return false;
+		length -= ioCount;
+	}
+	
+	return true;
+
+}	// ReadTagContent
+
 // =================================================================================================
 // SWF_MetaHandler::CacheFileData
 // ==============================
 //
-// SWF files are pretty small, have simple metadata, and often have ZIP compression. Because they
-// are small and often compressed, we always cache the fully expanded SWF in memory. That is used
-// for both reading and updating. Note that SWF_CheckFormat has already done basic checks on the
-// size and signature, they don't need to be repeated here.
+// SWF files often have ZIP compression. The expanded SWF stream is read sequentially, inflating as
+// needed, and only until the FileAttributes and Metadata tags have been seen. Nothing but those two
+// tags is kept in memory. Note that SWF_CheckFormat has already done basic checks on the size and
+// signature, they don't need to be repeated here.
 //
 // Try to find the FileAttributes and Metadata tags, saving their offsets for later use if updating
 // the file. We need to be tolerant when reading, allowing the FileAttributes tag to be anywhere and
@@ -104,50 +128,59 @@ SWF_MetaHandler::~SWF_MetaHandler()
 void SWF_MetaHandler::CacheFileData() {
 
 	XMP_Assert ( (! this->processedXMP) && (! this->containsXMP) );
-	XMP_Assert ( this->expandedSWF.empty() );
 
 	XMP_IO * fileRef = this->parent->ioRef;
 	XMP_Int64 fileLength = fileRef->Length();
 	XMP_Enforce ( fileLength <= SWF_IO::MaxExpandedSize );
 
-	// Get the uncompressed SWF stream into memory.
-	
-	fileRef->Rewind();
-	XMP_Uns8 buffer [SWF_IO::HeaderPrefixSize];	// Read the uncompressed file header prefix.
-	fileRef->ReadAll ( buffer, SWF_IO::HeaderPrefixSize );
-
-	XMP_Uns32 signature = GetUns32LE ( &buffer[0] ) & 0xFFFFFF;	// Discard the version byte.
-	this->expandedSize = GetUns32LE ( &buffer[4] );
-	if ( signature == SWF_IO::CompressedSignature ) this->isCompressed = true;
+	SWF_IO::StreamReader swfStream ( fileRef );
+	this->isCompressed = swfStream.IsCompressed();
 	
-	if ( this->isCompressed ) {
+	// Get past the file header, its size depends on the RECT that follows the header prefix.
 	
-		// Expand the SWF file into memory.
-		this->expandedSWF.reserve ( this->expandedSize );	// Try to avoid reallocations.
-		SWF_IO::DecompressFileToMemory ( fileRef, &this->expandedSWF );
-		this->expandedSize = (XMP_Uns32)this->expandedSWF.size();	// Use the true length.
+	XMP_Uns8 rectBits;
+	if ( swfStream.Skip ( SWF_IO::HeaderPrefixSize ) < SWF_IO::HeaderPrefixSize ) return;
+	if ( swfStream.Read ( &rectBits, 1 ) < 1 ) return;	// Throw?
+	this->firstTagOffset = SWF_IO::FileHeaderSize ( rectBits );
 	
-	} else {
-	
-		// Read the entire uncompressed file into memory.
-		this->expandedSize = (XMP_Uns32)fileLength;	// Use the true length.
-		this->expandedSWF.insert ( this->expandedSWF.end(), (size_t)fileLength, 0 );
-		fileRef->Rewind();
-		fileRef->ReadAll ( &this->expandedSWF[0], (XMP_Uns32)fileLength );
-	
-	}
+	XMP_Uns32 headerLeft = this->firstTagOffset - swfStream.Offset();
+	if ( swfStream.Skip ( headerLeft ) < headerLeft ) return;
 	
 	// Look for the FileAttributes and Metadata tags.
 	
-	if(this->expandedSize <= SWF_IO::HeaderPrefixSize ) return; // Throw?
-	this->firstTagOffset = SWF_IO::FileHeaderSize ( this->expandedSWF[SWF_IO::HeaderPrefixSize] );
-	
-	XMP_Uns32 currOffset = this->firstTagOffset;
 	SWF_IO::TagInfo currTag;
+	RawDataBlock metadata;
 	
-	for ( ; currOffset < this->expandedSize; currOffset = SWF_IO::NextTagOffset(currTag) ) {
+	while ( true ) {
 	
-		bool ok = SWF_IO::GetTagInfo ( this->expandedSWF, currOffset, &currTag );
+		bool ok = SWF_IO::ReadTagInfo ( swfStream, &currTag );
+		if ( ! ok ) {
+			if ( swfStream.Offset() != currTag.tagOffset ) this->brokenSWF = true;	// An incomplete tag header.
+			break;	// Otherwise this is the normal end of the tags.
+		}
+		
+		if ( currTag.tagID == SWF_IO::FileAttributesTagID ) {
+
+			this->fileAttributes.assign ( (SWF_IO::ContentOffset ( currTag ) - currTag.tagOffset), 0 );
+			if ( ! currTag.hasLongHeader ) {
+				PutUns16LE ( ((currTag.tagID << 6) | currTag.contentLength), &this->fileAttributes[0] );
+			} else {
+				PutUns16LE ( ((currTag.tagID << 6) | SWF_IO::TagLengthMask), &this->fileAttributes[0] );
+				PutUns32LE ( currTag.contentLength, &this->fileAttributes[2] );
+			}
+			ok = ReadTagContent ( swfStream, currTag.contentLength, &this->fileAttributes );
+
+		} else if ( currTag.tagID == SWF_IO::MetadataTagID ) {
+
+			metadata.clear();
+			ok = ReadTagContent ( swfStream, currTag.contentLength, &metadata );
+
+		} else {
+
+			ok = ( swfStream.Skip ( currTag.contentLength ) == currTag.contentLength );
+
+		}
+
 		if ( ! ok ) {
 			this->brokenSWF = true;	// Let the read finish, but refuse to update.
 			break;
@@ -170,7 +203,7 @@ void SWF_MetaHandler::CacheFileData() {
 	if ( this->hasMetadata ) {
 		this->packetInfo.offset = SWF_IO::ContentOffset ( this->metadataTag );
 		this->packetInfo.length = this->metadataTag.contentLength;
-		this->xmpPacket.assign ( (char*)&this->expandedSWF[(size_t)this->packetInfo.offset], (size_t)this->packetInfo.length );
+		this->xmpPacket.assign ( (char*)metadata.data(), metadata.size() );
 		FillPacketInfo ( this->xmpPacket, &this->packetInfo );
 		this->containsXMP = true;
 	}
@@ -208,17 +241,72 @@ XMP_OptionBits SWF_MetaHandler::GetSerializeOptions()
 
 } // XMPFileHandler::GetSerializeOptions
 
+// =================================================================================================
+// CopyStream
+// ==========
+//
+// Copy part of the expanded SWF stream. Returns the number of bytes copied, which is less than
+// count at the end of the input.
+
+static XMP_Uns32 CopyStream ( SWF_IO::StreamReader & swfIn, SWF_IO::StreamWriter & swfOut, XMP_Uns32 count )
+{
+	static const size_t bufferSize = 64*1024;
+	RawDataBlock buffer ( bufferSize );
+	XMP_Uns32 done = 0;
+	
+	while ( done < count ) {
+		XMP_Uns32 ioCount = count - done;
+		if ( ioCount > bufferSize ) ioCount = bufferSize;
+		XMP_Uns32 readCount = swfIn.Read ( &buffer[0], ioCount );
+		if ( readCount > 0 ) swfOut.Write ( &buffer[0], readCount );
+		done += readCount;
+		if ( readCount < ioCount ) break;
+	}
+	
+	return done;
+
+}	// CopyStream
+
 // =================================================================================================
 // SWF_MetaHandler::UpdateFile
 // ===========================
 //
-// Update the expanded SWF in memory, then write it to the file.
+// Stream the updated SWF to a temp file, then replace the original with it.
 
 void SWF_MetaHandler::UpdateFile ( bool doSafeUpdate )
 {
 
 	if ( doSafeUpdate ) XMP_Throw ( "SWF_MetaHandler::UpdateFile: Safe update not supported", kXMPErr_Unavailable );
 
+	if ( ! this->needsUpdate ) return;
+	
+	XMP_IO * fileRef = this->parent->ioRef;
+	XMP_IO * tempRef = fileRef->DeriveTemp();
+	if ( tempRef == 0 ) XMP_Throw ( "Failure creating SWF temp file", kXMPErr_InternalFailure );
+
+	try {
+		this->WriteTempFile ( tempRef );
+	} catch ( ... ) {
+		fileRef->DeleteTemp();
+		throw;
+	}
+
+	fileRef->AbsorbTemp();
+
+}	// SWF_MetaHandler::UpdateFile
+
+// =================================================================================================
+// SWF_MetaHandler::WriteTempFile
+// ==============================
+//
+// Copy the expanded SWF stream from the original file to the temp file, inflating and deflating a
+// compressed file on the fly. The FileAttributes tag, with the HasMetadata flag set, becomes the
+// first tag and the new XMP the second. The old FileAttributes and Metadata tags are dropped from
+// the rest of the copy.
+
+void SWF_MetaHandler::WriteTempFile ( XMP_IO* tempRef )
+{
+
 	if ( ! this->needsUpdate ) return;
 	this->needsUpdate = false; // Don't come through here twice, even if there are errors.
 	
@@ -226,122 +314,75 @@ void SWF_MetaHandler::UpdateFile ( bool doSafeUpdate )
 		XMP_Throw ( "SWF is broken, can't update.", kXMPErr_BadFileFormat );
 	}
 	
-	// Make sure there is a FileAttributes tag at the front, with the HasMetadata flag set.
+	// Make sure there is a FileAttributes tag with the HasMetadata flag set.
 	
-	if ( ! this->hasFileAttributes ) {
+	bool hadFileAttributes = this->hasFileAttributes;
 	
-		// Insert a new FileAttributes tag as the first tag.
-		
-		XMP_Uns8 buffer [6];	// Two byte header plus four byte content.
-		PutUns16LE ( ((SWF_IO::FileAttributesTagID << 6) | 4), &buffer[0] );
-		PutUns32LE ( SWF_IO::HasMetadataMask, &buffer[2] );
-		
-		if(this->expandedSWF.size() < this->firstTagOffset ){
-                     XMP_Throw ( "Index not valid.Invalid SWF, can't update.", kXMPErr_BadIndex );
-                 }
-		this->expandedSWF.insert ( (this->expandedSWF.begin() + this->firstTagOffset), 6, 0 );
-		memcpy ( &this->expandedSWF[this->firstTagOffset], &buffer[0], 6 );
-
+	if ( ! this->hasFileAttributes ) {
+		this->fileAttributes.assign ( 6, 0 );	// Two byte header plus four byte content.
+		PutUns16LE ( ((SWF_IO::FileAttributesTagID << 6) | 4), &this->fileAttributes[0] );
+		PutUns32LE ( SWF_IO::HasMetadataMask, &this->fileAttributes[2] );
 		this->hasFileAttributes = true;
-		bool ok = SWF_IO::GetTagInfo ( this->expandedSWF, this->firstTagOffset, &this->fileAttributesTag );
-		XMP_Assert ( ok );
-		
-		if ( this->hasMetadata ) this->metadataTag.tagOffset += 6;	// The Metadata tag is now further back.
-
-	} else {
-		
-		// Make sure the HasMetadata flag is set.
-		if ( this->fileAttributesTag.contentLength > 0 ) {
-			XMP_Uns32 flagsOffset = SWF_IO::ContentOffset ( this->fileAttributesTag );
-			this->expandedSWF[flagsOffset] |= SWF_IO::HasMetadataMask;
-		}
-
-		// Make sure the FileAttributes tag is the first tag.
-		if ( this->fileAttributesTag.tagOffset != this->firstTagOffset ) {
-
-			RawDataBlock attrTag;
-			XMP_Uns32 attrTagLength = SWF_IO::FullTagLength ( this->fileAttributesTag );
-			attrTag.assign ( attrTagLength, 0 );
-			memcpy ( &attrTag[0], &this->expandedSWF[this->fileAttributesTag.tagOffset], attrTagLength );
-			
-			RawDataBlock::iterator attrTagPos = this->expandedSWF.begin() + this->fileAttributesTag.tagOffset;
-			RawDataBlock::iterator attrTagEnd = attrTagPos + attrTagLength;
-			this->expandedSWF.erase ( attrTagPos, attrTagEnd );	// Remove the old FileAttributes tag;
-			
-			if ( this->hasMetadata && (this->metadataTag.tagOffset < this->fileAttributesTag.tagOffset) ) {
-				this->metadataTag.tagOffset += attrTagLength;	// The FileAttributes tag will become in front.
-			}
-			
-			if(this->expandedSWF.size() < this->firstTagOffset ){
-                             XMP_Throw ( "Index not valid.Invalid SWF, can't update.", kXMPErr_BadIndex );
-                        }
-			this->expandedSWF.insert ( (this->expandedSWF.begin() + this->firstTagOffset), attrTagLength, 0 );
-			memcpy ( &this->expandedSWF[this->firstTagOffset], &attrTag[0], attrTagLength );
-			
-			this->fileAttributesTag.tagOffset = this->firstTagOffset;
-
-		}
-
+	} else if ( this->fileAttributesTag.contentLength > 0 ) {
+		XMP_Uns32 flagsOffset = SWF_IO::ContentOffset ( this->fileAttributesTag ) - this->fileAttributesTag.tagOffset;
+		this->fileAttributes[flagsOffset] |= SWF_IO::HasMetadataMask;
 	}
 	
-	// Make sure the XMP is as small as possible. Write the XMP as the second tag.
-	
-	XMP_Assert ( this->hasFileAttributes );
+	// Make sure the XMP is as small as possible.
 	
 	XMP_OptionBits smallOptions = kXMP_OmitPacketWrapper | kXMP_UseCompactFormat | kXMP_OmitAllFormatting | kXMP_OmitXMPMetaElement;
 	this->xmpObj.SerializeToBuffer ( &this->xmpPacket, smallOptions );
+	XMP_Uns32 packetLength = (XMP_Uns32)this->xmpPacket.size();
 	
-	if ( this->hasMetadata ) {
-		// Remove the old XMP, the size and location have probably changed.
-		XMP_Uns32 oldMetaLength = SWF_IO::FullTagLength ( this->metadataTag );
-		RawDataBlock::iterator oldMetaPos = this->expandedSWF.begin() + this->metadataTag.tagOffset;
-		RawDataBlock::iterator oldMetaEnd = oldMetaPos + oldMetaLength;
-		this->expandedSWF.erase ( oldMetaPos, oldMetaEnd );
-	}
+	// Write the file header, FileAttributes, and the XMP as the first two tags. The expanded length
+	// in the header is fixed after the rest of the tags are copied.
 	
-	this->metadataTag.hasLongHeader = true;
-	this->metadataTag.tagID = SWF_IO::MetadataTagID;
-	this->metadataTag.tagOffset = SWF_IO::NextTagOffset ( this->fileAttributesTag );
-	this->metadataTag.contentLength = (XMP_Uns32)this->xmpPacket.size();
-
-	XMP_Uns32 newMetaLength = 6 + this->metadataTag.contentLength;	// Always use a long tag header.
-	if(this->expandedSWF.size() < this->metadataTag.tagOffset ){
-             XMP_Throw ( "Index not valid.Invalid SWF, can't update.", kXMPErr_BadIndex );
-	}
-	this->expandedSWF.insert ( (this->expandedSWF.begin() + this->metadataTag.tagOffset), newMetaLength, 0 );
-
-	PutUns16LE ( ((SWF_IO::MetadataTagID << 6) | SWF_IO::TagLengthMask), &this->expandedSWF[this->metadataTag.tagOffset] );
-	PutUns32LE ( this->metadataTag.contentLength, &this->expandedSWF[this->metadataTag.tagOffset+2] );
-	memcpy ( &this->expandedSWF[this->metadataTag.tagOffset+6], this->xmpPacket.c_str(), this->metadataTag.contentLength );
-
-	this->hasMetadata = true;
-	
-	// Update the uncompressed file length and rewrite the file.
+	XMP_IO * originalRef = this->parent->ioRef;
+	SWF_IO::StreamReader swfIn ( originalRef );
 	
-	PutUns32LE ( (XMP_Uns32)this->expandedSWF.size(), &this->expandedSWF[4] );
+	tempRef->Rewind();
+	tempRef->Truncate ( 0 );
+	SWF_IO::StreamWriter swfOut ( tempRef, this->isCompressed );
 
-	XMP_IO * fileRef = this->parent->ioRef;
-	fileRef->Rewind();
-	fileRef->Truncate ( 0 );
-	
-	if ( this->isCompressed ) {
-		SWF_IO::CompressMemoryToFile ( this->expandedSWF, fileRef );
-	} else {
-		fileRef->Write ( &this->expandedSWF[0], (XMP_Uns32)this->expandedSWF.size() );
+	if ( CopyStream ( swfIn, swfOut, this->firstTagOffset ) != this->firstTagOffset ) {
+		XMP_Throw ( "Invalid SWF, can't update.", kXMPErr_BadFileFormat );
 	}
 
-}	// SWF_MetaHandler::UpdateFile
-
-// =================================================================================================
-// SWF_MetaHandler::WriteTempFile
-// ==============================
-
-// ! See important notes in SWF_Handler.hpp about file handling.
+	swfOut.Write ( &this->fileAttributes[0], (XMP_Uns32)this->fileAttributes.size() );
 
-void SWF_MetaHandler::WriteTempFile ( XMP_IO* tempRef )
-{
+	XMP_Uns8 metaHeader [6];	// Always use a long tag header.
+	PutUns16LE ( ((SWF_IO::MetadataTagID << 6) | SWF_IO::TagLengthMask), &metaHeader[0] );
+	PutUns32LE ( packetLength, &metaHeader[2] );
+	swfOut.Write ( &metaHeader[0], 6 );
+	swfOut.Write ( this->xmpPacket.c_str(), packetLength );
 
-	// ! WriteTempFile is not supposed to be called for SWF.
-	XMP_Throw ( "SWF_MetaHandler::WriteTempFile should not be called", kXMPErr_InternalFailure );
+	// Copy the rest of the tags, skipping the old FileAttributes and Metadata tags.
+	
+	const SWF_IO::TagInfo * skipTags [2] = { 0, 0 };
+	if ( hadFileAttributes ) skipTags[0] = &this->fileAttributesTag;
+	if ( this->hasMetadata ) skipTags[1] = &this->metadataTag;
+	if ( (skipTags[0] != 0) && (skipTags[1] != 0) && (skipTags[1]->tagOffset < skipTags[0]->tagOffset) ) {
+		std::swap ( skipTags[0], skipTags[1] );
+	}
+	
+	for ( size_t i = 0; i < 2; ++i ) {
+		if ( skipTags[i] == 0 ) continue;
+		XMP_Uns32 copyLength = skipTags[i]->tagOffset - swfIn.Offset();
+		XMP_Uns32 skipLength = SWF_IO::FullTagLength ( *skipTags[i] );
+		if ( (CopyStream ( swfIn, swfOut, copyLength ) != copyLength) || (swfIn.Skip ( skipLength ) != skipLength) ) {
+			XMP_Throw ( "Invalid SWF, can't update.", kXMPErr_BadFileFormat );
+		}
+	}
+	
+	CopyStream ( swfIn, swfOut, 0xFFFFFFFFUL );	// Everything that is left.
+	
+	this->hasMetadata = true;
+	
+	// Update the uncompressed file length.
+	
+	XMP_Uns8 lengthField [4];
+	PutUns32LE ( swfOut.Finish(), &lengthField[0] );
+	tempRef->Seek ( 4, kXMP_SeekFromStart );
+	tempRef->Write ( &lengthField[0], 4 );
 
 }	// SWF_MetaHandler::WriteTempFile
@@ -57,13 +57,13 @@ public:
 private:
 
 	SWF_MetaHandler() : isCompressed(false), hasFileAttributes(false), hasMetadata(false), brokenSWF(false),
-						expandedSize(0), firstTagOffset(0) {};
+						firstTagOffset(0) {};
 
 	bool isCompressed, hasFileAttributes, hasMetadata, brokenSWF;
-	XMP_Uns32 expandedSize, firstTagOffset;
-	RawDataBlock expandedSWF;
+	XMP_Uns32 firstTagOffset;
 	
 	SWF_IO::TagInfo fileAttributesTag, metadataTag;
+	RawDataBlock fileAttributes;	// The full FileAttributes tag, it is moved to the front when updating.
 
 };	// SWF_MetaHandler
 
@@ -12,6 +12,7 @@
 #include "public/include/XMP_IO.hpp"
 
 #include "XMPFiles/source/XMPFiles_Impl.hpp"
+#include "XMPFiles/source/XMPFiles_Metrics.hpp"
 #include "source/XIO.hpp"
 
 #include "XMPFiles/source/FileHandlers/TIFF_Handler.hpp"
@@ -127,7 +128,10 @@ void TIFF_MetaHandler::CacheFileData()
 		XMP_Throw ( "TIFF_MetaHandler::CacheFileData - User abort", kXMPErr_UserAbort );
 	}
 
-	this->tiffMgr.ParseFileStream ( fileRef );
+	// An update keeps the file open until the handler is deleted, so the large tag values can be
+	// read when first used. For read-only access the file is closed after CacheFileData.
+	bool deferValues = XMP_OptionIsSet ( this->parent->openFlags, kXMPFiles_OpenForUpdate );
+	this->tiffMgr.ParseFileStream ( fileRef, deferValues );
 
 	TIFF_Manager::TagInfo dngInfo;
 	if ( this->tiffMgr.GetTag ( kTIFF_PrimaryIFD, kTIFF_DNGVersion, &dngInfo ) ) {
@@ -188,6 +192,7 @@ void TIFF_MetaHandler::ProcessXMP()
 
 	bool found;
 	bool readOnly = ((this->parent->openFlags & kXMPFiles_OpenForUpdate) == 0);
+	bool fastRead = readOnly && XMP_OptionIsSet ( this->parent->openFlags, kXMPFiles_OpenFastRead );
 
 	if ( readOnly ) {
 		this->psirMgr = new PSIR_MemoryReader();
@@ -257,6 +262,7 @@ void TIFF_MetaHandler::ProcessXMP()
 	// should they want to proceed with that.
 
 	bool haveXMP = false;
+	bool xmpParsed = false;
 
 	if ( ! this->xmpPacket.empty() ) {
 		XMP_Assert ( this->containsXMP );
@@ -265,11 +271,19 @@ void TIFF_MetaHandler::ProcessXMP()
 		XMP_StringLen packetLen = (XMP_StringLen)this->xmpPacket.size();
 		try {
 			this->xmpObj.ParseFromBuffer ( packetStr, packetLen );
+			xmpParsed = true;
 		} catch ( ... ) { /* Ignore parsing failures, someday we hope to get partial XMP back. */ }
 		haveXMP = true;
 	}
 
-	// Process the legacy metadata.
+	// Process the legacy metadata. A fast read does not parse the IPTC if the XMP is known to be
+	// current, the import would keep the XMP's values anyway.
+
+	if ( fastRead && xmpParsed && XMPIsAuthoritative ( tiff, iptcDigestState, this->xmpObj, options ) ) {
+		haveIPTC = false;
+		iptcInfo.dataLen = 0;
+		options &= ~k2XMP_FileHadIPTC;
+	}
 
 	if ( haveIPTC && (! haveXMP) && (iptcDigestState == kDigestMatches) ) iptcDigestState = kDigestMissing;
 	if (iptcInfo.dataLen) iptc.ParseMemoryDataSets ( iptcInfo.dataPtr, iptcInfo.dataLen );
@@ -308,7 +322,9 @@ void TIFF_MetaHandler::UpdateFile ( bool doSafeUpdate )
 	// Update the IPTC-IIM and native TIFF/Exif metadata. ExportPhotoData also trips the tiff: and
 	// exif: copies from the XMP, so reserialize the now final XMP packet.
 
+	XMPFiles_Metrics::PhaseTimer exportTimer ( this->parent->format, kXMPFiles_Phase_ExportXMPtoJTP );
 	ExportPhotoData ( kXMP_TIFFFile, &this->xmpObj, &this->tiffMgr, this->iptcMgr, this->psirMgr );
+	exportTimer.Stop();
 
 	try {
 		XMP_OptionBits options = kXMP_UseCompactFormat;
@@ -331,9 +347,7 @@ void TIFF_MetaHandler::UpdateFile ( bool doSafeUpdate )
 
 	if ( ! doInPlace ) {
 
-		#if GatherPerformanceData
-			sAPIPerf->back().extraInfo += ", TIFF append update";
-		#endif
+		XMPFiles_Metrics::NoteUpdate ( this->parent->format, true );
 
 		if ( (progressTracker != 0) && (! progressTracker->WorkInProgress()) ) {
 			localProgressTracking = true;
@@ -345,9 +359,7 @@ void TIFF_MetaHandler::UpdateFile ( bool doSafeUpdate )
 
 	} else {
 
-		#if GatherPerformanceData
-			sAPIPerf->back().extraInfo += ", TIFF in-place update";
-		#endif
+		XMPFiles_Metrics::NoteUpdate ( this->parent->format, true );
 
 		if ( this->xmpPacket.size() < (size_t)this->packetInfo.length ) {
 			// They ought to match, cheap to be sure.
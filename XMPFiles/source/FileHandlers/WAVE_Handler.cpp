@@ -38,7 +38,7 @@ XMPFileHandler * WAVE_MetaHandlerCTor ( XMPFiles * parent )
 // ===============
 //
 // Checks if the given file is a valid WAVE file.
-// The first 12 bytes are checked. The first 4 must be "RIFF"
+// The first 12 bytes are checked. The first 4 must be "RIFF", "RF64" or "BW64"
 // Bytes 8 to 12 must be "WAVE"
 
 bool WAVE_CheckFormat ( XMP_FileFormat  format,
@@ -61,7 +61,7 @@ bool WAVE_CheckFormat ( XMP_FileFormat  format,
 	}
 
 	XMP_Uns32 type = WAVE_MetaHandler::whatRIFFFormat( buffer );
-	if ( type != kChunk_RIFF && type != kChunk_RF64 ) 
+	if ( type != kChunk_RIFF && type != kChunk_RF64 && type != kChunk_BW64 ) 
 	{
 		return false;
 	}
@@ -96,6 +96,10 @@ XMP_Uns32 WAVE_MetaHandler::whatRIFFFormat( XMP_Uns8* buffer )
 		{
 			type = kChunk_RF64;
 		}
+		else if( endian.getUns32( buffer ) == kChunk_BW64 )
+		{
+			type = kChunk_BW64;
+		}
 	}
 
 	return type;
@@ -134,6 +138,18 @@ const ChunkIdentifier WAVE_MetaHandler::kRF64Cart[2] = { { static_cast<XMP_Uns32
 // RF64:WAVE/Cr8r
 // const ChunkIdentifier WAVE_MetaHandler::kRF64Cr8r[2] = { { kChunk_RF64, kType_WAVE }, { kChunk_Cr8r, kType_NONE } };
 const ChunkIdentifier WAVE_MetaHandler::kRF64iXML[2] = { { static_cast<XMP_Uns32>(kChunk_RF64), static_cast<XMP_Uns32>(kType_WAVE) }, { static_cast<XMP_Uns32>(kChunk_iXML), static_cast<XMP_Uns32>(kType_NONE) } };
+// BW64:WAVE/PMX_
+const ChunkIdentifier WAVE_MetaHandler::kBW64XMP[2] = { { static_cast<XMP_Uns32>(kChunk_BW64), static_cast<XMP_Uns32>(kType_WAVE) }, { static_cast<XMP_Uns32>(kChunk_XMP), (static_cast<XMP_Uns32>(kType_NONE)) } };
+// BW64:WAVE/LIST:INFO
+const ChunkIdentifier WAVE_MetaHandler::kBW64Info[2] = { { static_cast<XMP_Uns32>(kChunk_BW64), static_cast<XMP_Uns32>(kType_WAVE) }, { static_cast<XMP_Uns32>(kChunk_LIST), static_cast<XMP_Uns32>(kType_INFO) } };
+// BW64:WAVE/DISP
+const ChunkIdentifier WAVE_MetaHandler::kBW64Disp[2] = { { static_cast<XMP_Uns32>(kChunk_BW64), static_cast<XMP_Uns32>(kType_WAVE) }, { static_cast<XMP_Uns32>(kChunk_DISP), (static_cast<XMP_Uns32>(kType_NONE)) } };
+// BW64:WAVE/BEXT
+const ChunkIdentifier WAVE_MetaHandler::kBW64Bext[2] = { { static_cast<XMP_Uns32>(kChunk_BW64), static_cast<XMP_Uns32>(kType_WAVE) }, { static_cast<XMP_Uns32>(kChunk_bext), (static_cast<XMP_Uns32>(kType_NONE)) } };
+// BW64:WAVE/cart
+const ChunkIdentifier WAVE_MetaHandler::kBW64Cart[2] = { { static_cast<XMP_Uns32>(kChunk_BW64), static_cast<XMP_Uns32>(kType_WAVE) }, { static_cast<XMP_Uns32>(kChunk_cart), (static_cast<XMP_Uns32>(kType_NONE)) } };
+// BW64:WAVE/iXML
+const ChunkIdentifier WAVE_MetaHandler::kBW64iXML[2] = { { static_cast<XMP_Uns32>(kChunk_BW64), static_cast<XMP_Uns32>(kType_WAVE) }, { static_cast<XMP_Uns32>(kChunk_iXML), static_cast<XMP_Uns32>(kType_NONE) } };
 
 // =================================================================================================
 // WAVE_MetaHandler::WAVE_MetaHandler
@@ -190,7 +206,7 @@ void WAVE_MetaHandler::CacheFileData()
 	XMP_Assert( got == 4 );
 	
 	XMP_Uns32 type = WAVE_MetaHandler::whatRIFFFormat( buffer );
-	XMP_Assert( type == kChunk_RIFF || type == kChunk_RF64 );
+	XMP_Assert( type == kChunk_RIFF || type == kChunk_RF64 || type == kChunk_BW64 );
 
 	// Reset file pointer position
 	this->parent->ioRef->Rewind();
@@ -207,6 +223,15 @@ void WAVE_MetaHandler::CacheFileData()
 		// cr8r is not yet required for WAVE
 		//mWAVECr8rChunkPath.append( kWAVECr8r, SizeOfCIArray(kWAVECr8r) );
 	}
+	else if( type == kChunk_BW64 )
+	{
+		mWAVEXMPChunkPath.append( kBW64XMP, SizeOfCIArray(kBW64XMP) );
+		mWAVEInfoChunkPath.append( kBW64Info, SizeOfCIArray(kBW64Info) );
+		mWAVEDispChunkPath.append( kBW64Disp, SizeOfCIArray(kBW64Disp) );
+		mWAVEiXMLChunkPath.append( kBW64iXML, SizeOfCIArray(kBW64iXML) );
+		mWAVEBextChunkPath.append( kBW64Bext, SizeOfCIArray(kBW64Bext) );
+		mWAVECartChunkPath.append( kBW64Cart, SizeOfCIArray(kBW64Cart) );
+	}
 	else // RF64
 	{
 		mWAVEXMPChunkPath.append( kRF64XMP, SizeOfCIArray(kRF64XMP) );
@@ -238,6 +263,22 @@ void WAVE_MetaHandler::CacheFileData()
 	// If file is neither WAVE, throw exception
 	XMP_Validate( typeList.at(0)  == kType_WAVE , "File is not of type WAVE", kXMPErr_BadFileFormat );
 
+	// Read the data of the chunks that are used, only the headers have been read so far.
+	// A read-only open that only wants the XMP leaves the legacy chunks on disk.
+	const bool readOnly = ! XMP_OptionIsSet ( this->parent->openFlags, kXMPFiles_OpenForUpdate );
+	const bool xmpOnly = readOnly && XMP_OptionIsSet ( this->parent->openFlags, kXMPFiles_OpenOnlyXMP );
+
+	mChunkController->cacheChunks( this->parent->ioRef, mWAVEXMPChunkPath, true );
+
+	if( ! xmpOnly )
+	{
+		mChunkController->cacheChunks( this->parent->ioRef, mWAVEInfoChunkPath, true );
+		mChunkController->cacheChunks( this->parent->ioRef, mWAVEBextChunkPath, true );
+		mChunkController->cacheChunks( this->parent->ioRef, mWAVECartChunkPath, true );
+		mChunkController->cacheChunks( this->parent->ioRef, mWAVEDispChunkPath );
+		mChunkController->cacheChunks( this->parent->ioRef, mWAVEiXMLChunkPath, true );
+	}
+
 	// Check if the file contains XMP (last if there are duplicates)
 	mXMPChunk = mChunkController->getChunk( mWAVEXMPChunkPath, true );
 	
@@ -284,6 +325,14 @@ void WAVE_MetaHandler::ProcessXMP()
 		this->containsXMP = true;
 	}
 
+	// The legacy chunks have not been read for a read-only open that only wants the XMP
+	const bool readOnly = ! XMP_OptionIsSet ( this->parent->openFlags, kXMPFiles_OpenForUpdate );
+
+	if ( readOnly && XMP_OptionIsSet ( this->parent->openFlags, kXMPFiles_OpenOnlyXMP ) )
+	{
+		return;
+	}
+
 	// Then import native properties
 	MetadataSet metaSet;
 	WAVEReconcile recon;
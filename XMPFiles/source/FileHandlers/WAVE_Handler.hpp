@@ -73,9 +73,9 @@ public:
     void WriteTempFile ( XMP_IO* tempRef );
 
 	/**
-	* Checks if the first 4 bytes of the given buffer are either type RIFF or RF64
+	* Checks if the first 4 bytes of the given buffer are either type RIFF, RF64 or BW64
 	* @param buffer a byte buffer that must contain at least 4 bytes and point to the correct byte
-	* @return Either kChunk_RIFF, kChunk_RF64 0 if no type could be determined
+	* @return Either kChunk_RIFF, kChunk_RF64, kChunk_BW64 0 if no type could be determined
 	*/
 	static XMP_Uns32 whatRIFFFormat( XMP_Uns8* buffer );
 
@@ -149,6 +149,14 @@ private:
 	static const ChunkIdentifier kRF64iXML[2];
 	// cr8r is not yet required for WAVE
 	// static const ChunkIdentifier kRF64Cr8r[2];
+
+	/** Chunk path identifier of interest in BW64 */
+	static const ChunkIdentifier kBW64XMP[2];
+	static const ChunkIdentifier kBW64Info[2];
+	static const ChunkIdentifier kBW64Disp[2];
+	static const ChunkIdentifier kBW64Bext[2];
+	static const ChunkIdentifier kBW64Cart[2];
+	static const ChunkIdentifier kBW64iXML[2];
 	
 	/** Path to XMP chunk */
 	ChunkPath mWAVEXMPChunkPath;
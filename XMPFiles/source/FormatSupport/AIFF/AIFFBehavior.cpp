@@ -223,7 +223,8 @@ XMP_Bool AIFFBehavior::isFREEChunk( const Chunk& chunk ) const
 	{
 		ret = chunk.getSize() == 0;
 		
-		if( !ret )
+		// the data of a chunk that has not been cached is unknown
+		if( !ret && chunk.getChunkMode() == CHUNK_LEAF )
 		{
 			const XMP_Uns8* buffer;
 			chunk.getData( &buffer );
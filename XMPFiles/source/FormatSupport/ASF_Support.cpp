@@ -132,30 +132,32 @@ bool ASF_Support::ReadHeaderObject ( XMP_IO* fileRef, ObjectState& inOutObjectSt
 
 	try {
 
-		// read header-object structure
+		// read the entire header-object with one read, the contained objects are parsed from memory
 		XMP_Uns64 pos = newObject.pos;
 		XMP_Uns32 bufferSize = kASF_ObjectBaseLen + 6;
 
-		buffer.clear();
-		buffer.reserve ( bufferSize );
-		buffer.assign ( bufferSize, ' ' );
+		if ( (newObject.len < bufferSize) || (newObject.len > kASF_MaxHeaderObjectLen) ) {
+			XMP_Throw ( "Invalid ASF header object size", kXMPErr_BadFileFormat );
+		}
+
+		std::string header;
+		header.assign ( XMP_Uns32 ( newObject.len ), ' ' );
 		fileRef->Seek ( pos, kXMP_SeekFromStart );
-		fileRef->ReadAll ( const_cast<char*>(buffer.data()), bufferSize );
+		fileRef->ReadAll ( const_cast<char*>(header.data()), XMP_Uns32 ( newObject.len ) );
 
 		XMP_Uns64 read = bufferSize;
 		pos += bufferSize;
 
 		// read contained header objects
-		XMP_Uns32 numberOfHeaders = GetUns32LE ( &buffer[24] );
+		XMP_Uns32 numberOfHeaders = GetUns32LE ( &header[24] );
 		ASF_ObjectBase objectBase;
 
 		while (read < newObject.len && numberOfHeaders > 0)
 		{
 
-			fileRef->Seek ( pos, kXMP_SeekFromStart );
-			if ( kASF_ObjectBaseLen != fileRef->Read ( &objectBase, kASF_ObjectBaseLen, true ) ) break;
+			if ( (read + kASF_ObjectBaseLen) > newObject.len ) break;
+			memcpy ( &objectBase, &header[XMP_Uns32(read)], kASF_ObjectBaseLen );
 
-			fileRef->Seek ( pos, kXMP_SeekFromStart );
 			objectBase.size = GetUns64LE ( &objectBase.size );
 
 			if (XMP_Uns32(objectBase.size) <= 0) /* as ASF_ObjectBase has size in XMP_Uns64 , XMP_Uns32 would give 0 for very large files exceeding UINT32_MAX */
@@ -163,12 +165,11 @@ bool ASF_Support::ReadHeaderObject ( XMP_IO* fileRef, ObjectState& inOutObjectSt
 				XMP_Throw("Failure reading ASF header object", kXMPErr_InternalFailure);
 			}
 
+			if ( objectBase.size > (newObject.len - read) ) break;	// The object exceeds the header object.
+
 			if ( IsEqualGUID ( ASF_File_Properties_Object, objectBase.guid) && ( XMP_Int32(objectBase.size) >= 104 ) ) {
 
-				buffer.clear();
-				buffer.reserve ( XMP_Uns32( objectBase.size ) );
-				buffer.assign ( XMP_Uns32( objectBase.size ), ' ' );
-				fileRef->ReadAll ( const_cast<char*>(buffer.data()), XMP_Int32(objectBase.size) );
+				buffer.assign ( header, XMP_Uns32(read), XMP_Uns32( objectBase.size ) );
 
 				// save position of filesize-information
 				posFileSizeInfo = (pos + 40);
@@ -186,10 +187,7 @@ bool ASF_Support::ReadHeaderObject ( XMP_IO* fileRef, ObjectState& inOutObjectSt
 
 			} else if ( IsEqualGUID ( ASF_Content_Description_Object, objectBase.guid) && ( XMP_Int32(objectBase.size) >= 34 ) ) {
 
-				buffer.clear();
-				buffer.reserve ( XMP_Uns32( objectBase.size ) );
-				buffer.assign ( XMP_Uns32( objectBase.size ), ' ' );
-				fileRef->ReadAll ( const_cast<char*>(buffer.data()), XMP_Int32(objectBase.size) );
+				buffer.assign ( header, XMP_Uns32(read), XMP_Uns32( objectBase.size ) );
 
 				XMP_Uns16 titleLen = GetUns16LE ( &buffer[24] );
 				XMP_Uns16 authorLen = GetUns16LE ( &buffer[26] );
@@ -225,10 +223,7 @@ bool ASF_Support::ReadHeaderObject ( XMP_IO* fileRef, ObjectState& inOutObjectSt
 
 			} else if ( IsEqualGUID ( ASF_Content_Branding_Object, objectBase.guid ) ) {
 
-				buffer.clear();
-				buffer.reserve ( XMP_Uns32( objectBase.size ) );
-				buffer.assign ( XMP_Uns32( objectBase.size ), ' ' );
-				fileRef->ReadAll ( const_cast<char*>(buffer.data()), XMP_Int32(objectBase.size) );
+				buffer.assign ( header, XMP_Uns32(read), XMP_Uns32( objectBase.size ) );
 
 				XMP_Uns32 fieldPos = 28;
 
@@ -248,10 +243,7 @@ bool ASF_Support::ReadHeaderObject ( XMP_IO* fileRef, ObjectState& inOutObjectSt
 
 			} else if ( IsEqualGUID ( ASF_Content_Encryption_Object, objectBase.guid ) ) {
 
-				buffer.clear();
-				buffer.reserve ( XMP_Uns32( objectBase.size ) );
-				buffer.assign ( XMP_Uns32( objectBase.size ), ' ' );
-				fileRef->ReadAll ( const_cast<char*>(buffer.data()), XMP_Int32(objectBase.size) );
+				buffer.assign ( header, XMP_Uns32(read), XMP_Uns32( objectBase.size ) );
 
 				XMP_Uns32 fieldPos = 24;
 
@@ -275,7 +267,8 @@ bool ASF_Support::ReadHeaderObject ( XMP_IO* fileRef, ObjectState& inOutObjectSt
 
 			} else if ( IsEqualGUID ( ASF_Header_Extension_Object, objectBase.guid ) ) {
 
-				this->ReadHeaderExtensionObject ( fileRef, inOutObjectState, pos, objectBase );
+				buffer.assign ( header, XMP_Uns32(read), XMP_Uns32( objectBase.size ) );
+				this->ReadHeaderExtensionObject ( buffer, objectBase );
 
 			}
 
@@ -735,9 +728,9 @@ bool ASF_Support::UpdateFileSize ( XMP_IO* fileRef )
 
 // =============================================================================================
 
-bool ASF_Support::ReadHeaderExtensionObject ( XMP_IO* fileRef, ObjectState& inOutObjectState, const XMP_Uns64& _pos, const ASF_ObjectBase& _objectBase )
+bool ASF_Support::ReadHeaderExtensionObject ( const std::string& buffer, const ASF_ObjectBase& _objectBase )
 {
-	if ( ! IsEqualGUID ( ASF_Header_Extension_Object, _objectBase.guid) || (! legacyManager ) ) return false;
+	if ( ! IsEqualGUID ( ASF_Header_Extension_Object, _objectBase.guid) || (! legacyManager ) || (buffer.size() < 46) ) return false;
 
 	try {
 
@@ -745,16 +738,17 @@ bool ASF_Support::ReadHeaderExtensionObject ( XMP_IO* fileRef, ObjectState& inOu
 		const XMP_Uns64 offset = 46;
 		XMP_Uns64 read = 0;
 		XMP_Uns64 data = (_objectBase.size - offset);
-		XMP_Uns64 pos = (_pos + offset);
+		XMP_Uns64 pos = offset;
 
 		ASF_ObjectBase objectBase;
 
 		while ( read < data ) {
 
-			fileRef->Seek ( pos, kXMP_SeekFromStart );
-			if ( kASF_ObjectBaseLen != fileRef->Read ( &objectBase, kASF_ObjectBaseLen, true ) ) break;
+			if ( (pos + kASF_ObjectBaseLen) > buffer.size() ) break;
+			memcpy ( &objectBase, &buffer[XMP_Uns32(pos)], kASF_ObjectBaseLen );
 
 			objectBase.size = GetUns64LE ( &objectBase.size );
+			if ( objectBase.size < kASF_ObjectBaseLen ) break;
 
 			if ( IsEqualGUID ( ASF_Padding_Object, objectBase.guid ) ) {
 				legacyManager->SetPadding ( legacyManager->GetPadding() + (objectBase.size - 24) );
@@ -69,6 +69,9 @@ typedef struct _ASF_ObjectBase
 
 static const XMP_Uns32 kASF_ObjectBaseLen = (XMP_Uns32) sizeof(ASF_ObjectBase);
 
+// The header object is read into memory as a whole, this is a sanity limit for its size.
+static const XMP_Uns64 kASF_MaxHeaderObjectLen = 256*1024*1024;
+
 // =================================================================================================
 
 class ASF_LegacyManager {
@@ -201,7 +204,7 @@ public:
 
 	bool UpdateFileSize ( XMP_IO* fileRef );
 
-	bool ReadHeaderExtensionObject ( XMP_IO* fileRef, ObjectState& inOutObjectState, const XMP_Uns64& pos, const ASF_ObjectBase& objectBase );
+	bool ReadHeaderExtensionObject ( const std::string& buffer, const ASF_ObjectBase& objectBase );
 	static bool WriteHeaderExtensionObject ( const std::string& buffer, std::string* header, const ASF_ObjectBase& objectBase, const int reservePadding );
 
 	static bool CreatePaddingObject ( std::string* header, const XMP_Uns64 size );
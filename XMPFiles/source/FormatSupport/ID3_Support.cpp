@@ -419,7 +419,7 @@ void ID3Header::write ( XMP_IO* file, XMP_Int64 tagSize )
 // ID3v2Frame
 // =================================================================================================
 
-#define frameDefaults	id(0), flags(0), content(0), contentSize(0), active(true), changed(false)
+#define frameDefaults	id(0), flags(0), content(0), contentSize(0), offset(-1), active(true), changed(false)
 
 ID3v2Frame::ID3v2Frame() : frameDefaults
 {
@@ -499,12 +499,18 @@ void ID3v2Frame::setFrameValue( const std::string& rawvalue, bool needDescriptor
 
 	}
 
+	const std::string& newContent = ( isAlreadyEncoded ? rawvalue : value );
+	XMP_Assert( ( !isAlreadyEncoded ) || ( ( !needDescriptor ) && ( !utf16 ) && value.empty() ) );
+
+	// An unchanged value leaves the frame as it is in the file, the update can then skip it.
+	if ( ( this->content != 0 ) && ( this->contentSize == ( XMP_Int32 ) newContent.size() ) &&
+		 ( memcmp( this->content, newContent.data(), this->contentSize ) == 0 ) ) return;
+
 	this->changed = true;
 	this->release();
 
 	if ( isAlreadyEncoded )
 	{
-		XMP_Assert( ( !needDescriptor ) && ( !utf16 ) && value.empty() );
 		this->contentSize = ( XMP_Int32 ) rawvalue.size();
 	}
 	else
@@ -520,28 +526,27 @@ void ID3v2Frame::setFrameValue( const std::string& rawvalue, bool needDescriptor
 
 // =================================================================================================
 
-XMP_Int64 ID3v2Frame::read ( XMP_IO* file, XMP_Uns8 majorVersion )
+XMP_Int32 ID3v2Frame::parseHeader ( const char* header, XMP_Int64 fileOffset, XMP_Uns8 majorVersion )
 {
 	XMP_Assert ( (2 <= majorVersion) && (majorVersion <= 4) );
 
 	this->release(); // ensures/allows reuse of 'curFrame'
-	XMP_Int64 start = file->Offset();
+	this->offset = fileOffset;
 	
+	XMP_Int32 headerSize = kV23_FrameHeaderSize;
 	if ( majorVersion > 2 ) {
-		file->ReadAll ( this->fields, kV23_FrameHeaderSize );
+		memcpy ( this->fields, header, kV23_FrameHeaderSize );
 	} else {
-		// Read the 6 byte v2.2 header into the 10 byte form.
+		// Copy the 6 byte v2.2 header into the 10 byte form.
+		headerSize = kV22_FrameHeaderSize;
 		memset ( this->fields, 0, kV23_FrameHeaderSize );	// Clear all of the bytes.
-		file->ReadAll ( &this->fields[o_id], 3 );		// Leave the low order byte as zero.
-		file->ReadAll ( &this->fields[o_size+1], 3 );	// Read big endian UInt24.
+		memcpy ( &this->fields[o_id], header, 3 );		// Leave the low order byte as zero.
+		memcpy ( &this->fields[o_size+1], &header[3], 3 );	// Big endian UInt24.
 	}
 
 	this->id = GetUns32BE ( &this->fields[o_id] );
 
-	if ( this->id == 0 ) {
-		file->Seek ( start, kXMP_SeekFromStart );	// Zero ID must mean nothing but padding.
-		return 0;
-	}
+	if ( this->id == 0 ) return 0;	// Zero ID must mean nothing but padding.
 
 	this->flags = GetUns16BE ( &this->fields[o_flags] );
 	XMP_Validate ( (0 == (this->flags & 0xEE)), "invalid lower bits in frame flags", kXMPErr_BadFileFormat );
@@ -554,18 +559,55 @@ XMP_Int64 ID3v2Frame::read ( XMP_IO* file, XMP_Uns8 majorVersion )
 	XMP_Validate ( (this->contentSize >= 0), "negative frame size", kXMPErr_BadFileFormat );
 	XMP_Validate ( (this->contentSize < 20*1024*1024), "single frame exceeds 20MB", kXMPErr_BadFileFormat );
 
+	return headerSize;
+
+}	// ID3v2Frame::parseHeader
+
+// =================================================================================================
+
+void ID3v2Frame::setContent ( const char* data )
+{
+	XMP_Assert ( this->content == 0 );
 	this->content = new char [ this->contentSize ];
+	if ( this->contentSize > 0 ) memcpy ( this->content, data, this->contentSize );
+}
 
+// =================================================================================================
+
+void ID3v2Frame::readContent ( XMP_IO* file, XMP_Uns8 majorVersion )
+{
+	XMP_Assert ( (this->content == 0) && (this->offset >= 0) );
+
+	XMP_Int64 contentOffset = this->offset + kV23_FrameHeaderSize;
+	if ( majorVersion == 2 ) contentOffset = this->offset + kV22_FrameHeaderSize;
+
+	this->content = new char [ this->contentSize ];
+	file->Seek ( contentOffset, kXMP_SeekFromStart );
 	file->ReadAll ( this->content, this->contentSize );
-	return file->Offset() - start;
 
-}	// ID3v2Frame::read
+}	// ID3v2Frame::readContent
+
+// =================================================================================================
+
+bool ID3v2Frame::isBinary() const
+{
+	switch ( this->id ) {
+		case 0x41504943:	// APIC
+		case 0x47454F42:	// GEOB
+		case 0x50494300:	// PIC
+		case 0x47454F00:	// GEO
+			return true;
+		default:
+			return false;
+	}
+}
 
 // =================================================================================================
 
 void ID3v2Frame::write ( XMP_IO* file, XMP_Uns8 majorVersion )
 {
 	XMP_Assert ( (2 <= majorVersion) && (majorVersion <= 4) );
+	XMP_Assert ( this->hasContent() );
 
 	if ( majorVersion < 4 ) {
 		PutUns32BE ( this->contentSize, &this->fields[o_size] );
@@ -657,7 +699,6 @@ bool ID3v2Frame::getFrameValue ( XMP_Uns8 majorVersion, XMP_Uns32 logicalID, std
 
 			if ( commMode && (! advancePastCOMMDescriptor ( pos )) ) return false; // not a frame of interest!
 
-			std::string tmp ( this->content, this->contentSize );
 			bool bigEndian = true;	// assume for now (if no BOM follows)
 
 			if ( GetUns16BE ( &this->content[pos] ) == 0xFEFF ) {
@@ -122,8 +122,10 @@ namespace ID3_Support {
 		char* content;
 		XMP_Int32 contentSize; // size of variable content, right as its stored in o_size
 
+		XMP_Int64 offset; // file offset of the frame header as read, -1 for a new frame
+
 		bool active; //default: true. flag is lowered, if another frame with replaces this one as "last meaningful frame of its kind"
-		bool changed; //default: false. flag is raised, if setString() is used
+		bool changed; //default: false. flag is raised, if setFrameValue() alters the content
 
 		ID3v2Frame();
 		ID3v2Frame ( XMP_Uns32 id );
@@ -139,7 +141,20 @@ namespace ID3_Support {
 		void setFrameValue ( const std::string& rawvalue, bool needDescriptor = false,
 							 bool utf16 = false, bool isXMPPRIVFrame = false, bool needEncodingByte = true, bool isAlreadyEncoded = false );
 		
-		XMP_Int64 read ( XMP_IO* file, XMP_Uns8 majorVersion );
+		// Parse the frame header at the given file offset from a buffer holding the header (6 bytes
+		// for v2.2, 10 bytes otherwise). Returns the header size, or 0 if the bytes are padding. The content is left
+		// for setContent or readContent.
+		XMP_Int32 parseHeader ( const char* header, XMP_Int64 fileOffset, XMP_Uns8 majorVersion );
+
+		// Copy the content from a buffer holding contentSize bytes, or read it from the file.
+		void setContent ( const char* data );
+		void readContent ( XMP_IO* file, XMP_Uns8 majorVersion );
+
+		// Binary frames (APIC, GEOB) are not needed for reconciliation, their content is only read
+		// if an update has to move them.
+		bool isBinary() const;
+		bool hasContent() const { return (this->content != 0) || (this->contentSize == 0); }
+
 		void write ( XMP_IO* file, XMP_Uns8 majorVersion );
 
 		// two types of COMM frames should be preserved but otherwise ignored
@@ -716,32 +716,43 @@ void Chunk::readChunk( XMP_IO* file )
 	// error handling is done in the controller
 	// determine offset in the file
 	mOriginalOffset = mOffset = file->Offset();
-	//ID is always BE
-	mChunkId.id = XIO::ReadUns32_BE( file );
-	// Size can be both
-	if (typeid(mEndian) == typeid(LittleEndian))
-	{
-		mOriginalSize = mSize = XIO::ReadUns32_LE( file );
 
-	}
-	else
+	// Read id, size and the type (or the first four data bytes) with a single read.
+	// A chunk at the very end of the file may be just the eight byte header.
+	XMP_Uns8 header[HEADER_SIZE + TYPE_SIZE];
+	XMP_Uns32 got = file->Read ( header, HEADER_SIZE + TYPE_SIZE );
+
+	if ( got < HEADER_SIZE )
 	{
-		mOriginalSize = mSize = XIO::ReadUns32_BE( file );
+		file->ReadAll ( &header[got], HEADER_SIZE - got );	// throws the usual EOF error
+		got = HEADER_SIZE;
 	}
 
+	//ID is always BE
+	mChunkId.id = BigEndian::getInstance().getUns32( header );
+	// Size can be both
+	mOriginalSize = mSize = mEndian.getUns32( &header[4] );
+
 	// For Type do not assume any format as it could be data, read it as bytes
 	if (mSize >= TYPE_SIZE)
 	{
-		mData = new XMP_Uns8[TYPE_SIZE];
-
-		for ( XMP_Uns32 i = 0; i < TYPE_SIZE ; i++ )
+		if ( got < HEADER_SIZE + TYPE_SIZE )
 		{
-			mData[i] = XIO::ReadUns8( file );
+			file->ReadAll ( &header[got], HEADER_SIZE + TYPE_SIZE - got );	// throws the usual EOF error
 		}
+
+		mData = new XMP_Uns8[TYPE_SIZE];
+		memcpy( mData, &header[HEADER_SIZE], TYPE_SIZE );
+
 		//Chunk type is always BE
 		//The first four bytes could be the type
 		mChunkId.type = BigEndian::getInstance().getUns32( mData );
 	}
+	else if ( got > HEADER_SIZE )
+	{
+		// the bytes behind the header belong to the data or the next chunk
+		file->Seek ( -static_cast<XMP_Int64>( got - HEADER_SIZE ), kXMP_SeekFromCurrent );
+	}
 
 	mDirty = false;
 }//readChunk
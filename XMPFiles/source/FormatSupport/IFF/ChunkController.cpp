@@ -195,12 +195,14 @@ void ChunkController::parseChunks( XMP_IO* stream, ChunkPath& currentPath, XMP_O
 			//
 			// check size if value exceeds 4GB border
 			//
-			if(chunk->getSize() >= kMaxRIFFChunkSize || chunk->getID() == kChunk_RF64)
+			bool isRF64 = ( chunk->getID() == kChunk_RF64 || chunk->getID() == kChunk_BW64 );
+
+			if(chunk->getSize() >= kMaxRIFFChunkSize || isRF64)
 			{
 				// remember file position
 				XMP_Int64 currentFilePos = stream->Offset();
 				
-				if(chunk->getID() == kChunk_RF64)
+				if(isRF64)
 				{
 					// get riff size present in ds64 , parse ds64 as it a mandatory chunk
 					XMP_Uns64 ds64RF64Size = mChunkBehavior->getRealSize( kMaxRIFFChunkSize,
@@ -254,36 +256,26 @@ void ChunkController::parseChunks( XMP_IO* stream, ChunkPath& currentPath, XMP_O
 			// extend search path
 			currentPath.append( chunk->getIdentifier() );
 
-			// first 4 bytes might be already read by the chunk->readChunk function
-			XMP_Uns64 offsetOfChunkRead = stream->Offset() -  filePos - Chunk::HEADER_SIZE;
+			bool isContainer = false;
 
 			switch ( compareChunkPaths(currentPath) )
 			{
-				case ChunkPath::kFullMatch :
-				{
-					chunk->cacheChunkData( stream );
-				}
-				break;
-
 				case ChunkPath::kPartMatch :
 				{
 					parseChunks( stream, currentPath, options, chunk);
 					// recalculate the size based on the sizes of its children
 					chunk->calculateSize( true );
+					isContainer = true;
 				}
 				break;
 
+				case ChunkPath::kFullMatch :
 				case ChunkPath::kNoMatch :
 				{
-					// Not a chunk we are interested in, so mark it as not changed
-					// It will then be ignored by any further logic
+					// Only the header is kept. The data of chunks of interest is read when the
+					// handler asks for it (cacheChunks) or when the chunk is moved (writeFile).
+					// Mark it as not changed, so it is ignored by any further logic
 					chunk->resetChanges();
-
-					if ( !chunkJump && chunk->getSize() > 0) // if chunk not empty
-					{
-						XMP_Validate( stream->Offset() + chunk->getSize() - offsetOfChunkRead <= mFileSize , "ERROR: want's to skip beyond EOF", kXMPErr_InternalFailure);
-						stream->Seek ( chunk->getSize() - offsetOfChunkRead , kXMP_SeekFromCurrent );
-					}
 				}
 				break;
 			}
@@ -291,16 +283,33 @@ void ChunkController::parseChunks( XMP_IO* stream, ChunkPath& currentPath, XMP_O
 			// remove last identifier from current path
 			currentPath.remove();
 
-			// update current file position
-			filePos = stream->Offset();
+			if ( isContainer || chunkJump )
+			{
+				// update current file position
+				filePos = stream->Offset();
 
-			// skip pad byte if there is one (if size odd)
-			if( filePos < mFileSize &&
-				( ( chunkJump && ( stream->Offset() & 1 ) > 0 ) ||
-				( !chunkJump && ( chunk->getSize() & 1 ) > 0 ) ) )
+				// skip pad byte if there is one (if size odd)
+				if( filePos < mFileSize &&
+					( ( chunkJump && ( filePos & 1 ) > 0 ) ||
+					( !chunkJump && ( chunk->getSize() & 1 ) > 0 ) ) )
+				{
+					stream->Seek ( 1 , kXMP_SeekFromCurrent );
+					filePos++;
+				}
+			}
+			else
 			{
-				stream->Seek ( 1 , kXMP_SeekFromCurrent );
-				filePos++;
+				// skip the data and a pad byte if there is one (if size odd),
+				// the new position follows from the header
+				filePos += chunk->getSize( true );
+				XMP_Validate( filePos <= mFileSize , "ERROR: want's to skip beyond EOF", kXMPErr_InternalFailure);
+
+				if( filePos < mFileSize && ( chunk->getSize() & 1 ) > 0 )
+				{
+					filePos++;
+				}
+
+				stream->Seek ( filePos, kXMP_SeekFromStart );
 			}
 		}
 	}
@@ -362,6 +371,14 @@ void ChunkController::writeFile( XMP_IO* stream ,XMP_ProgressTracker * progressT
 	//
 	mChunkBehavior->fixHierarchy(*mRoot);
 
+	//
+	// The new layout is known now and nothing has been written yet.
+	// Chunks of interest the handler never asked for are still header only,
+	// read the data of the ones that have to be moved before anything is overwritten.
+	//
+	ChunkPath currentPath;
+	this->cacheMovedChunks( stream, currentPath, *(dynamic_cast<Chunk*>(mRoot)) );
+
 	if (mRoot->numChildren() > 0)
 	{
 		// The new file size (without trailing garbage) is the offset of the last top-level chunk + its size.
@@ -409,6 +426,101 @@ void ChunkController::writeFile( XMP_IO* stream ,XMP_ProgressTracker * progressT
 	}
 }
 
+//-----------------------------------------------------------------------------
+// 
+// ChunkController::cacheChunks(...)
+// 
+// Purpose: Read the data of the chunks that match the passed path
+// 
+//-----------------------------------------------------------------------------
+
+void ChunkController::cacheChunks( XMP_IO* stream, const ChunkPath& path, XMP_Bool last /* = false */ )
+{
+	if( last )
+	{
+		Chunk* chunk = dynamic_cast<Chunk*>( this->getChunk( path, true ) );
+
+		if( chunk != NULL )
+		{
+			this->cacheChunk( stream, *chunk );
+		}
+	}
+	else
+	{
+		const std::vector<IChunkData*>& chunks = this->getChunks( path );
+
+		for( std::vector<IChunkData*>::const_iterator iter = chunks.begin(); iter != chunks.end(); iter++ )
+		{
+			this->cacheChunk( stream, *(dynamic_cast<Chunk*>(*iter)) );
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------
+// 
+// ChunkController::cacheChunk(...)
+// 
+// Purpose: Read the data of a chunk that has only its header in memory
+// 
+//-----------------------------------------------------------------------------
+
+void ChunkController::cacheChunk( XMP_IO* stream, Chunk& chunk )
+{
+	if( chunk.getChunkMode() == CHUNK_UNKNOWN )
+	{
+		// Chunk::cacheChunkData continues behind the header (and type) read by Chunk::readChunk
+		XMP_Uns64 dataOffset = chunk.getOriginalOffset() + Chunk::HEADER_SIZE;
+
+		if( chunk.getSize() >= Chunk::TYPE_SIZE )
+		{
+			dataOffset += Chunk::TYPE_SIZE;
+		}
+
+		stream->Seek( dataOffset, kXMP_SeekFromStart );
+		chunk.cacheChunkData( stream );
+	}
+}
+
+
+//-----------------------------------------------------------------------------
+// 
+// ChunkController::cacheMovedChunks(...)
+// 
+// Purpose: Read the data of all chunks of interest that were moved by the 
+//			behavior but have only their header in memory.
+//			This method is supposed to be recursively.
+// 
+//-----------------------------------------------------------------------------
+
+void ChunkController::cacheMovedChunks( XMP_IO* stream, ChunkPath& currentPath, const Chunk& chunk )
+{
+	for( XMP_Uns32 i=0; i<chunk.numChildren(); i++ )
+	{
+		Chunk* child = chunk.getChildAt(i);
+
+		// unchanged chunks stay where they are, and so do their children
+		if( child->hasChanged() )
+		{
+			currentPath.append( child->getIdentifier() );
+
+			if( child->getChunkMode() == CHUNK_NODE )
+			{
+				this->cacheMovedChunks( stream, currentPath, *child );
+			}
+			else if( child->getChunkMode() == CHUNK_UNKNOWN && this->compareChunkPaths( currentPath ) == ChunkPath::kFullMatch )
+			{
+				this->cacheChunk( stream, *child );
+				// same data, but it still has to be written at the new offset
+				child->setChanged();
+			}
+
+			currentPath.remove();
+		}
+	}
+}
+
+
 //-----------------------------------------------------------------------------
 // 
 // ChunkController::getChunk(...)
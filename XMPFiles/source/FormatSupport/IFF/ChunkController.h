@@ -63,14 +63,25 @@ class ChunkController
 
 		/**
 		 * construct the tree, parse children for list of interesting Chunks
-		 * All requested leaf chunks are cached, the parent chunks are created but not cached
-		 * and the rest is skipped.
+		 * Only the headers are read: the requested leaf chunks and the parent chunks are created,
+		 * the rest is skipped. The data of the requested leaf chunks is read by cacheChunks().
 		 *
 		 * @param stream the open [file] stream with file pointer at the beginning of the file
 		 *
 		 */
 		void parseFile( XMP_IO* stream, XMP_OptionBits* options  = NULL );
 
+		/**
+		 * Read the data of the chunks that match the passed path, if that hasn't been done yet.
+		 * Must be called before the data of a chunk returned by getChunk()/getChunks() is accessed.
+		 * Chunks that are never requested are only read by writeFile() if they have to be moved.
+		 *
+		 * @param stream the open [file] stream that was passed to parseFile()
+		 * @param path the path of the chunks to read
+		 * @param last read only the chunk that getChunk( path, true ) returns
+		 */
+		void cacheChunks( XMP_IO* stream, const ChunkPath& path, XMP_Bool last = false );
+
 		/**
 		 * Create a new empty chunk
 		 *
@@ -103,7 +114,8 @@ class ChunkController
 		 * 1. fix the file tree (ChunkBehavior#fixHierarchy),
 		 *    offsets are corrected, no overlapping chunks;
 		 *    if rearranging fails, the file is not touched
-		 * 2. write the changed chunks to the file
+		 * 2. read the data of moved chunks that have not been cached
+		 * 3. write the changed chunks to the file
 		 *
 		 * @param stream the open [file] stream for writing, the file pointer must be at the beginning
 		 * @param progressTracker Progress tracker to track the file write progress and reporting it to client
@@ -177,6 +189,21 @@ class ChunkController
 		 */
 		ChunkPath::MatchResult compareChunkPaths( const ChunkPath& currentPath );
 
+		/**
+		 * Read the data of a chunk that has only its header in memory.
+		 *
+		 * @param stream the file stream
+		 * @param chunk the chunk to read
+		 */
+		void cacheChunk( XMP_IO* stream, Chunk& chunk );
+
+		/**
+		 * Read the data of all chunks of interest that were moved by the behavior
+		 * but have only their header in memory.
+		 * This method is supposed to be recursively.
+		 */
+		void cacheMovedChunks( XMP_IO* stream, ChunkPath& currentPath, const Chunk& chunk );
+
 		/**
 		 * Find a chunk described by path in the hierarchy of chunks starting at the passed chunk.
 		 * The position of chunk in the hierarchy is described by the parameter currentPath.
@@ -35,6 +35,7 @@ enum {
 	// format chunks
 	kChunk_RIFF = 0x52494646,
 	kChunk_RF64 = 0x52463634,
+	kChunk_BW64 = 0x42573634,
 	kChunk_FORM = 0x464F524D,
 	kChunk_JUNK = 0x4A554E4B,
 	kChunk_JUNQ = 0x4A554E51,
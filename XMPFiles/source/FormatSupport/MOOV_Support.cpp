@@ -178,6 +178,259 @@ void MOOV_Manager::ParseNestedBoxes ( BoxNode * parentNode, const std::string &
 
 }	// MOOV_Manager::ParseNestedBoxes
 
+// =================================================================================================
+// Selective reading of the 'moov' box
+// ===================================
+//
+// The 'moov' box of a long recording is mostly the sample tables inside each track's 'stbl', which
+// the metadata code never looks at. ReadMoovBox follows the moov/trak/mdia/minf/stbl path in the
+// file and copies everything else in one piece. A large 'stbl' child is left in the file, only its
+// header is appended, with the size changed to make the box empty. The size of each box on the path
+// is also changed to its new length, so that ParseMemoryTree sees a consistent 'moov' subtree.
+//
+// The timecode track's 'stsc' and 'stco' or 'co64' boxes are used to find the timecode sample, the
+// tables of a track are only skipped if its 'hdlr' says that it is not a timecode track.
+
+static const XMP_Uns32 kSelectiveReadSize = 1024*1024;	// Smaller 'moov' boxes are read whole.
+static const XMP_Uns32 kMinSkippedSize = 64*1024;		// Smaller boxes cost less to read than to skip.
+
+static const XMP_Uns32 kSelectPath[] = { ISOMedia::k_moov, ISOMedia::k_trak, ISOMedia::k_mdia, ISOMedia::k_minf, ISOMedia::k_stbl };
+static const size_t kSelectDepth = sizeof ( kSelectPath ) / sizeof ( kSelectPath[0] );	// The depth of 'stbl' children.
+
+struct MOOV_Manager::SelectState {
+	size_t mdiaCount;	// Only the first 'mdia' of a 'trak' is looked at by FindTimecode_trak.
+	bool hdlrSeen;
+	bool skipAllowed;
+	SelectState() : mdiaCount(0), hdlrSeen(false), skipAllowed(false) {};
+};
+
+// =================================================================================================
+// PeekBoxSize
+// ===========
+//
+// Get the full size of a box, given up to 16 bytes of its header and the space left in its parent.
+// This must give the same box boundaries as the in-memory ISOMedia::GetBoxInfo, which is used by
+// ParseMemoryTree on the result of ReadMoovBox.
+
+static XMP_Uns64 PeekBoxSize ( const XMP_Uns8 * header, XMP_Uns64 available, XMP_Uns32 * headerSize )
+{
+	XMP_Uns64 contentSize;
+	XMP_Uns32 u32Size = ( available < 8 ) ? 0 : GetUns32BE ( header );
+
+	if ( available < 8 ) {
+		*headerSize = (XMP_Uns32)available;	// Trailing padding, taken as a whole.
+		return available;
+	} else if ( u32Size >= 8 ) {
+		*headerSize = 8;
+		if ( GetUns32BE ( header + 4 ) == ISOMedia::k_uuid ) {
+			if ( available < 24 ) {
+				*headerSize = (XMP_Uns32)available;
+				return available;
+			}
+			*headerSize = 8 + 16;
+		}
+		contentSize = (XMP_Uns32)(u32Size - *headerSize);	// ! Wraps for a bad 'uuid' size, as in GetBoxInfo.
+	} else if ( u32Size == 0 ) {
+		*headerSize = 8;	// The box goes to the limit.
+		contentSize = available - 8;
+	} else if ( u32Size != 1 ) {
+		*headerSize = 8;	// Bad total size in the range of 2..7, treat as 8.
+		contentSize = 0;
+	} else {
+		if ( available < 16 ) {
+			*headerSize = (XMP_Uns32)available;
+			return available;
+		}
+		XMP_Uns64 u64Size = GetUns64BE ( header + 8 );
+		if ( u64Size < 16 ) u64Size = 16;
+		*headerSize = 16;
+		contentSize = u64Size - 16;
+	}
+
+	if ( contentSize > (available - *headerSize) ) contentSize = available - *headerSize;
+	return (*headerSize + contentSize);
+
+}	// PeekBoxSize
+
+// =================================================================================================
+// PutBoxHeader
+// ============
+//
+// Rewrite a box header in place, keeping the original header size of 8 or 16 bytes.
+
+static void PutBoxHeader ( XMP_Uns8 * boxPtr, XMP_Uns32 boxType, XMP_Uns32 headerSize, XMP_Uns64 boxSize )
+{
+	XMP_Assert ( (headerSize == 8) || (headerSize == 16) );
+
+	if ( headerSize == 8 ) {
+		XMP_Enforce ( boxSize <= 0xFFFFFFFFUL );
+		PutUns32BE ( (XMP_Uns32)boxSize, boxPtr );
+		PutUns32BE ( boxType, boxPtr + 4 );
+	} else {
+		PutUns32BE ( 1, boxPtr );
+		PutUns32BE ( boxType, boxPtr + 4 );
+		PutUns64BE ( boxSize, boxPtr + 8 );
+	}
+
+}	// PutBoxHeader
+
+// =================================================================================================
+// MOOV_Manager::ReadMoovBox
+// =========================
+
+void MOOV_Manager::ReadMoovBox ( XMP_IO * fileRef, XMP_Uns64 moovOffset, XMP_Uns32 moovSize )
+{
+	this->fullSubtree.clear();
+	this->skippedBoxes.clear();
+	this->moovFileOffset = moovOffset;
+	this->moovFileSize = moovSize;
+
+	if ( moovSize <= kSelectiveReadSize ) {
+		this->fullSubtree.assign ( moovSize, 0 );
+		fileRef->Seek ( moovOffset, kXMP_SeekFromStart );
+		fileRef->Read ( &this->fullSubtree[0], moovSize );
+		return;
+	}
+
+	SelectState state;
+	this->AppendSelectedBoxes ( fileRef, moovOffset, (moovOffset + moovSize), 0, &state );
+
+}	// MOOV_Manager::ReadMoovBox
+
+// =================================================================================================
+// MOOV_Manager::AppendSelectedBoxes
+// =================================
+//
+// Append the boxes between childOffset and childLimit in the file to fullSubtree, recursing down the
+// kSelectPath boxes. The depth is that of the boxes being appended, 0 for the 'moov' box itself.
+
+void MOOV_Manager::AppendSelectedBoxes ( XMP_IO * fileRef, XMP_Uns64 childOffset, XMP_Uns64 childLimit,
+										 size_t depth, SelectState * state )
+{
+	XMP_Uns8 header [16];
+
+	for ( XMP_Uns64 boxPos = childOffset; boxPos < childLimit; ) {
+
+		XMP_Uns64 available = childLimit - boxPos;
+		XMP_Uns32 headerLen = ( available < sizeof(header) ) ? (XMP_Uns32)available : (XMP_Uns32)sizeof(header);
+		fileRef->Seek ( boxPos, kXMP_SeekFromStart );
+		fileRef->ReadAll ( header, headerLen );
+
+		XMP_Uns32 headerSize;
+		XMP_Uns64 boxSize = PeekBoxSize ( header, available, &headerSize );
+		XMP_Uns64 contentSize = boxSize - headerSize;
+		XMP_Uns32 boxType = ( headerSize >= 8 ) ? GetUns32BE ( &header[4] ) : 0;
+
+		size_t boxStart = this->fullSubtree.size();
+
+		if ( (depth < kSelectDepth) && (boxType == kSelectPath[depth]) && (headerSize >= 8) ) {
+
+			// Recurse down the path, then fix the size for what was appended.
+			if ( depth == 1 ) *state = SelectState();	// A new 'trak'.
+			if ( depth == 2 ) ++state->mdiaCount;
+			this->fullSubtree.resize ( boxStart + headerSize );
+			this->AppendSelectedBoxes ( fileRef, (boxPos + headerSize), (boxPos + boxSize), (depth + 1), state );
+			PutBoxHeader ( &this->fullSubtree[boxStart], boxType, headerSize, (this->fullSubtree.size() - boxStart) );
+
+		} else if ( (depth == kSelectDepth) && state->skipAllowed && (headerSize >= 8) &&
+					(boxType != ISOMedia::k_stsd) && (boxType != ISOMedia::k_uuid) && (contentSize >= kMinSkippedSize) ) {
+
+			// Leave a large sample table in the file, append an empty box in its place.
+			this->fullSubtree.resize ( boxStart + headerSize );
+			PutBoxHeader ( &this->fullSubtree[boxStart], boxType, headerSize, headerSize );
+			SkippedBox skipped;
+			skipped.moovOffset = (XMP_Uns32) (boxPos - this->moovFileOffset);
+			skipped.contentSize = (XMP_Uns32)contentSize;
+			this->skippedBoxes[(XMP_Uns32)boxStart] = skipped;
+
+		} else {
+
+			// Append the whole box, the file is positioned after the part of the header already read.
+			if ( (boxStart + boxSize) > TopBoxSizeLimit ) XMP_Throw ( "Oversize 'moov' box", kXMPErr_EnforceFailure );
+			this->fullSubtree.resize ( (size_t)(boxStart + boxSize) );
+			XMP_Uns8 * boxPtr = &this->fullSubtree[boxStart];
+			if ( boxSize <= headerLen ) {
+				memcpy ( boxPtr, header, (size_t)boxSize );
+			} else {
+				memcpy ( boxPtr, header, headerLen );
+				fileRef->ReadAll ( (boxPtr + headerLen), (XMP_Uns32)(boxSize - headerLen) );
+			}
+
+			if ( (depth == 3) && (boxType == ISOMedia::k_hdlr) && (state->mdiaCount == 1) && (! state->hdlrSeen) ) {
+				// The track's handler, the same test as FindTimecode_trak.
+				state->hdlrSeen = true;
+				bool isTimecode = false;
+				if ( contentSize >= sizeof ( Content_hdlr ) ) {
+					const Content_hdlr * hdlr = (const Content_hdlr*) (boxPtr + headerSize);
+					isTimecode = (hdlr->versionFlags == 0) && (GetUns32BE ( &hdlr->handlerType ) == ISOMedia::k_tmcd);
+				}
+				state->skipAllowed = (! isTimecode);
+			}
+
+		}
+
+		boxPos += boxSize;
+
+	}
+
+}	// MOOV_Manager::AppendSelectedBoxes
+
+// =================================================================================================
+// MOOV_Manager::ReadSkippedBoxes
+// ==============================
+//
+// Replace a selective read with the full 'moov' box. The parsed tree is rebuilt, so it must not have
+// changes.
+
+void MOOV_Manager::ReadSkippedBoxes ( XMP_IO * fileRef )
+{
+	if ( this->skippedBoxes.empty() ) return;
+	XMP_Enforce ( ! this->IsChanged() );
+
+	RawDataBlock fullMoov;
+	fullMoov.assign ( this->moovFileSize, 0 );
+	fileRef->Seek ( this->moovFileOffset, kXMP_SeekFromStart );
+	fileRef->ReadAll ( &fullMoov[0], this->moovFileSize );
+
+	this->fullSubtree.swap ( fullMoov );
+	this->skippedBoxes.clear();
+	this->ParseMemoryTree ( this->fileMode );
+
+}	// MOOV_Manager::ReadSkippedBoxes
+
+// =================================================================================================
+// MOOV_Manager::FindSkippedBox
+// ============================
+
+const MOOV_Manager::SkippedBox * MOOV_Manager::FindSkippedBox ( const BoxNode & node ) const
+{
+	if ( this->skippedBoxes.empty() || node.changed || (node.offset == 0) ) return 0;
+
+	SkippedBoxMap::const_iterator pos = this->skippedBoxes.find ( node.offset );
+	if ( pos == this->skippedBoxes.end() ) return 0;
+	return &pos->second;
+
+}	// MOOV_Manager::FindSkippedBox
+
+// =================================================================================================
+// MOOV_Manager::GetParsedOffset
+// =============================
+//
+// Add back the content of the skipped boxes in front of this one.
+
+XMP_Uns32 MOOV_Manager::GetParsedOffset ( BoxRef ref ) const
+{
+	XMP_Uns32 offset = this->ISOBaseMedia_Manager::GetParsedOffset ( ref );
+	XMP_Uns32 moovOffset = offset;
+
+	SkippedBoxMap::const_iterator pos = this->skippedBoxes.begin();
+	SkippedBoxMap::const_iterator end = this->skippedBoxes.lower_bound ( offset );
+	for ( ; pos != end; ++pos ) moovOffset += pos->second.contentSize;
+
+	return moovOffset;
+
+}	// MOOV_Manager::GetParsedOffset
+
 
 
 
@@ -227,6 +480,9 @@ XMP_Uns32 MOOV_Manager::NewSubtreeSize ( const BoxNode & node, const std::string
 {
 	XMP_Uns32 subtreeSize = 8 + node.contentSize;	// All boxes will have 8 byte headers.
 
+	const SkippedBox * skipped = this->FindSkippedBox ( node );
+	if ( skipped != 0 ) subtreeSize += skipped->contentSize;
+
 	if( node.boxType == ISOMedia::k_uuid )
 		subtreeSize += 16;				// id of uuid is 16 bytes long
 	if ( (node.boxType == ISOMedia::k_free) || (node.boxType == ISOMedia::k_wide) ) {
@@ -254,7 +510,8 @@ XMP_Uns32 MOOV_Manager::NewSubtreeSize ( const BoxNode & node, const std::string
 // ==============================
 //
 // Append this node's header, content, and children. Because the 'meta' box is a FullBox with nested
-// boxes, there can be both content and children. Ignore 'free' and 'wide' boxes.
+// boxes, there can be both content and children. Ignore 'free' and 'wide' boxes. The content of a box
+// skipped by ReadMoovBox is read straight from the file.
 
 #define IncrNewPtr(count)	{ newPtr += count; XMP_Enforce ( newPtr <= newEnd ); }
 
@@ -263,7 +520,7 @@ XMP_Uns32 MOOV_Manager::NewSubtreeSize ( const BoxNode & node, const std::string
 #endif
 
 XMP_Uns8 * MOOV_Manager::AppendNewSubtree ( const BoxNode & node, const std::string & parentPath,
-											XMP_Uns8 * newPtr, XMP_Uns8 * newEnd )
+											XMP_Uns8 * newPtr, XMP_Uns8 * newEnd, XMP_IO * fileRef )
 {
 	if ( (node.boxType == ISOMedia::k_free) || (node.boxType == ISOMedia::k_wide) ) {
 	}
@@ -297,6 +554,14 @@ XMP_Uns8 * MOOV_Manager::AppendNewSubtree ( const BoxNode & node, const std::str
 		memcpy ( newPtr, content, node.contentSize );
 		IncrNewPtr ( node.contentSize );
 	}
+
+	const SkippedBox * skipped = this->FindSkippedBox ( node );
+	if ( skipped != 0 ) {
+		XMP_Enforce ( (fileRef != 0) && ((XMP_Uns32)(newEnd - newPtr) >= skipped->contentSize) );
+		fileRef->Seek ( (this->moovFileOffset + skipped->moovOffset + node.headerSize), kXMP_SeekFromStart );
+		fileRef->ReadAll ( newPtr, skipped->contentSize );
+		IncrNewPtr ( skipped->contentSize );
+	}
 	
 	// Append the nested boxes.
 	
@@ -309,7 +574,7 @@ XMP_Uns8 * MOOV_Manager::AppendNewSubtree ( const BoxNode & node, const std::str
 		std::string nodePath = parentPath + suffix;
 		
 		for ( size_t i = 0, limit = node.children.size(); i < limit; ++i ) {
-			newPtr = this->AppendNewSubtree ( node.children[i], nodePath, newPtr, newEnd );
+			newPtr = this->AppendNewSubtree ( node.children[i], nodePath, newPtr, newEnd, fileRef );
 		}
 
 	}
@@ -326,7 +591,7 @@ XMP_Uns8 * MOOV_Manager::AppendNewSubtree ( const BoxNode & node, const std::str
 // MOOV_Manager::UpdateMemoryTree
 // ==============================
 
-void MOOV_Manager::UpdateMemoryTree()
+void MOOV_Manager::UpdateMemoryTree ( XMP_IO * fileRef /* = 0 */ )
 {
 	if ( ! this->IsChanged() ) return;
 	
@@ -344,10 +609,11 @@ void MOOV_Manager::UpdateMemoryTree()
 		newOrigin = newPtr;
 	#endif
 	
-	XMP_Uns8 * trueEnd = this->AppendNewSubtree ( this->subtreeRootNode, "", newPtr, newEnd );
+	XMP_Uns8 * trueEnd = this->AppendNewSubtree ( this->subtreeRootNode, "", newPtr, newEnd, fileRef );
 	XMP_Enforce ( trueEnd == newEnd );
 	
 	this->fullSubtree.swap ( newData );
+	this->skippedBoxes.clear();
 	this->ParseMemoryTree ( this->fileMode );
 	
 }	// MOOV_Manager::UpdateMemoryTree
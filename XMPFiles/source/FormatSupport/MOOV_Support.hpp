@@ -18,6 +18,7 @@
 #include "XMPFiles/source/XMPFiles_Impl.hpp"
 #include "XMPFiles/source/FormatSupport/ISOBaseMedia_Support.hpp"
 #include <vector>
+#include <map>
 
 #define TopBoxSizeLimit 100*1024*1024
 
@@ -53,10 +54,23 @@ public:
 
 
 	// ---------------------------------------------------------------------------------------------
+	// ReadMoovBox - Fill fullSubtree from the 'moov' box in the file. A large 'moov' is read
+	// selectively, the bulky sample tables of tracks other than timecode are left in the file. They
+	// look empty in the parsed tree. UpdateMemoryTree copies them from the file, ReadSkippedBoxes
+	// brings them in if their content is needed.
+	// GetParsedOffset - Like the base, but the offset within the file's 'moov' box.
 
+	void ReadMoovBox ( XMP_IO * fileRef, XMP_Uns64 moovOffset, XMP_Uns32 moovSize );
+	void ReadSkippedBoxes ( XMP_IO * fileRef );
+
+	XMP_Uns32 GetParsedOffset ( BoxRef ref ) const;
+
+	// ---------------------------------------------------------------------------------------------
+	// The fileRef for UpdateMemoryTree is only used to copy skipped boxes, it must have the 'moov'
+	// box at the offset passed to ReadMoovBox.
 
 	void ParseMemoryTree ( XMP_Uns8 fileMode );
-	void UpdateMemoryTree();
+	void UpdateMemoryTree ( XMP_IO * fileRef = 0 );
 
 	// ---------------------------------------------------------------------------------------------
 
@@ -121,7 +135,7 @@ public:
 
 	// ---------------------------------------------------------------------------------------------
 
-	MOOV_Manager() : fileMode(0)
+	MOOV_Manager() : fileMode(0), moovFileOffset(0), moovFileSize(0)
 	{
 		XMP_Assert ( sizeof ( Content_mvhd_0 ) == 100 );	// Make sure the structs really are packed.
 		XMP_Assert ( sizeof ( Content_mvhd_1 ) == 112 );
@@ -136,12 +150,29 @@ private:
 
 	
 	XMP_Uns8 fileMode;
+
+	struct SkippedBox {
+		XMP_Uns32 moovOffset;	// The box offset within the file's 'moov' box.
+		XMP_Uns32 contentSize;	// The content left in the file.
+	};
+
+	typedef std::map < XMP_Uns32, SkippedBox > SkippedBoxMap;	// Keyed by the box offset in fullSubtree.
+
+	SkippedBoxMap skippedBoxes;
+	XMP_Uns64 moovFileOffset;
+	XMP_Uns32 moovFileSize;
+
+	struct SelectState;
+
+	void AppendSelectedBoxes ( XMP_IO * fileRef, XMP_Uns64 childOffset, XMP_Uns64 childLimit,
+							   size_t depth, SelectState * state );
+	const SkippedBox * FindSkippedBox ( const BoxNode & node ) const;
 	
 	void ParseNestedBoxes ( BoxNode * parentNode, const std::string & parentPath, bool ignoreMetaBoxes );
 
 	XMP_Uns32  NewSubtreeSize ( const BoxNode & node, const std::string & parentPath );
 	XMP_Uns8 * AppendNewSubtree ( const BoxNode & node, const std::string & parentPath,
-										 XMP_Uns8 * newPtr, XMP_Uns8 * newEnd );
+										 XMP_Uns8 * newPtr, XMP_Uns8 * newEnd, XMP_IO * fileRef );
 
 };	// MOOV_Manager
 
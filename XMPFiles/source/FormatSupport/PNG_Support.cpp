@@ -13,73 +13,12 @@
 
 #include "source/XIO.hpp"
 
+#include "third-party/zlib/zlib.h"
+
 #include <string.h>
 
 typedef std::basic_string<unsigned char> filebuffer;
 
-namespace CRC
-{
-    /* Table of CRCs of all 8-bit messages. */
-    static unsigned long crc_table[256];
-    
-    /* Flag: has the table been computed? Initially false. */
-    static int crc_table_computed = 0;
-    
-    /* Make the table for a fast CRC. */
-    static void make_crc_table(void)
-    {
-        unsigned long c;
-        int n, k;
-        
-        for (n = 0; n < 256; n++)
-        {
-            c = (unsigned long) n;
-            for (k = 0; k < 8; k++)
-            {
-                if (c & 1)
-                {
-                    c = 0xedb88320L ^ (c >> 1);
-                }
-                else
-                {
-                    c = c >> 1;
-                }
-            }
-            crc_table[n] = c;
-        }
-        crc_table_computed = 1;
-    }
-    
-    /* Update a running CRC with the bytes buf[0..len-1]--the CRC
-     should be initialized to all 1's, and the transmitted value
-     is the 1's complement of the final running CRC (see the
-     crc() routine below). */
-    
-    static unsigned long update_crc(unsigned long crc, unsigned char *buf, int len)
-    {
-        unsigned long c = crc;
-        int n;
-        
-        if (!crc_table_computed)
-        {
-            make_crc_table();
-        }
-        
-        for (n = 0; n < len; n++)
-        {
-            c = crc_table[(c ^ buf[n]) & 0xff] ^ (c >> 8);
-        }
-        
-        return c;
-    }
-    
-    /* Return the CRC of the bytes buf[0..len-1]. */
-    static unsigned long crc(unsigned char *buf, int len)
-    {
-        return update_crc(0xffffffffL, buf, len) ^ 0xffffffffL;
-    }
-} // namespace CRC
-
 namespace PNG_Support
 {
     enum chunkType {
@@ -107,69 +46,120 @@ namespace PNG_Support
     };
     
     // =============================================================================================
-    
-    long OpenPNG ( XMP_IO* fileRef, ChunkState & inOutChunkState )
+    // ChunkWalker
+    // ===========
+    //
+    // Steps through the chunk headers with few reads. The file is read in windows, the headers of
+    // small chunks are usually in the window already. The window is kWindowSize for the metadata,
+    // kRunWindowSize within a run of small IDAT chunks. After a large IDAT chunk just the next 8
+    // byte header is read, so that image data is not read at all. The IDAT chunks of a file are
+    // normally all the same size, so the last one is a good guess for the next.
+
+    class ChunkWalker
     {
-        XMP_Int64 pos = 0;
-        long name;
-        XMP_Uns32 len;
-        
-        pos = fileRef->Seek ( 8, kXMP_SeekFromStart );
-        if (pos != 8) return 0;
-        
-        // read first and following chunks
-        while ( ReadChunk ( fileRef, inOutChunkState, &name, &len, pos) ) {}
-        
-        return (long)inOutChunkState.chunks.size();
-        
-    }
-    
+        public:
+
+            enum { kWindowSize = 64*1024, kRunWindowSize = 1024*1024, kLargeChunk = 256*1024 };
+
+            ChunkWalker ( XMP_IO* _fileRef )
+                : fileRef(_fileRef), fileLength(_fileRef->Length()), windowPos(0), windowLen(0),
+                  chunkPos(0), chunkLen(0), chunkType(0) {}
+
+            // Move to the next chunk, the first is just after the signature. Returns false if there
+            // is not a full chunk header left. Throws if the chunk goes past the end of the file.
+            bool NextChunk()
+            {
+                XMP_Int64 nextPos = ( this->chunkPos == 0 ) ? 8 : (this->chunkPos + 12 + this->chunkLen);
+                if ( (this->fileLength - nextPos) < 8 ) return false;
+
+                if ( (nextPos < this->windowPos) || ((nextPos + 8) > (this->windowPos + this->windowLen)) ) {
+                    XMP_Int64 readLen = kWindowSize;
+                    if ( this->chunkType == IDAT ) readLen = ( this->chunkLen >= kLargeChunk ) ? 8 : kRunWindowSize;
+                    if ( readLen > (this->fileLength - nextPos) ) readLen = this->fileLength - nextPos;
+                    if ( this->window.size() < (size_t)readLen ) this->window.resize ( (size_t)readLen );
+                    this->fileRef->Seek ( nextPos, kXMP_SeekFromStart );
+                    this->fileRef->ReadAll ( &this->window[0], (XMP_Uns32)readLen );
+                    this->windowPos = nextPos;
+                    this->windowLen = (XMP_Uns32)readLen;
+                }
+
+                const XMP_Uns8* header = &this->window[(size_t)(nextPos - this->windowPos)];
+                this->chunkPos  = nextPos;
+                this->chunkLen  = GetUns32BE ( header );
+                this->chunkType = GetUns32BE ( header + 4 );
+
+                if ( (this->chunkPos + 12 + this->chunkLen) > this->fileLength ) {
+                    XMP_Throw ( "Invalid PNG chunk length", kXMPErr_BadPNG );
+                }
+
+                return true;
+            }
+
+            XMP_Int64 ChunkPos() const { return this->chunkPos; }
+            XMP_Uns32 ChunkLen() const { return this->chunkLen; }
+            XMP_Uns32 ChunkType() const { return this->chunkType; }
+
+            // The part of the chunk data that is in the window, up to the whole data.
+            XMP_Uns8* DataInWindow ( XMP_Int64* availableLen )
+            {
+                size_t dataOffset = (size_t)(this->chunkPos + 8 - this->windowPos);
+                *availableLen = this->windowLen - dataOffset;
+                if ( *availableLen > this->chunkLen ) *availableLen = this->chunkLen;
+                return &this->window[0] + dataOffset;
+            }
+
+        private:
+
+            XMP_IO* fileRef;
+            XMP_Int64 fileLength;
+
+            std::vector<XMP_Uns8> window;
+            XMP_Int64 windowPos;
+            XMP_Uns32 windowLen;
+
+            XMP_Int64 chunkPos;
+            XMP_Uns32 chunkLen;
+            XMP_Uns32 chunkType;
+
+    };	// ChunkWalker
+
     // =============================================================================================
-    
-    bool  ReadChunk ( XMP_IO* fileRef, ChunkState & inOutChunkState, long * chunkType, XMP_Uns32 * chunkLength, XMP_Int64 & inOutPosition )
+
+    long OpenPNG ( XMP_IO* fileRef, ChunkState & inOutChunkState )
     {
-        try
-        {
-            XMP_Uns64 startPosition = inOutPosition;
-            long bytesRead;
-            char buffer[8];
-            
-            bytesRead = fileRef->Read ( buffer, 8 );
-            if ( bytesRead != 8 ) return false;
-            inOutPosition += 8;
-            *chunkLength = GetUns32BE(buffer);
-            *chunkType = GetUns32BE(buffer + 4);
-            
-            inOutPosition += *chunkLength;
-            inOutPosition += 4; //for CRC
+        // A run of IDAT chunks is kept as one ChunkData, the image data is only ever copied as a
+        // whole. The len is that of the first chunk in the run, the spanLen covers all of them.
 
-			if(inOutPosition > fileRef->Length())
-				XMP_Throw("Invalid PNG chunk length", kXMPErr_BadPNG);
-            
-            ChunkData	newChunk;
-            
-            newChunk.pos = startPosition;
-            newChunk.len = *chunkLength;
-            newChunk.type = *chunkType;
-            
-            // check for XMP in iTXt-chunk
-            if (newChunk.type == iTXt)
-            {
-                CheckiTXtChunkHeader(fileRef, inOutChunkState, newChunk);
+        ChunkWalker walker ( fileRef );
+
+        while ( walker.NextChunk() ) {
+
+            ChunkData newChunk;
+            newChunk.pos = walker.ChunkPos();
+            newChunk.len = walker.ChunkLen();
+            newChunk.type = walker.ChunkType();
+            newChunk.spanLen = (XMP_Uns64)newChunk.len + 12;
+
+            if ( (newChunk.type == IDAT) && (! inOutChunkState.chunks.empty()) ) {
+                ChunkData & prevChunk = inOutChunkState.chunks.back();
+                if ( prevChunk.type == IDAT ) {
+                    XMP_Assert ( (prevChunk.pos + prevChunk.spanLen) == newChunk.pos );
+                    prevChunk.spanLen += newChunk.spanLen;
+                    continue;
+                }
             }
-            
+
+            // check for XMP in iTXt-chunk
+            if ( newChunk.type == iTXt ) CheckiTXtChunkHeader ( fileRef, inOutChunkState, newChunk );
+
             inOutChunkState.chunks.push_back ( newChunk );
-            
-            fileRef->Seek ( inOutPosition, kXMP_SeekFromStart );
-            
-        } catch ( ... ) {
-			throw;
+
         }
-        
-        return true;
-        
+
+        return (long)inOutChunkState.chunks.size();
+
     }
-    
+
     // =============================================================================================
     
     /*PNG file is structured in a series of chunks, where each chunk consists of four parts:
@@ -181,117 +171,41 @@ namespace PNG_Support
      XMP metadata is present in chunk of type “iTXt”.FindAndReadXMPChunk api will continue to
      find chunks until it finds "iTXt" chunk. XMP metadata is extracted from "iTXt" chunk by
      ExtractXMPPacket api. FindAndReadXMPChunk terminates if it finds "iTXt" chunk or end of 
-     file is reached.
+     file is reached. It also stops at IEND for reads, and at the first IDAT if asked to. The XMP
+     may legally follow the image data, but XMPFiles writes it right after the IHDR.
      */
     
-	bool  FindAndReadXMPChunk(XMP_IO* fileRef, std::string& outXMPPacket, XMP_Int64& outXmpOffset, bool isOpenForRead)
+	bool  FindAndReadXMPChunk(XMP_IO* fileRef, std::string& outXMPPacket, XMP_Int64& outXmpOffset, bool isOpenForRead, bool stopAtImageData)
 	{
-		XMP_Int64 inOutPosition = 8;
-
-		XMP_Int64 fileLength = fileRef->Length();
-		XMP_Int64 remainingBytes = fileLength - inOutPosition;
-
-		XMP_Uns32 chunkType = 0;
-		XMP_Uns32 chunkLength = 0;
-		bool processedXMP = false;
-		bool iendChunkFound = false;
-		XMP_Uns32 currentBufferSize = 0;
-
-		const XMP_Uns8 CRC = 4; //No. of bytes stores CRC info. 
-		const XMP_Uns32 MaxBufferSize = 1024 * 1024; //max buffer.
-		XMP_Uns8* buffer = NULL;
 		outXMPPacket.clear();
 
-		try {
-			while (remainingBytes >= 8)
-			{
-				XMP_Int64 seekedPosition = fileRef->Seek(inOutPosition, kXMP_SeekFromStart);
-				if (seekedPosition == -1)
-				{
-					XMP_Throw ( "seek failed", kXMPErr_BadPNG );
-				}
-
-				if (remainingBytes > MaxBufferSize)
-				{
-					currentBufferSize = MaxBufferSize;
-				}
-				else
-				{
-					currentBufferSize = static_cast<XMP_Uns32>(remainingBytes);
-				}
-
-				buffer = new XMP_Uns8[currentBufferSize];
-
-				fileRef->Read(buffer, currentBufferSize, true);
-				
-				//Process the buffer.
-				XMP_Uns8* tempBuffer = buffer;
-				XMP_Uns8* bufferLimit = buffer + currentBufferSize;
-				while (true)
-				{
-					chunkLength = GetUns32BE(tempBuffer);
-					chunkType = GetUns32BE(tempBuffer + 4);
-
-					tempBuffer += 8;
-
-					if (chunkType == iTXt)
-					{
-						/* There could be multiple iTXt chunks. There should be no more than one
-						 * chunk containing XMP in each PNG file.
-						 */
-						if (ExtractXMPPacket(fileRef, chunkLength, tempBuffer, bufferLimit - tempBuffer, inOutPosition, outXMPPacket, outXmpOffset))
-						{
-						    processedXMP = true;
-						    break;
-						}
-					}
-					else if (chunkType == IEND && isOpenForRead) {
-						/*signifies end of png file. No need to process further.*/
-						iendChunkFound = true;
-						break;
-					}
-
-					//skip the current chunk.
-					inOutPosition += 8 + static_cast<XMP_Int64>(chunkLength) + CRC;
-					
-					if(inOutPosition > fileLength)
-					{
-						XMP_Throw ( "Invalid PNG chunk length", kXMPErr_BadPNG );
-					}
-
-					//if current buffer have enough data for current chunk and next chunk's 8 bytes
-					if ((bufferLimit - tempBuffer) > static_cast<XMP_Int64>((chunkLength + CRC + 8)))
-					{
-						tempBuffer += chunkLength + CRC;
-						continue;
-					}
-
-					break;
-				}
+		ChunkWalker walker ( fileRef );
 
-				delete[] buffer;
-				buffer = NULL;
+		while ( walker.NextChunk() )
+		{
+			XMP_Uns32 chunkType = walker.ChunkType();
 
-				if (processedXMP || iendChunkFound)
+			if (chunkType == iTXt)
+			{
+				/* There could be multiple iTXt chunks. There should be no more than one
+				 * chunk containing XMP in each PNG file.
+				 */
+				XMP_Int64 bytesInWindow;
+				XMP_Uns8* dataPtr = walker.DataInWindow ( &bytesInWindow );
+				if (ExtractXMPPacket(fileRef, walker.ChunkLen(), dataPtr, bytesInWindow, walker.ChunkPos(), outXMPPacket, outXmpOffset))
 				{
-					//if xmp packet found or IEND chunk found, no need to process further.
 					break;
 				}
-
-				remainingBytes = fileLength - inOutPosition;
 			}
-		}
-		catch(XMP_Error&)
-		{
-			delete[] buffer;
-			buffer = NULL;
-			throw;
-		}
-		catch (...)
-		{
-			delete[] buffer;
-			buffer = NULL;
-			throw;
+			else if (chunkType == IEND && isOpenForRead)
+			{
+				/*signifies end of png file. No need to process further.*/
+				break;
+			}
+			else if (chunkType == IDAT && stopAtImageData)
+			{
+				break;
+			}
 		}
 
 		return (outXMPPacket.size() != 0);
@@ -391,7 +305,7 @@ namespace PNG_Support
         try
         {
             sourceRef->Seek ( chunk.pos, kXMP_SeekFromStart  );
-            XIO::Copy (sourceRef, destRef, (chunk.len + 12));
+            XIO::Copy (sourceRef, destRef, chunk.spanLen);
             
         } catch ( ... ) {
             
@@ -509,7 +423,8 @@ namespace PNG_Support
     
     unsigned long CalculateCRC( unsigned char* inBuffer, XMP_Uns32 len )
     {
-        return CRC::update_crc(0xffffffffL, inBuffer, len) ^ 0xffffffffL;
+        // PNG uses the same CRC-32 as zlib, whose implementation is much faster than a bytewise table.
+        return crc32 ( 0, inBuffer, len );
     }
     
 } // namespace PNG_Support
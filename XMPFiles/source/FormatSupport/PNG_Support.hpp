@@ -31,7 +31,7 @@ namespace PNG_Support
 	class ChunkData
 	{
 		public:
-			ChunkData() : pos(0), len(0), type(0), xmp(false) {}
+			ChunkData() : pos(0), len(0), type(0), xmp(false), spanLen(0) {}
 			virtual ~ChunkData() {}
 
 			// | length |  type  |    data     | crc(type+data) |
@@ -41,6 +41,7 @@ namespace PNG_Support
 			XMP_Uns32	len;		// length of chunk data
 			long		type;		// name/type of chunk
 			bool		xmp;		// iTXt-chunk with XMP ?
+			XMP_Uns64	spanLen;	// file length of chunk, of the whole run for IDAT (see OpenPNG)
 	};
 
 	typedef std::vector<ChunkData> ChunkVector;
@@ -60,7 +61,6 @@ namespace PNG_Support
 
 	long OpenPNG ( XMP_IO* fileRef, ChunkState& inOutChunkState );
 
-	bool ReadChunk ( XMP_IO* fileRef, ChunkState& inOutChunkState, long* chunkType, XMP_Uns32* chunkLength, XMP_Int64& inOutPosition );
 	bool WriteXMPChunk ( XMP_IO* fileRef, XMP_Uns32 len, const char* inBuffer );
 	bool CopyChunk ( XMP_IO* sourceRef, XMP_IO* destRef, ChunkData& chunk );
 	unsigned long UpdateChunkCRC( XMP_IO* fileRef, ChunkData& inOutChunkData );
@@ -77,11 +77,12 @@ namespace PNG_Support
     //These 2 functions are introduced to reduce the file read call which is required to find
     //and process XMP in PNG file. Reading small data from file is an expensive operation
     //if processed file is present on network.
-    //Instead of reading 8 bytes to identify each chunk type(see ReadChunk), FindAndReadXMPChunk will copy the file data in a buffer of 1 MB and then process it.
+    //Instead of reading 8 bytes to identify each chunk type, FindAndReadXMPChunk will copy the file data in a buffer of 1 MB and then process it.
     //see bug CTECHXMP-4169872.
     //Now PNG_MetaHandler::CacheFileData is using this function instead of OpenPNG.
+    //Both now step through the chunks with a window read, skipping the IDAT data.
     
-    bool FindAndReadXMPChunk ( XMP_IO* fileRef, std::string& outXMPPacket,XMP_Int64& xmpOffset, bool isOpenForRead );
+    bool FindAndReadXMPChunk ( XMP_IO* fileRef, std::string& outXMPPacket,XMP_Int64& xmpOffset, bool isOpenForRead, bool stopAtImageData = false );
     bool ExtractXMPPacket(XMP_IO* fileRef, XMP_Uns32 chunkLength, XMP_Uns8* buffer, XMP_Int64 bytesInBuffer,XMP_Int64 filePosition, std::string& outXMPPacket,XMP_Int64& xmpOffset);
 
 } // namespace PNG_Support
@@ -59,6 +59,9 @@ void PSIR_FileWriter::DeleteExistingInfo()
 	this->memContent = 0;
 	this->memLength  = 0;
 
+	this->fileOrigin = 0;
+	this->fileLength = 0;
+
 	this->changed = false;
 	this->legacyDeleted = false;
 	this->memParsed = false;
@@ -294,6 +297,8 @@ void PSIR_FileWriter::ParseFileResources ( XMP_IO* fileRef, XMP_Uns32 length )
 	
 	this->DeleteExistingInfo();
 	this->fileParsed = true;
+	this->fileOrigin = fileRef->Offset();
+	this->fileLength = length;
 	if ( length == 0 ) return;
 
 	XMP_Int64 psirOrigin = fileRef->Offset();	// Need this to determine the resource data offsets.
@@ -379,19 +384,15 @@ void PSIR_FileWriter::ParseFileResources ( XMP_IO* fileRef, XMP_Uns32 length )
 }	// PSIR_FileWriter::ParseFileResources
 
 // =================================================================================================
-// PSIR_FileWriter::UpdateMemoryResources
-// ======================================
+// PSIR_FileWriter::GetUpdatedLength
+// =================================
 
-XMP_Uns32 PSIR_FileWriter::UpdateMemoryResources ( void** dataPtr )
+XMP_Uns32 PSIR_FileWriter::GetUpdatedLength() const
 {
-	if ( this->fileParsed ) XMP_Throw ( "Not memory based", kXMPErr_EnforceFailure );
-
-	// Compute the size and allocate the new image resource block.
-
 	XMP_Uns32 newLength = 0;
 
-	InternalRsrcMap::iterator irPos = this->imgRsrcs.begin();
-	InternalRsrcMap::iterator irEnd = this->imgRsrcs.end();
+	InternalRsrcMap::const_iterator irPos = this->imgRsrcs.begin();
+	InternalRsrcMap::const_iterator irEnd = this->imgRsrcs.end();
 
 	for ( ; irPos != irEnd; ++irPos ) {	// Add in the lengths for the 8BIM resources.
 		const InternalRsrcInfo & rsrcInfo = irPos->second;
@@ -409,6 +410,25 @@ XMP_Uns32 PSIR_FileWriter::UpdateMemoryResources ( void** dataPtr )
 		newLength += this->otherRsrcs[i].rsrcLength;
 	}
 
+	return newLength;
+
+}	// PSIR_FileWriter::GetUpdatedLength
+
+// =================================================================================================
+// PSIR_FileWriter::UpdateMemoryResources
+// ======================================
+
+XMP_Uns32 PSIR_FileWriter::UpdateMemoryResources ( void** dataPtr )
+{
+	if ( this->fileParsed ) XMP_Throw ( "Not memory based", kXMPErr_EnforceFailure );
+
+	// Compute the size and allocate the new image resource block.
+
+	XMP_Uns32 newLength = this->GetUpdatedLength();
+
+	InternalRsrcMap::iterator irPos;
+	InternalRsrcMap::iterator irEnd = this->imgRsrcs.end();
+
 	XMP_Uns8* newContent = (XMP_Uns8*) malloc ( newLength );
 	if ( newContent == 0 ) XMP_Throw ( "Out of memory", kXMPErr_NoMemory );
 
@@ -607,3 +627,78 @@ XMP_Uns32 PSIR_FileWriter::UpdateFileResources ( XMP_IO* sourceRef, XMP_IO* dest
 	return destLength;
 
 }	// PSIR_FileWriter::UpdateFileResources
+
+// =================================================================================================
+// PSIR_FileWriter::UpdateFileResourcesInPlace
+// ===========================================
+//
+// The resources are written in the same order as UpdateFileResources, which need not be their
+// order in the file, so the uncaptured data can't be moved within the file as it goes.
+
+void PSIR_FileWriter::UpdateFileResourcesInPlace ( XMP_IO* fileRef )
+{
+	if ( ! this->fileParsed ) XMP_Throw ( "Not file based", kXMPErr_EnforceFailure );
+
+	XMP_Uns32 newLength = this->GetUpdatedLength();
+	if ( newLength != this->fileLength ) XMP_Throw ( "Image resources don't fit in place", kXMPErr_InternalFailure );
+	if ( newLength == 0 ) return;
+
+	std::vector<XMP_Uns8> newContent ( newLength );
+	XMP_Uns8* rsrcPtr = &newContent[0];
+
+	InternalRsrcMap::const_iterator irPos = this->imgRsrcs.begin();
+	InternalRsrcMap::const_iterator irEnd = this->imgRsrcs.end();
+
+	for ( ; irPos != irEnd; ++irPos ) {	// Do the 8BIM resources.
+
+		const InternalRsrcInfo & rsrcInfo = irPos->second;
+
+		PutUns32BE ( k8BIM, rsrcPtr );
+		rsrcPtr += 4;
+		PutUns16BE ( rsrcInfo.id, rsrcPtr );
+		rsrcPtr += 2;
+
+		if ( rsrcInfo.rsrcName == 0 ) {
+			PutUns16BE ( 0, rsrcPtr );
+			rsrcPtr += 2;
+		} else {
+			XMP_Uns32 nameLen = rsrcInfo.rsrcName[0];
+			XMP_Assert ( nameLen > 0 );
+			memcpy ( rsrcPtr, rsrcInfo.rsrcName, nameLen+1 );	// AUDIT: Included in GetUpdatedLength.
+			rsrcPtr += nameLen+1;
+			if ( (nameLen & 1) == 0 ) {
+				*rsrcPtr = 0;	// Round to an even total.
+				++rsrcPtr;
+			}
+		}
+
+		PutUns32BE ( rsrcInfo.dataLen, rsrcPtr );
+		rsrcPtr += 4;
+		if ( rsrcInfo.dataPtr != 0 ) {
+			memcpy ( rsrcPtr, rsrcInfo.dataPtr, rsrcInfo.dataLen );	// AUDIT: Included in GetUpdatedLength.
+		} else if ( rsrcInfo.dataLen > 0 ) {
+			fileRef->Seek ( rsrcInfo.origOffset, kXMP_SeekFromStart );
+			fileRef->ReadAll ( rsrcPtr, rsrcInfo.dataLen );
+		}
+		rsrcPtr += rsrcInfo.dataLen;
+		if ( (rsrcInfo.dataLen & 1) != 0 ) {	// Pad to an even length if necessary.
+			*rsrcPtr = 0;
+			++rsrcPtr;
+		}
+
+	}
+
+	for ( size_t i = 0; i < this->otherRsrcs.size(); ++i ) {	// Do the non-8BIM resources.
+		fileRef->Seek ( this->otherRsrcs[i].rsrcOffset, kXMP_SeekFromStart );
+		fileRef->ReadAll ( rsrcPtr, this->otherRsrcs[i].rsrcLength );
+		rsrcPtr += this->otherRsrcs[i].rsrcLength;	// No need to pad, included in the original resource length.
+	}
+
+	XMP_Assert ( rsrcPtr == (&newContent[0] + newLength) );
+
+	fileRef->Seek ( this->fileOrigin, kXMP_SeekFromStart );
+	fileRef->Write ( &newContent[0], newLength );
+
+	// *** Not rebuilding the internal map, as for UpdateFileResources.
+
+}	// PSIR_FileWriter::UpdateFileResourcesInPlace
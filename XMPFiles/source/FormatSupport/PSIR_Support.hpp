@@ -236,8 +236,18 @@ public:
 									  XMP_AbortProc abortProc, void * abortArg,
 									  XMP_ProgressTracker* progressTracker );
 
+	// The length of the image resource block that an update would write, and for a file parse the
+	// length of the block that was parsed. Neither includes the leading section length.
+	XMP_Uns32 GetUpdatedLength() const;
+	XMP_Uns32 GetParsedFileLength() const { return this->fileLength; };
+
+	// Write the updated image resources over the block they were parsed from. The lengths must be
+	// equal, the section length in the file is not changed. The whole block is built in memory,
+	// reading the data that was not captured from the file, then written at once.
+	void UpdateFileResourcesInPlace ( XMP_IO* fileRef );
+
 	PSIR_FileWriter() : changed(false), legacyDeleted(false), memParsed(false), fileParsed(false),
-						ownedContent(false), memLength(0), memContent(0) {};
+						ownedContent(false), memLength(0), memContent(0), fileOrigin(0), fileLength(0) {};
 
 	virtual ~PSIR_FileWriter();
 
@@ -310,6 +320,9 @@ private:
 	XMP_Uns32 memLength;
 	XMP_Uns8* memContent;
 
+	XMP_Int64 fileOrigin;	// The offset and length of the image resource block for file parses.
+	XMP_Uns32 fileLength;
+
 	typedef std::map<XMP_Uns16,InternalRsrcInfo>  InternalRsrcMap;
 	InternalRsrcMap imgRsrcs;
 
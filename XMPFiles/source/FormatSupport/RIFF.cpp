@@ -33,7 +33,20 @@ Chunk* getChunk ( ContainerChunk* parent, RIFF_MetaHandler* handler )
 {
 	XMP_IO* file = handler->parent->ioRef;
 	XMP_Uns8 level = handler->level;
-	XMP_Uns32 peek = XIO::PeekUns32_LE ( file );
+
+	// read id, size and a possible container type with a single read, the
+	// constructors take it from here. (a chunk at the very end may be just 8 bytes)
+	XMP_Uns8 rawHeader[12];
+	ChunkHeader header;
+	header.pos = file->Offset();
+	header.length = file->Read ( rawHeader, 12 );
+	if ( header.length < 8 ) file->ReadAll ( &rawHeader[header.length], 8 - header.length );	// throws the usual EOF error
+	if ( header.length < 12 ) header.length = 8;
+	header.id = GetUns32LE ( &rawHeader[0] );
+	header.size = GetUns32LE ( &rawHeader[4] );
+	header.type = ( header.length == 12 ) ? GetUns32LE ( &rawHeader[8] ) : 0;
+
+	XMP_Uns32 peek = header.id;
 
 	if ( level == 0 )
 	{
@@ -49,37 +62,33 @@ Chunk* getChunk ( ContainerChunk* parent, RIFF_MetaHandler* handler )
 	switch( peek )
 	{
 	case kChunk_RIFF:
-		return new ContainerChunk( parent, handler );
+		return new ContainerChunk( parent, handler, header );
 	case kChunk_LIST:
 		{
 			if ( level != 1 ) break; // only care on this level
 
 			// look further (beyond 4+4 = beyond id+size) to check on relevance
-			file->Seek ( 8, kXMP_SeekFromCurrent  );
-			XMP_Uns32 containerType = XIO::PeekUns32_LE ( file );
-			file->Seek ( -8, kXMP_SeekFromCurrent  );
+			XMP_Uns32 containerType = header.type;
 
 			bool isRelevantList = ( containerType== kType_INFO || containerType == kType_Tdat || containerType == kType_hdrl );
 			if ( !isRelevantList ) break;
-			return new ContainerChunk( parent, handler );
+			return new ContainerChunk( parent, handler, header );
 		}
 	case kChunk_XMP:
 			if ( level != 1 ) break; // ignore on inappropriate levels (might be compound metadata?)
-			return new XMPChunk( parent, handler );
+			return new XMPChunk( parent, handler, header );
 	case kChunk_DISP:
 		{
 			if ( level != 1 ) break; // only care on this level
 			// peek even further to see if type is 0x001 and size is reasonable
-			file ->Seek ( 4, kXMP_SeekFromCurrent  ); // jump DISP
-			XMP_Uns32 dispSize = XIO::ReadUns32_LE( file );
-			XMP_Uns32 dispType = XIO::ReadUns32_LE( file );
-			file ->Seek ( -12, kXMP_SeekFromCurrent ); // rewind, be in front of chunkID again
+			XMP_Uns32 dispSize = header.size;
+			XMP_Uns32 dispType = header.type;
 
 			// only take as a relevant disp if both criteria met,
 			// otherwise treat as generic chunk!
-			if ( (dispType == 0x0001) && ( dispSize < 256 * 1024 ) )
+			if ( (header.length == 12) && (dispType == 0x0001) && ( dispSize < 256 * 1024 ) )
 			{
-				ValueChunk* r = new ValueChunk( parent, handler );
+				ValueChunk* r = new ValueChunk( parent, handler, header );
 				handler->dispChunk = r;
 				return r;
 			}
@@ -89,34 +98,34 @@ Chunk* getChunk ( ContainerChunk* parent, RIFF_MetaHandler* handler )
 		{
 			if ( level != 1 ) break; // only care on this level
 			// store for now in a value chunk
-			ValueChunk* r = new ValueChunk( parent, handler );
+			ValueChunk* r = new ValueChunk( parent, handler, header );
 			handler->bextChunk = r;
 			return r;
 		}
 	case kChunk_PrmL:
 		{
 			if ( level != 1 ) break; // only care on this level
-			ValueChunk* r = new ValueChunk( parent, handler );
+			ValueChunk* r = new ValueChunk( parent, handler, header );
 			handler->prmlChunk = r;
 			return r;
 		}
 	case kChunk_Cr8r:
 		{
 			if ( level != 1 ) break; // only care on this level
-			ValueChunk* r = new ValueChunk( parent, handler );
+			ValueChunk* r = new ValueChunk( parent, handler, header );
 			handler->cr8rChunk = r;
 			return r;
 		}
 	case kChunk_JUNQ:
 	case kChunk_JUNK:
 		{
-			JunkChunk* r = new JunkChunk( parent, handler );
+			JunkChunk* r = new JunkChunk( parent, handler, header );
 			return r;
 		}
 	case kChunk_IDIT:
 		{
 			if ( level != 2 ) break; // only care on this level
-			ValueChunk* r = new ValueChunk( parent, handler );
+			ValueChunk* r = new ValueChunk( parent, handler, header );
 			handler->iditChunk = r;
 			return r;
 		}
@@ -131,12 +140,12 @@ Chunk* getChunk ( ContainerChunk* parent, RIFF_MetaHandler* handler )
 
 	if ( insideRelevantList )
 	{
-		ValueChunk* r = new ValueChunk( parent, handler );
+		ValueChunk* r = new ValueChunk( parent, handler, header );
 		return r;
 	}
 
 	// general chunk of no interest, treat as unknown blob
-	return new Chunk( parent, handler, true, chunk_GENERAL );
+	return new Chunk( parent, handler, header, true, chunk_GENERAL );
 }
 
 // BASE CLASS CHUNK ///////////////////////////////////////////////
@@ -162,7 +171,7 @@ Chunk::Chunk( ContainerChunk* _parent, ChunkType c, XMP_Uns32 _id )
 }
 
 // parsing creation
-Chunk::Chunk( ContainerChunk* _parent, RIFF_MetaHandler* handler, bool skip, ChunkType c )
+Chunk::Chunk( ContainerChunk* _parent, RIFF_MetaHandler* handler, const ChunkHeader& header, bool skip, ChunkType c )
 {
 	chunkType = c; // base class assumption
 	this->parent = _parent;
@@ -171,9 +180,10 @@ Chunk::Chunk( ContainerChunk* _parent, RIFF_MetaHandler* handler, bool skip, Chu
 
 	XMP_IO* file = handler->parent->ioRef;
 
-	this->oldPos = file->Offset();
-	this->id = XIO::ReadUns32_LE( file );
-	this->oldSize = XIO::ReadUns32_LE( file ) + 8;
+	// the header is already read, the file is at header.pos + header.length
+	this->oldPos = header.pos;
+	this->id = header.id;
+	this->oldSize = (XMP_Int64)header.size + 8;
 
 	// Make sure the size is within expected bounds.
 	XMP_Int64 chunkEnd = this->oldPos + this->oldSize;
@@ -196,7 +206,7 @@ Chunk::Chunk( ContainerChunk* _parent, RIFF_MetaHandler* handler, bool skip, Chu
 	this->newSize = this->oldSize;
 	this->needSizeFix = false;
 
-	if ( skip ) file->Seek ( (this->oldSize - 8), kXMP_SeekFromCurrent );
+	if ( skip ) file->Seek ( (this->oldPos + this->oldSize), kXMP_SeekFromStart );
 
 	// "good parenting", essential for latter destruction.
 	if ( this->parent != NULL )
@@ -255,7 +265,7 @@ ContainerChunk::ContainerChunk( ContainerChunk* parent, XMP_Uns32 id, XMP_Uns32
 }
 
 // b) parsing
-ContainerChunk::ContainerChunk( ContainerChunk* parent, RIFF_MetaHandler* handler ) : Chunk( parent, handler, false, chunk_CONTAINER )
+ContainerChunk::ContainerChunk( ContainerChunk* parent, RIFF_MetaHandler* handler, const ChunkHeader& header ) : Chunk( parent, handler, header, false, chunk_CONTAINER )
 {
 	bool repairMode = ( 0 != ( handler->parent->openFlags & kXMPFiles_OpenRepairFile ));
 
@@ -265,7 +275,10 @@ ContainerChunk::ContainerChunk( ContainerChunk* parent, RIFF_MetaHandler* handle
 		XMP_Uns8 level = handler->level;
 
 		// get type of container chunk
-		this->containerType = XIO::ReadUns32_LE( file );
+		if ( header.length == 12 )
+			this->containerType = header.type;
+		else
+			this->containerType = XIO::ReadUns32_LE( file ); // throws, the chunk is cut short
 
 		// ensure legality of top-level chunks
 		if ( level == 0 && handler->riffChunks.size() > 0 )
@@ -296,16 +309,18 @@ ContainerChunk::ContainerChunk( ContainerChunk* parent, RIFF_MetaHandler* handle
 		if ( hasSubChunks )
 		{
 			handler->level++;
-			while ( file->Offset() < endOfChunk )
+			XMP_Int64 childEnd = this->oldPos + 12;
+			while ( childEnd < endOfChunk )
 			{
 				curChild = RIFF::getChunk( this, handler );
+				childEnd = curChild->oldPos + curChild->oldSize; // the constructors leave the file there
 
 				// digest pad byte - no value validation (0), since some 3rd party files have non-0-padding.
-				if ( file->Offset() % 2 == 1 )
+				if ( childEnd % 2 == 1 )
 				{
 					// [1521093] tolerate missing pad byte at very end of file:
 					XMP_Uns8 pad;
-					file->Read ( &pad, 1 );  // Read the pad, tolerate being at EOF.
+					childEnd += file->Read ( &pad, 1 );  // Read the pad, tolerate being at EOF.
 
 				}
 
@@ -346,7 +361,7 @@ ContainerChunk::ContainerChunk( ContainerChunk* parent, RIFF_MetaHandler* handle
 		}
 		else // skip non-interest container chunk
 		{
-			file->Seek ( (this->oldSize - 8 - 4), kXMP_SeekFromCurrent );
+			file->Seek ( endOfChunk, kXMP_SeekFromStart );
 		} // if - else
 
 	} // try
@@ -696,12 +711,14 @@ XMPChunk::XMPChunk( ContainerChunk* parent ) : Chunk( parent, chunk_XMP , kChunk
 }
 
 // b) parse
-XMPChunk::XMPChunk( ContainerChunk* parent, RIFF_MetaHandler* handler ) : Chunk( parent, handler, false, chunk_XMP )
+XMPChunk::XMPChunk( ContainerChunk* parent, RIFF_MetaHandler* handler, const ChunkHeader& header ) : Chunk( parent, handler, header, false, chunk_XMP )
 {
 	chunkType = chunk_XMP;
 	XMP_IO* file = handler->parent->ioRef;
 	XMP_Uns8 level = handler->level;
 
+	file->Seek ( (this->oldPos + 8), kXMP_SeekFromStart );
+
 	handler->packetInfo.offset = this->oldPos + 8;
 	handler->packetInfo.length = (XMP_Int32) this->oldSize - 8;
 
@@ -743,12 +760,14 @@ ValueChunk::ValueChunk( ContainerChunk* parent, std::string value, XMP_Uns32 id
 }
 
 // b) parsing
-ValueChunk::ValueChunk( ContainerChunk* parent, RIFF_MetaHandler* handler ) : Chunk( parent, handler, false, chunk_VALUE )
+ValueChunk::ValueChunk( ContainerChunk* parent, RIFF_MetaHandler* handler, const ChunkHeader& header ) : Chunk( parent, handler, header, false, chunk_VALUE )
 {
 	// set value: -----------------
 	XMP_IO* file = handler->parent->ioRef;
 	XMP_Uns8 level = handler->level;
 
+	file->Seek ( (this->oldPos + 8), kXMP_SeekFromStart );
+
 	// unless changed through reconciliation, assume for now.
 	// IMPORTANT to stay true to the original (no \0 cleanup or similar)
 	// since unknown value chunks might not be fully understood,
@@ -858,7 +877,7 @@ JunkChunk::JunkChunk( ContainerChunk* parent, XMP_Int64 size ) : Chunk( parent,
 }
 
 // b) parsing
-JunkChunk::JunkChunk( ContainerChunk* parent, RIFF_MetaHandler* handler ) : Chunk( parent, handler, true, chunk_JUNK )
+JunkChunk::JunkChunk( ContainerChunk* parent, RIFF_MetaHandler* handler, const ChunkHeader& header ) : Chunk( parent, handler, header, true, chunk_JUNK )
 {
 	chunkType = chunk_JUNK;
 }
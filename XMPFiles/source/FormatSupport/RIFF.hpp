@@ -210,6 +210,16 @@ namespace RIFF {
 	#pragma pack ( pop )
 #endif //#if SUNOS_SPARC || SUNOS_X86
 
+	// the id, size and (for containers) type of a chunk, read in one go by getChunk
+	// and handed to the parsing constructors. Only the header is read for chunks
+	// of no interest, e.g. LIST:movi, idx1 and the AVIX segments' payloads.
+	struct ChunkHeader {
+		XMP_Int64	pos;		// file position of the chunk
+		XMP_Uns32	id, size;	// size as in the file, EXCLUDING the 8 header bytes
+		XMP_Uns32	type;		// the container type, only valid if length is 12
+		XMP_Uns32	length;		// number of header bytes read, 8 or 12
+	};
+
 	// static getter, determines appropriate chunkType (peeking)and returns
 	// the respective constructor. It's the caller's responsibility to
 	// delete obtained chunk.
@@ -232,7 +242,7 @@ namespace RIFF {
 
 		// Constructors ///////////////////////
 		// parsing
-		Chunk( ContainerChunk* parent, RIFF_MetaHandler* handler, bool skip, ChunkType c /*= chunk_GENERAL*/ );
+		Chunk( ContainerChunk* parent, RIFF_MetaHandler* handler, const ChunkHeader& header, bool skip, ChunkType c /*= chunk_GENERAL*/ );
 		// ad-hoc creation
 		Chunk( ContainerChunk* parent, ChunkType c, XMP_Uns32 id );
 
@@ -250,7 +260,7 @@ namespace RIFF {
 	{
 	public:
 		XMPChunk( ContainerChunk* parent );
-		XMPChunk( ContainerChunk* parent, RIFF_MetaHandler* handler );
+		XMPChunk( ContainerChunk* parent, RIFF_MetaHandler* handler, const ChunkHeader& header );
 
 		void changesAndSize( RIFF_MetaHandler* handler );
 		void write( RIFF_MetaHandler* handler, XMP_IO* file, bool isMainChunk = false );
@@ -267,7 +277,7 @@ namespace RIFF {
 		ValueChunk( ContainerChunk* parent, std::string value, XMP_Uns32 id );
 
 		// for parsing
-		ValueChunk( ContainerChunk* parent, RIFF_MetaHandler* handler );
+		ValueChunk( ContainerChunk* parent, RIFF_MetaHandler* handler, const ChunkHeader& header );
 
 		enum { kNULisOptional = true };
 
@@ -285,7 +295,7 @@ namespace RIFF {
 		// construction
 		JunkChunk( ContainerChunk* parent, XMP_Int64 size );
 		// parsing
-		JunkChunk( ContainerChunk* parent, RIFF_MetaHandler* handler );
+		JunkChunk( ContainerChunk* parent, RIFF_MetaHandler* handler, const ChunkHeader& header );
 
 		// own destructor not needed.
 
@@ -305,7 +315,7 @@ namespace RIFF {
 		// construct
 		ContainerChunk( ContainerChunk* parent, XMP_Uns32 id, XMP_Uns32 containerType );
 		// parse
-		ContainerChunk( ContainerChunk* parent, RIFF_MetaHandler* handler );
+		ContainerChunk( ContainerChunk* parent, RIFF_MetaHandler* handler, const ChunkHeader& header );
 
 		bool removeValue( XMP_Uns32	id );
 
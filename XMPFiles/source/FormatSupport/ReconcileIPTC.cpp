@@ -382,12 +382,12 @@ void PhotoDataUtils::Import2WayIPTC ( const IPTC_Manager & iptc, SXMPMeta * xmp,
 		const DataSetCharacteristics & thisDS = kKnownDataSets[i];
 		if ( thisDS.mapForm >= kIPTC_Map3Way ) continue;	// The mapping is handled elsewhere, or not at all.
 		
-		bool haveXMP = xmp->DoesPropertyExist ( thisDS.xmpNS, thisDS.xmpProp );
-		newCount = PhotoDataUtils::GetNativeInfo ( iptc, thisDS.dsNum, iptcDigestState, haveXMP, &newInfo );
+		newCount = PhotoDataUtils::GetNativeInfo ( iptc, thisDS.dsNum, iptcDigestState, false /* unused */, &newInfo );
 		if ( ( newCount == 0 ) || ( newInfo.dataLen == 0 ) ) continue;	// GetNativeInfo returns 0 for ignored local text.
 																		// For no data in dataset, don't import or delete anything
 		if ( iptcDigestState == kDigestMissing  || iptcDigestState == kDigestMatches ) {
-			if ( haveXMP ) continue;	// Keep the existing XMP.
+			// ! Only look for the XMP here, most DataSets are absent and each look is a trip into XMPCore.
+			if ( xmp->DoesPropertyExist ( thisDS.xmpNS, thisDS.xmpProp ) ) continue;	// Keep the existing XMP.
 		} else if ( ! PhotoDataUtils::IsValueDifferent ( iptc, oldIPTC, thisDS.dsNum ) ) {
 			continue;	// Don't import values that match the previous export.
 		}
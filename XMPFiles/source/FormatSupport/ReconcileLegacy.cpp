@@ -98,6 +98,63 @@ void ImportPhotoData ( const TIFF_Manager & exif,
 
 }	// ImportPhotoData
 
+// =================================================================================================
+// XMPIsAuthoritative
+// ==================
+//
+// A compliant writer sets xmp:MetadataDate and the Exif DateTime (xmp:ModifyDate) together, and
+// sets the IPTC digest whenever it writes the IPTC. If both are consistent the IPTC holds nothing
+// that is not already in the XMP. The Exif time has no zone, CompareDateTime then uses the
+// MetadataDate's clock time. Fractional seconds are ignored, writers often drop them.
+
+bool XMPIsAuthoritative ( const TIFF_Manager & exif,
+						  int                  iptcDigestState,
+						  const SXMPMeta &     xmp,
+						  XMP_OptionBits       options /* = 0 */ )
+{
+	if ( ! XMP_OptionIsSet ( options, k2XMP_FileHadXMP ) ) return false;
+	if ( XMP_OptionIsSet ( options, k2XMP_FileHadIPTC ) && (iptcDigestState != kDigestMatches) ) return false;
+
+	XMP_DateTime metadataDate;
+	if ( ! xmp.GetProperty_Date ( kXMP_NS_XMP, "MetadataDate", &metadataDate, 0 ) ) return false;
+	if ( ! metadataDate.hasDate ) return false;
+
+	if ( XMP_OptionIsSet ( options, k2XMP_FileHadExif ) ) {
+
+		TIFF_Manager::TagInfo dateInfo;
+		bool found = exif.GetTag ( kTIFF_PrimaryIFD, kTIFF_DateTime, &dateInfo );
+		if ( (! found) || (dateInfo.type != kTIFF_ASCIIType) || (dateInfo.count != 20) ) return false;
+
+		const char * dateStr = (const char *) dateInfo.dataPtr;	// "YYYY:MM:DD HH:MM:SS"
+		for ( size_t i = 0; i < 19; ++i ) {
+			if ( (i == 4) || (i == 7) || (i == 13) || (i == 16) ) {
+				if ( dateStr[i] != ':' ) return false;
+			} else if ( i == 10 ) {
+				if ( dateStr[i] != ' ' ) return false;
+			} else if ( (dateStr[i] < '0') || (dateStr[i] > '9') ) {
+				return false;	// Blanks mean unknown, can't tell which is newer.
+			}
+		}
+
+		XMP_DateTime exifDate;
+		exifDate.year   = (dateStr[0]-'0')*1000 + (dateStr[1]-'0')*100 + (dateStr[2]-'0')*10 + (dateStr[3]-'0');
+		exifDate.month  = (dateStr[5]-'0')*10 + (dateStr[6]-'0');
+		exifDate.day    = (dateStr[8]-'0')*10 + (dateStr[9]-'0');
+		exifDate.hour   = (dateStr[11]-'0')*10 + (dateStr[12]-'0');
+		exifDate.minute = (dateStr[14]-'0')*10 + (dateStr[15]-'0');
+		exifDate.second = (dateStr[17]-'0')*10 + (dateStr[18]-'0');
+		exifDate.hasDate = exifDate.hasTime = true;
+
+		metadataDate.nanoSecond = 0;
+		if ( ! metadataDate.hasTime ) return false;
+		if ( SXMPUtils::CompareDateTime ( metadataDate, exifDate ) < 0 ) return false;
+
+	}
+
+	return true;
+
+}	// XMPIsAuthoritative
+
 // =================================================================================================
 // ExportPhotoData
 // ===============
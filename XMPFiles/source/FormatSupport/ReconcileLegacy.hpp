@@ -42,6 +42,17 @@ extern void ImportPhotoData ( const TIFF_Manager & exif,
 							  SXMPMeta *		   xmp,
 							  XMP_OptionBits	   options = 0 );
 
+// XMPIsAuthoritative tells if a read-only open with kXMPFiles_OpenFastRead can leave the IPTC out
+// of ImportPhotoData, neither parsing nor importing it. The caller must have parsed the XMP without
+// errors. The XMP is taken over the IPTC if the IPTC digest matches (or there is no IPTC) and
+// xmp:MetadataDate is not older than the Exif DateTime. A file with Exif but no DateTime always
+// gets the full import. The Exif itself is still imported, ExportPhotoData keeps it out of the XMP.
+
+extern bool XMPIsAuthoritative ( const TIFF_Manager & exif,
+								 int                  iptcDigestState,
+								 const SXMPMeta &     xmp,
+								 XMP_OptionBits       options = 0 );
+
 // ExportPhotoData exports XMP into TIFF/Exif and IPTC metadata for JPEG, TIFF, and Photoshop files.
 
 extern void ExportPhotoData ( XMP_FileFormat destFormat,
@@ -99,182 +99,243 @@ XMP_Uns32 SWF_IO::NextTagOffset ( const SWF_IO::TagInfo & info ) {
 
 // =================================================================================================
 
-static inline void AppendData ( RawDataBlock * dataOut, XMP_Uns8 * buffer, size_t count ) {
+bool SWF_IO::ReadTagInfo ( SWF_IO::StreamReader & swfStream, SWF_IO::TagInfo * info ) {
 
-	size_t prevSize = dataOut->size();	// ! Don't save a pointer, there might be a reallocation.
-	dataOut->insert ( dataOut->end(), count, 0 );	// Add space to the RawDataBlock.
-	memcpy ( &((*dataOut)[prevSize]), buffer, count );
+	XMP_Uns8 tagHeader [6];
+	
+	info->tagOffset = swfStream.Offset();
+	if ( swfStream.Read ( &tagHeader[0], 2 ) < 2 ) return false;	// The minimum empty tag is a 2 byte header.
+	
+	XMP_Uns16 tagAndLength = GetUns16LE ( &tagHeader[0] );
+
+	info->tagID = tagAndLength >> 6;
+	info->contentLength = tagAndLength & SWF_IO::TagLengthMask;
+	
+	if ( info->contentLength != SWF_IO::TagLengthMask ) {
+		info->hasLongHeader = false;
+	} else {
+		if ( swfStream.Read ( &tagHeader[2], 4 ) < 4 ) return false;	// Make sure there is room for the extended length.
+		info->contentLength = GetUns32LE ( &tagHeader[2] );
+		info->hasLongHeader = true;
+	}
+	
+	return true;
 
-}	// AppendData
+}	// SWF_IO::ReadTagInfo
 
 // =================================================================================================
 
-XMP_Int64 SWF_IO::DecompressFileToMemory ( XMP_IO * fileIn, RawDataBlock * dataOut ) {
+static const size_t kStreamBufferSize = 64*1024;
 
-	fileIn->Rewind();
-	dataOut->clear();
+// =================================================================================================
+
+SWF_IO::StreamReader::StreamReader ( XMP_IO * _fileIn )
+	: fileIn(_fileIn), compressed(false), atEnd(false), offset(0)
+{
+	memset ( &this->zipState, 0, sizeof(this->zipState) );
+
+	const XMP_Int64 lengthIn = this->fileIn->Length();
+	XMP_Enforce ( ((XMP_Int64)SWF_IO::HeaderPrefixSize <= lengthIn) && (lengthIn <= SWF_IO::MaxExpandedSize) );
+
+	this->fileIn->Rewind();
+	this->fileIn->ReadAll ( this->prefix, SWF_IO::HeaderPrefixSize );
+
+	XMP_Uns32 signature = GetUns32LE ( &this->prefix[0] ) & 0xFFFFFF;	// Discard the version byte.
+	this->compressed = (signature == SWF_IO::CompressedSignature);
 	
-	static const size_t bufferSize = 64*1024;
-	XMP_Uns8 bufferIn  [ bufferSize ];
-	XMP_Uns8 bufferOut [ bufferSize ];
+	if ( this->compressed ) {
+		int err = inflateInit ( &this->zipState );
+		XMP_Enforce ( err == Z_OK );
+		this->bufferIn.assign ( kStreamBufferSize, 0 );
+	}
 
-	int err;
-	z_stream zipState;
-	memset ( &zipState, 0, sizeof(zipState) );
-	err = inflateInit ( &zipState );
-	XMP_Enforce ( err == Z_OK );
+}	// SWF_IO::StreamReader::StreamReader
+
+// =================================================================================================
+
+SWF_IO::StreamReader::~StreamReader() {
+
+	if ( this->compressed ) inflateEnd ( &this->zipState );
+
+}	// SWF_IO::StreamReader::~StreamReader
+
+// =================================================================================================
+
+XMP_Uns32 SWF_IO::StreamReader::Read ( void * dataOut, XMP_Uns32 count ) {
+
+	XMP_Uns8 * bytesOut = (XMP_Uns8*)dataOut;
+	XMP_Uns32 done = 0;
 	
-	XMP_Int32 ioCount;
-	XMP_Int64 offsetIn;
-	const XMP_Int64 lengthIn = fileIn->Length();
-	XMP_Enforce ( ((XMP_Int64)SWF_IO::HeaderPrefixSize <= lengthIn) && (lengthIn <= SWF_IO::MaxExpandedSize) );
+	// The header prefix is never compressed, it was read when the stream was opened.
 	
-	// Set the uncompressed part of the header. Save the expanded size from the file.
+	for ( ; (done < count) && (this->offset < SWF_IO::HeaderPrefixSize); ++done, ++this->offset ) {
+		bytesOut[done] = this->prefix[this->offset];
+	}
 	
-	fileIn->ReadAll ( bufferIn, SWF_IO::HeaderPrefixSize );
-	offsetIn = SWF_IO::HeaderPrefixSize;
-	XMP_Uns32 expectedFullSize = GetUns32LE ( &bufferIn[4] );
-
-	AppendData ( dataOut, bufferIn, SWF_IO::HeaderPrefixSize );	// Copy the compressed stream's prefix.
-	PutUns32LE ( SWF_IO::ExpandedSignature, &(*dataOut)[0] );	// Change the signature.
-	(*dataOut)[3] = bufferIn[3];	// Keep the SWF version.
+	if ( done == count ) return done;
 	
-	// Read the input file, feed it to the decompression engine, writing as needed.
-
-	zipState.next_out  = &bufferOut[0];	// Initial output conditions. Must be set before the input loop!
-	zipState.avail_out = bufferSize;
+	if ( ! this->compressed ) {
+		XMP_Uns32 ioCount = this->fileIn->Read ( &bytesOut[done], (count - done) );
+		this->offset += ioCount;
+		return done + ioCount;
+	}
 	
-	while ( offsetIn < lengthIn ) {
+	// Inflate directly into the caller's buffer, reading more input as needed. A truncated stream
+	// just ends early, as when the whole file was expanded to memory.
 	
-		// Read the next chunk of input.
-		ioCount = fileIn->Read ( bufferIn, bufferSize );
-		XMP_Enforce ( ioCount > 0 );
-		offsetIn += ioCount;
-		zipState.next_in  = &bufferIn[0];
-		zipState.avail_in = ioCount;
-		
-		// Process all of this input, writing as needed.
-		
-		err = Z_OK;
-		while ( (zipState.avail_in > 0) && (err == Z_OK) ) {
-
-			XMP_Assert ( zipState.avail_out > 0 );	// Sanity check for output buffer space.
-			err = inflate ( &zipState, Z_NO_FLUSH );
-			XMP_Enforce ( (err == Z_OK) || (err == Z_STREAM_END) );
+	this->zipState.next_out  = &bytesOut[done];
+	this->zipState.avail_out = count - done;
+	
+	while ( (this->zipState.avail_out > 0) && (! this->atEnd) ) {
 
-			if ( zipState.avail_out == 0 ) {
-				AppendData ( dataOut, bufferOut, bufferSize );
-				zipState.next_out  = &bufferOut[0];
-				zipState.avail_out = bufferSize;
+		if ( this->zipState.avail_in == 0 ) {
+			XMP_Uns32 ioCount = this->fileIn->Read ( &this->bufferIn[0], (XMP_Uns32)kStreamBufferSize );
+			if ( ioCount == 0 ) {
+				this->atEnd = true;
+				break;
 			}
-
+			this->zipState.next_in  = &this->bufferIn[0];
+			this->zipState.avail_in = ioCount;
 		}
-	
+
+		int err = inflate ( &this->zipState, Z_NO_FLUSH );
+		XMP_Enforce ( (err == Z_OK) || (err == Z_STREAM_END) );
+		if ( err == Z_STREAM_END ) this->atEnd = true;
+
 	}
 	
-	// Finish the decompression and write the final output.
+	XMP_Uns32 ioCount = (count - done) - this->zipState.avail_out;
+	this->offset += ioCount;
+	return done + ioCount;
 
-	do {
+}	// SWF_IO::StreamReader::Read
 
-		ioCount = bufferSize - zipState.avail_out;	// Make sure there is room for inflate to do more.
-		if ( ioCount > 0 ) {
-			AppendData ( dataOut, bufferOut, ioCount );
-			zipState.next_out  = &bufferOut[0];
-			zipState.avail_out = bufferSize;
-		}
+// =================================================================================================
 
-		err = inflate ( &zipState, Z_NO_FLUSH );
-		XMP_Enforce ( (err == Z_OK) || (err == Z_STREAM_END) || (err == Z_BUF_ERROR) );
+XMP_Uns32 SWF_IO::StreamReader::Skip ( XMP_Uns32 count ) {
+	
+	if ( (! this->compressed) && (this->offset >= SWF_IO::HeaderPrefixSize) ) {
+		XMP_Int64 spaceLeft = this->fileIn->Length() - this->offset;
+		if ( (XMP_Int64)count > spaceLeft ) count = (XMP_Uns32)spaceLeft;
+		this->fileIn->Seek ( count, kXMP_SeekFromCurrent );
+		this->offset += count;
+		return count;
+	}
+	
+	// Compressed data has to be inflated to get past it, it just is not kept.
+	
+	XMP_Uns8 buffer [4*1024];
+	XMP_Uns32 done = 0;
+	
+	while ( done < count ) {
+		XMP_Uns32 ioCount = count - done;
+		if ( ioCount > sizeof(buffer) ) ioCount = sizeof(buffer);
+		XMP_Uns32 readCount = this->Read ( buffer, ioCount );
+		done += readCount;
+		if ( readCount < ioCount ) break;
+	}
 
-	} while ( err == Z_OK );
+	return done;
 
-	ioCount = bufferSize - zipState.avail_out;	// Write any final output.
-	if ( ioCount > 0 ) {
-		AppendData ( dataOut, bufferOut, ioCount );
-		zipState.next_out  = &bufferOut[0];
-		zipState.avail_out = bufferSize;
-	}
+}	// SWF_IO::StreamReader::Skip
 
-	// Done. Make sure the file header has the true decompressed size.
-	
-	XMP_Int64 lengthOut = zipState.total_out + SWF_IO::HeaderPrefixSize;
-	if ( lengthOut != expectedFullSize ) PutUns32LE ( (XMP_Uns32)lengthOut, &((*dataOut)[4]) );
-	inflateEnd ( &zipState );
-	return lengthOut;
+// =================================================================================================
+
+SWF_IO::StreamWriter::StreamWriter ( XMP_IO * _fileOut, bool compress )
+	: fileOut(_fileOut), compressed(compress), offset(0)
+{
+	memset ( &this->zipState, 0, sizeof(this->zipState) );
 	
-}	// SWF_IO::DecompressFileToMemory
+	if ( this->compressed ) {
+		int err = deflateInit ( &this->zipState, Z_DEFAULT_COMPRESSION );
+		XMP_Enforce ( err == Z_OK );
+		this->bufferOut.assign ( kStreamBufferSize, 0 );
+		this->zipState.next_out  = &this->bufferOut[0];
+		this->zipState.avail_out = (uInt)kStreamBufferSize;
+	}
+
+}	// SWF_IO::StreamWriter::StreamWriter
 
 // =================================================================================================
 
-XMP_Int64 SWF_IO::CompressMemoryToFile ( const RawDataBlock & dataIn, XMP_IO*  fileOut ) {
+SWF_IO::StreamWriter::~StreamWriter() {
 
-	fileOut->Rewind();
-	fileOut->Truncate ( 0 );
-	
-	static const size_t bufferSize = 64*1024;
-	XMP_Uns8 bufferOut [ bufferSize ];
+	if ( this->compressed ) deflateEnd ( &this->zipState );
 
-	int err;
-	z_stream zipState;
-	memset ( &zipState, 0, sizeof(zipState) );
-	err = deflateInit ( &zipState, Z_DEFAULT_COMPRESSION );
-	XMP_Enforce ( err == Z_OK );
+}	// SWF_IO::StreamWriter::~StreamWriter
+
+// =================================================================================================
+
+void SWF_IO::StreamWriter::Write ( const void * dataIn, XMP_Uns32 count ) {
+
+	const XMP_Uns8 * bytesIn = (const XMP_Uns8*)dataIn;
 	
-	XMP_Int32 ioCount;
-	const size_t lengthIn = dataIn.size();
-	XMP_Enforce ( SWF_IO::HeaderPrefixSize <= lengthIn );
+	// Write the header prefix and any uncompressed data as is.
+
+	if ( this->offset < SWF_IO::HeaderPrefixSize ) {
+		XMP_Uns32 prefixCount = SWF_IO::HeaderPrefixSize - this->offset;
+		if ( prefixCount > count ) prefixCount = count;
+		this->fileOut->Write ( bytesIn, prefixCount );
+		this->offset += prefixCount;
+		bytesIn += prefixCount;
+		count -= prefixCount;
+	}
 	
-	// Write the uncompressed part of the file header.
+	if ( count == 0 ) return;
+	this->offset += count;
 	
-	PutUns32LE ( SWF_IO::CompressedSignature, &bufferOut[0] );
-	bufferOut[3] = dataIn[3];	// Copy the SWF version.
-	PutUns32LE ( (XMP_Uns32)lengthIn, &bufferOut[4] );
-	fileOut->Write ( bufferOut, SWF_IO::HeaderPrefixSize );
+	if ( ! this->compressed ) {
+		this->fileOut->Write ( bytesIn, count );
+		return;
+	}
 	
-	// Feed the input to the compression engine in one step, write the output as available.
+	// Feed the input to the compression engine, write the output as available.
 
-	zipState.next_in   = (Bytef*)&dataIn[SWF_IO::HeaderPrefixSize];
-	zipState.avail_in  = (XMP_Uns32)lengthIn - SWF_IO::HeaderPrefixSize;
-	zipState.next_out  = &bufferOut[0];
-	zipState.avail_out = bufferSize;
+	this->zipState.next_in  = (Bytef*)bytesIn;
+	this->zipState.avail_in = count;
 	
-	while ( zipState.avail_in > 0 ) {
+	while ( this->zipState.avail_in > 0 ) {
 
-		XMP_Assert ( zipState.avail_out > 0 );	// Sanity check for output buffer space.
-		err = deflate ( &zipState, Z_NO_FLUSH );
+		XMP_Assert ( this->zipState.avail_out > 0 );	// Sanity check for output buffer space.
+		int err = deflate ( &this->zipState, Z_NO_FLUSH );
 		XMP_Enforce ( err == Z_OK );
 
-		if ( zipState.avail_out == 0 ) {
-			fileOut->Write ( bufferOut, bufferSize );
-			zipState.next_out  = &bufferOut[0];
-			zipState.avail_out = bufferSize;
+		if ( this->zipState.avail_out == 0 ) {
+			this->fileOut->Write ( &this->bufferOut[0], (XMP_Uns32)kStreamBufferSize );
+			this->zipState.next_out  = &this->bufferOut[0];
+			this->zipState.avail_out = (uInt)kStreamBufferSize;
 		}
 
 	}
+
+}	// SWF_IO::StreamWriter::Write
+
+// =================================================================================================
+
+XMP_Uns32 SWF_IO::StreamWriter::Finish() {
+
+	if ( ! this->compressed ) return this->offset;
 	
 	// Finish the compression and write the final output.
 
+	int err;
 	do {
 
-		err = deflate ( &zipState, Z_FINISH );
+		err = deflate ( &this->zipState, Z_FINISH );
 		XMP_Enforce ( (err == Z_OK) || (err == Z_STREAM_END) );
-		ioCount = bufferSize - zipState.avail_out;	// See if there is output to write.
+		XMP_Uns32 ioCount = (XMP_Uns32)kStreamBufferSize - this->zipState.avail_out;	// See if there is output to write.
 
 		if ( ioCount > 0 ) {
-			fileOut->Write ( bufferOut, ioCount );
-			zipState.next_out  = &bufferOut[0];
-			zipState.avail_out = bufferSize;
+			this->fileOut->Write ( &this->bufferOut[0], ioCount );
+			this->zipState.next_out  = &this->bufferOut[0];
+			this->zipState.avail_out = (uInt)kStreamBufferSize;
 		}
 
 	} while ( err != Z_STREAM_END );
 
-	// Done.
-	
-	XMP_Int64 lengthOut = zipState.total_out;
-	deflateEnd ( &zipState );
-	return lengthOut;
-	
-}	// SWF_IO::CompressMemoryToFile
+	return this->offset;
+
+}	// SWF_IO::StreamWriter::Finish
 
 // =================================================================================================
 
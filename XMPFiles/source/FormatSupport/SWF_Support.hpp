@@ -78,8 +78,62 @@ namespace SWF_IO {
 	XMP_Uns32 ContentOffset ( const TagInfo & info );
 	XMP_Uns32 NextTagOffset ( const TagInfo & info );
 	
-	XMP_Int64 DecompressFileToMemory ( XMP_IO * fileIn, RawDataBlock * dataOut );
-	XMP_Int64 CompressMemoryToFile ( const RawDataBlock & dataIn, XMP_IO*  fileOut );
+	// The expanded SWF stream is processed sequentially, a compressed file is inflated or deflated
+	// as it goes. Offsets are within the expanded stream, the 8 byte header prefix is never
+	// compressed and is passed through unchanged.
+
+	class StreamReader {
+	public:
+
+		StreamReader ( XMP_IO * fileIn );	// Rewinds the file and reads the header prefix.
+		~StreamReader();
+
+		bool IsCompressed() const { return this->compressed; };
+		XMP_Uns32 Offset() const { return this->offset; };
+
+		// Both return the number of bytes consumed, which is less than count at the end of the stream.
+		XMP_Uns32 Read ( void * dataOut, XMP_Uns32 count );
+		XMP_Uns32 Skip ( XMP_Uns32 count );
+
+	private:
+
+		XMP_IO * fileIn;
+		bool compressed, atEnd;
+		XMP_Uns32 offset;
+		XMP_Uns8 prefix [HeaderPrefixSize];
+		z_stream zipState;
+		RawDataBlock bufferIn;
+
+		StreamReader ( const StreamReader & );	// Hidden on purpose.
+		StreamReader & operator= ( const StreamReader & );
+
+	};
+
+	class StreamWriter {
+	public:
+
+		StreamWriter ( XMP_IO * fileOut, bool compress );	// Writes from the current file position.
+		~StreamWriter();
+
+		void Write ( const void * dataIn, XMP_Uns32 count );
+		XMP_Uns32 Finish();	// Flushes any compressed output, returns the expanded stream length.
+
+	private:
+
+		XMP_IO * fileOut;
+		bool compressed;
+		XMP_Uns32 offset;
+		z_stream zipState;
+		RawDataBlock bufferOut;
+
+		StreamWriter ( const StreamWriter & );	// Hidden on purpose.
+		StreamWriter & operator= ( const StreamWriter & );
+
+	};
+
+	// Read a tag header from the stream, leaving it positioned at the content. Returns false at the
+	// end of the stream, or if the header is incomplete. The content length is not checked.
+	bool ReadTagInfo ( StreamReader & swfStream, TagInfo * info );
 	
 };	// SWF_IO
 
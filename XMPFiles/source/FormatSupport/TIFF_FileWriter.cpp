@@ -25,6 +25,9 @@
 /// key and InternalTagInfo as the value. There are 5 of these maps, one for each of the recognized
 /// IFDs. The maps contain an entry for each tag in the IFD, whether we capture the data or not. The
 /// dataPtr and dataLen fields in the InternalTagInfo are zero if the tag is not captured.
+///
+/// A file parse can defer the recognized large values, see ParseFileStream. Those tags have a null
+/// dataPtr and the deferred flag set until FindTagInIFD or GetIFD first reads them from the file.
 // =================================================================================================
 
 // =================================================================================================
@@ -36,7 +39,8 @@
 // since JPEG and PSD files are big endian overall.
 
 TIFF_FileWriter::TIFF_FileWriter() : changed(false), legacyDeleted(false), memParsed(false),
-									 fileParsed(false), ownedStream(false), memStream(0), tiffLength(0)
+									 fileParsed(false), ownedStream(false), memStream(0), tiffLength(0),
+									 deferredFile(0)
 {
 
 	XMP_Uns8 bogusTIFF [kEmptyTIFFLength];
@@ -77,6 +81,7 @@ void TIFF_FileWriter::DeleteExistingInfo()
 	if ( this->ownedStream ) free ( this->memStream );	// ! Current TIFF might be memory-parsed.
 	this->memStream = 0;
 	this->tiffLength = 0;
+	this->deferredFile = 0;
 
 	for ( int ifd = 0; ifd < kTIFF_KnownIFDCount; ++ifd ) this->containedIFDs[ifd].clear();
 
@@ -111,14 +116,43 @@ XMP_Uns8 TIFF_FileWriter::PickIFD ( XMP_Uns8 ifd, XMP_Uns16 id )
 const TIFF_FileWriter::InternalTagInfo* TIFF_FileWriter::FindTagInIFD ( XMP_Uns8 ifd, XMP_Uns16 id ) const
 {
 	ifd = PickIFD ( ifd, id );
-	const InternalTagMap& currIFD = this->containedIFDs[ifd].tagMap;
+	InternalTagMap& currIFD = this->containedIFDs[ifd].tagMap;
 
-	InternalTagMap::const_iterator tagPos = currIFD.find ( id );
+	InternalTagMap::iterator tagPos = currIFD.find ( id );
 	if ( tagPos == currIFD.end() ) return 0;
+	if ( tagPos->second.deferred ) this->LoadDeferredValue ( &tagPos->second );
 	return &tagPos->second;
 
 }	// TIFF_FileWriter::FindTagInIFD
 
+// =================================================================================================
+// TIFF_FileWriter::LoadDeferredValue
+// ==================================
+//
+// Read a large value skipped by a deferred ParseFileStream. The stream offset and length were
+// checked by ProcessFileIFD. A failed read throws and leaves the tag deferred.
+
+void TIFF_FileWriter::LoadDeferredValue ( InternalTagInfo* tagInfo ) const
+{
+	XMP_Assert ( tagInfo->deferred && (tagInfo->dataPtr == 0) && (tagInfo->dataLen > 4) );
+	XMP_Assert ( this->fileParsed && (this->deferredFile != 0) );
+
+	XMP_Uns8* dataPtr = (XMP_Uns8*) malloc ( tagInfo->dataLen );
+	if ( dataPtr == 0 ) XMP_Throw ( "No data block", kXMPErr_NoMemory );
+
+	try {
+		this->deferredFile->Seek ( tagInfo->origDataOffset, kXMP_SeekFromStart );
+		this->deferredFile->ReadAll ( dataPtr, tagInfo->dataLen );
+	} catch ( ... ) {
+		free ( dataPtr );
+		throw;
+	}
+
+	tagInfo->dataPtr = dataPtr;
+	tagInfo->deferred = false;
+
+}	// TIFF_FileWriter::LoadDeferredValue
+
 // =================================================================================================
 // TIFF_FileWriter::GetIFD
 // =======================
@@ -126,16 +160,17 @@ const TIFF_FileWriter::InternalTagInfo* TIFF_FileWriter::FindTagInIFD ( XMP_Uns8
 bool TIFF_FileWriter::GetIFD ( XMP_Uns8 ifd, TagInfoMap* ifdMap ) const
 {
 	if ( ifd > kTIFF_LastRealIFD ) XMP_Throw ( "Invalid IFD number", kXMPErr_BadParam );
-	const InternalTagMap& currIFD = this->containedIFDs[ifd].tagMap;
+	InternalTagMap& currIFD = this->containedIFDs[ifd].tagMap;
 
-	InternalTagMap::const_iterator tagPos = currIFD.begin();
-	InternalTagMap::const_iterator tagEnd = currIFD.end();
+	InternalTagMap::iterator tagPos = currIFD.begin();
+	InternalTagMap::iterator tagEnd = currIFD.end();
 
 	if ( ifdMap != 0 ) ifdMap->clear();
 	if ( tagPos == tagEnd ) return false;	// Empty IFD.
 
 	if ( ifdMap != 0 ) {
 		for ( ; tagPos != tagEnd; ++tagPos ) {
+			if ( tagPos->second.deferred ) this->LoadDeferredValue ( &tagPos->second );
 			const InternalTagInfo& intInfo = tagPos->second;
 			TagInfo extInfo ( intInfo.id, intInfo.type, intInfo.count, intInfo.dataPtr, intInfo.dataLen  );
 			(*ifdMap)[intInfo.id] = extInfo;
@@ -208,9 +243,10 @@ void TIFF_FileWriter::SetTag ( XMP_Uns8 ifd, XMP_Uns16 id, XMP_Uns16 type, XMP_U
 	} else {
 
 		tagPtr = &tagPos->second;
+		if ( tagPtr->deferred ) this->LoadDeferredValue ( tagPtr );
 
 		// The tag already exists, make sure the value is actually changing.
-		if ( (type == tagPtr->type) && (count == tagPtr->count) &&
+		if ( (type == tagPtr->type) && (count == tagPtr->count) && (tagPtr->dataPtr != 0) &&
 			 (memcmp ( clientPtr, tagPtr->dataPtr, tagPtr->dataLen ) == 0) ) {
 			return;	// ! The value is unchanged, exit.
 		}
@@ -756,12 +792,16 @@ XMP_Uns32 TIFF_FileWriter::ProcessMemoryIFD ( XMP_Uns32 ifdOffset, XMP_Uns8 ifd
 // part of the TIFF stream. The vast majority of real-world TIFFs have the primary IFD, Exif IFD,
 // and all of their interesting tag values within the first 64K of the file. Well, at least before
 // we get around to our edit-by-append approach.
+//
+// With deferLargeValues only the IFDs are read here. The recognized large values are read on first
+// lookup, a DNG or big TIFF opened for update never reads values that nobody asks for.
 
-void TIFF_FileWriter::ParseFileStream ( XMP_IO* fileRef )
+void TIFF_FileWriter::ParseFileStream ( XMP_IO* fileRef, bool deferLargeValues )
 {
 
 	this->DeleteExistingInfo();
 	this->fileParsed = true;
+	if ( deferLargeValues ) this->deferredFile = fileRef;
 	this->tiffLength = (XMP_Uns32) fileRef->Length();
 	if ( this->tiffLength < 8 ) return;	// Ignore empty or impossibly short.
 	fileRef->Rewind ( );
@@ -850,8 +890,8 @@ void TIFF_FileWriter::ParseFileStream ( XMP_IO* fileRef )
 
 XMP_Uns32 TIFF_FileWriter::ProcessFileIFD ( XMP_Uns8 ifd, XMP_Uns32 ifdOffset, XMP_IO* fileRef )
 {
-	static const size_t ifdBufferSize = 12*65536;	// Enough for the largest possible IFD.
-    std::vector<XMP_Uns8> ifdBuffer(ifdBufferSize);
+	XMP_Uns8 smallBuffer [12*64];	// Enough for most IFDs, avoids a heap block per IFD.
+	std::vector<XMP_Uns8> largeBuffer;
 	XMP_Uns8 intBuffer [4];	// For the IFD count and offset to next IFD.
 	
 	InternalIFDInfo& ifdInfo ( this->containedIFDs[ifd] );
@@ -867,7 +907,13 @@ XMP_Uns32 TIFF_FileWriter::ProcessFileIFD ( XMP_Uns8 ifd, XMP_Uns32 ifdOffset, X
 	XMP_Uns16 tagCount = this->GetUns16 ( intBuffer );
 	if ( tagCount >= 0x8000 ) return 0;	// Maybe wrong byte order.
 	if ( ! XIO::CheckFileSpace ( fileRef, 12*tagCount ) ) return 0;	// Bail for a truncated file.
-	fileRef->ReadAll ( &ifdBuffer[0], 12*tagCount );
+
+	XMP_Uns8* ifdBuffer = smallBuffer;
+	if ( tagCount > 64 ) {
+		largeBuffer.resize ( 12*tagCount );
+		ifdBuffer = &largeBuffer[0];
+	}
+	if ( tagCount > 0 ) fileRef->ReadAll ( ifdBuffer, 12*tagCount );
 
 	if ( ! XIO::CheckFileSpace ( fileRef, 4 ) ) {
         ifdInfo.origNextIFD = 0;	// Tolerate a trncated file, do the remaining processing.
@@ -885,7 +931,7 @@ XMP_Uns32 TIFF_FileWriter::ProcessFileIFD ( XMP_Uns8 ifd, XMP_Uns32 ifdOffset, X
 	// sorted output. Plus the "map[key] = value" assignment conveniently keeps the last encountered
 	// value, following Photoshop's behavior.
 
-	XMP_Uns8* ifdPtr = &ifdBuffer[0];	// Move to the first IFD entry.
+	XMP_Uns8* ifdPtr = ifdBuffer;	// Move to the first IFD entry.
 
 	for ( XMP_Uns16 i = 0; i < tagCount; ++i, ifdPtr += 12 ) {
 
@@ -923,7 +969,7 @@ XMP_Uns32 TIFF_FileWriter::ProcessFileIFD ( XMP_Uns8 ifd, XMP_Uns32 ifdOffset, X
 	}
 
 	// ------------------------------------------------------------------------
-	// Go back over the tag map and extract the data for large recognized tags.
+	// Go back over the tag map and extract, or defer, the data for large recognized tags.
 
 	InternalTagMap::iterator tagPos = ifdInfo.tagMap.begin();
 	InternalTagMap::iterator tagEnd = ifdInfo.tagMap.end();
@@ -939,6 +985,11 @@ XMP_Uns32 TIFF_FileWriter::ProcessFileIFD ( XMP_Uns8 ifd, XMP_Uns32 ifdOffset, X
 		while ( *knownTagPtr < currTag->id ) ++knownTagPtr;
 		if ( *knownTagPtr != currTag->id ) continue;	// Skip unrecognized tags.
 
+		if ( this->deferredFile != 0 ) {
+			currTag->deferred = true;	// The offset and length were checked above.
+			continue;
+		}
+
 		fileRef->Seek ( currTag->origDataOffset, kXMP_SeekFromStart );
 		currTag->dataPtr = (XMP_Uns8*) malloc ( currTag->dataLen );
 		if ( currTag->dataPtr == 0 ) XMP_Throw ( "No data block", kXMPErr_NoMemory );
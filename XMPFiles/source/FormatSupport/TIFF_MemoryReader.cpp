@@ -34,6 +34,10 @@
 /// \li The count field is converted to a native byte count.
 /// \li If the data is not inline the offset is converted to a pointer.
 ///
+/// The IFD entries are tweaked lazily. ParseMemoryStream only checks the IFD bounds, the entries of
+/// an IFD are looked at by the first FindTagInIFD or GetIFD for it. An IFD in tag order is searched
+/// as stored and each entry is tweaked when first found, most lookups are for a few tags.
+///
 /// The tag values, whether inline or not, are not converted to native values. The values returned
 /// from the GetTag methods are converted on the fly. The id, type, and count fields are easier to
 /// convert because their types are fixed. They are used more, and more valuable to convert.
@@ -125,13 +129,15 @@ void TIFF_MemoryReader::SortIFD ( TweakedIFDInfo* thisIFD )
 bool TIFF_MemoryReader::GetIFD ( XMP_Uns8 ifd, TagInfoMap* ifdMap ) const
 {
 	if ( ifd > kTIFF_LastRealIFD ) XMP_Throw ( "Invalid IFD requested", kXMPErr_InternalFailure );
-	const TweakedIFDInfo* thisIFD = &containedIFDs[ifd];
+	TweakedIFDInfo* thisIFD = &containedIFDs[ifd];
 
 	if ( ifdMap != 0 ) ifdMap->clear();
 	if ( thisIFD->count == 0 ) return false;
 
 	if ( ifdMap != 0 ) {
 
+		this->TweakWholeIFD ( thisIFD );
+
 		for ( size_t i = 0; i < thisIFD->count; ++i ) {
 
 			TweakedIFDEntry* thisTag = &(thisIFD->entries[i]);
@@ -162,22 +168,28 @@ const TIFF_MemoryReader::TweakedIFDEntry* TIFF_MemoryReader::FindTagInIFD ( XMP_
 	}
 
 	if ( ifd > kTIFF_LastRealIFD ) XMP_Throw ( "Invalid IFD requested", kXMPErr_InternalFailure );
-	const TweakedIFDInfo* thisIFD = &containedIFDs[ifd];
+	TweakedIFDInfo* thisIFD = &containedIFDs[ifd];
 
 	if ( thisIFD->count == 0 ) return 0;
+	if ( thisIFD->state == kIFD_Pending ) this->IndexIFD ( thisIFD );
+
+	// The IDs of entries that are not tweaked yet are still in the stream's byte order, GetEntryID
+	// takes care of that.
+
+	const bool isRaw = (thisIFD->state == kIFD_SortedRaw);
 
 	XMP_Uns32 spanLength = thisIFD->count;
-	const TweakedIFDEntry* spanBegin = &(thisIFD->entries[0]);
+	XMP_Uns32 spanBegin = 0;
 
 	while ( spanLength > 1 ) {
 
 		XMP_Uns32 halfLength = spanLength >> 1;	// Since spanLength > 1, halfLength > 0.
-		const TweakedIFDEntry* spanMiddle = spanBegin + halfLength;
+		XMP_Uns32 spanMiddle = spanBegin + halfLength;
 
 		// There are halfLength entries below spanMiddle, then the spanMiddle entry, then
 		// spanLength-halfLength-1 entries above spanMiddle (which can be none).
 
-		XMP_Uns16 middleID = GetUns16AsIs ( &spanMiddle->id );
+		XMP_Uns16 middleID = this->GetEntryID ( thisIFD, spanMiddle );
 		if ( middleID == id ) {
 			spanBegin = spanMiddle;
 			break;
@@ -190,8 +202,15 @@ const TIFF_MemoryReader::TweakedIFDEntry* TIFF_MemoryReader::FindTagInIFD ( XMP_
 
 	}
 
-	if ( GetUns16AsIs(&spanBegin->id) != id ) spanBegin = 0;
-	return spanBegin;
+	if ( this->GetEntryID ( thisIFD, spanBegin ) != id ) return 0;
+
+	TweakedIFDEntry* thisEntry = &thisIFD->entries[spanBegin];
+	if ( isRaw && (! thisIFD->IsTweaked ( spanBegin )) ) {
+		this->TweakOneEntry ( thisEntry );
+		thisIFD->SetTweaked ( spanBegin );
+	}
+
+	return thisEntry;
 
 }	// TIFF_MemoryReader::FindTagInIFD
 
@@ -543,6 +562,7 @@ void TIFF_MemoryReader::ParseMemoryStream ( const void* data, XMP_Uns32 length,
 	for ( size_t i = 0; i < kTIFF_KnownIFDCount; ++i ) {
 		this->containedIFDs[i].count = 0;
 		this->containedIFDs[i].entries = 0;
+		this->containedIFDs[i].state = kIFD_Tweaked;
 	}
 
 	if ( length == 0 ) return;
@@ -668,71 +688,121 @@ XMP_Uns32 TIFF_MemoryReader::ProcessOneIFD ( XMP_Uns32 ifdOffset, XMP_Uns8 ifd,
 
 	ifdInfo.count = ifdCount;
 	ifdInfo.entries = ifdEntries;
+	ifdInfo.state = kIFD_Pending;	// ! The entries are looked at by the first FindTagInIFD or GetIFD.
 
-	XMP_Int32 prevTag = -1;	// ! The GPS IFD has a tag 0, so we need a signed initial value.
-	bool needsSorting = false;
-	for ( size_t i = 0; i < ifdCount; ++i ) {
+	ifdPtr += (2 + ifdCount*12);
+	XMP_Uns32 nextIFDOffset = this->GetUns32 ( ifdPtr );
 
-		TweakedIFDEntry* thisEntry = &ifdEntries[i];	// Tweak the IFD entry to be more useful.
+	return nextIFDOffset;
 
-		if ( ! this->nativeEndian ) {
-			Flip2 ( &thisEntry->id );
-			Flip2 ( &thisEntry->type );
-			Flip4 ( &thisEntry->bytes );
-		}
+}	// TIFF_MemoryReader::ProcessOneIFD
+
+// =================================================================================================
+// TIFF_MemoryReader::TweakOneEntry
+// ================================
+//
+// Converts one IFD entry in place to the tweaked form, see the notes at the top of this file.
 
-		if ( GetUns16AsIs(&thisEntry->id) <= prevTag ) needsSorting = true;
-		prevTag = GetUns16AsIs ( &thisEntry->id );
+void TIFF_MemoryReader::TweakOneEntry ( TweakedIFDEntry* thisEntry ) const
+{
 
-		if ( (GetUns16AsIs(&thisEntry->type) < kTIFF_ByteType) || (GetUns16AsIs(&thisEntry->type) > kTIFF_LastType) ) continue;	// Bad type, skip this tag.
+	if ( ! this->nativeEndian ) {
+		Flip2 ( &thisEntry->id );
+		Flip2 ( &thisEntry->type );
+		Flip4 ( &thisEntry->bytes );
+	}
 
-		#if ! (SUNOS_SPARC || XMP_IOS_ARM || XMP_ANDROID_ARM)
-	
-			thisEntry->bytes *= (XMP_Uns32)kTIFF_TypeSizes[thisEntry->type];
-			if ( thisEntry->bytes > 4 ) {
-				if ( ! this->nativeEndian ) Flip4 ( &thisEntry->dataOrPos );
-				if ( (thisEntry->dataOrPos < 8) || (thisEntry->dataOrPos >= this->tiffLength) ) {
-					thisEntry->bytes = thisEntry->dataOrPos = 0;	// Make this bad tag look empty.
-				}
-				if ( thisEntry->bytes > (this->tiffLength - thisEntry->dataOrPos) ) {
-					thisEntry->bytes = thisEntry->dataOrPos = 0;	// Make this bad tag look empty.
-				}
+	if ( (GetUns16AsIs(&thisEntry->type) < kTIFF_ByteType) || (GetUns16AsIs(&thisEntry->type) > kTIFF_LastType) ) return;	// Bad type, skip this tag.
+
+	#if ! (SUNOS_SPARC || XMP_IOS_ARM || XMP_ANDROID_ARM)
+
+		thisEntry->bytes *= (XMP_Uns32)kTIFF_TypeSizes[thisEntry->type];
+		if ( thisEntry->bytes > 4 ) {
+			if ( ! this->nativeEndian ) Flip4 ( &thisEntry->dataOrPos );
+			if ( (thisEntry->dataOrPos < 8) || (thisEntry->dataOrPos >= this->tiffLength) ) {
+				thisEntry->bytes = thisEntry->dataOrPos = 0;	// Make this bad tag look empty.
 			}
-	
-		#else
-	
-			void *tempEntryByte = &thisEntry->bytes;
-			XMP_Uns32 temp = GetUns32AsIs(&thisEntry->bytes);
-			temp = temp * (XMP_Uns32)kTIFF_TypeSizes[GetUns16AsIs(&thisEntry->type)];
-			memcpy ( tempEntryByte, &temp, sizeof(thisEntry->bytes) );
-	
-			// thisEntry->bytes *= (XMP_Uns32)kTIFF_TypeSizes[thisEntry->type];
-			if ( GetUns32AsIs(&thisEntry->bytes) > 4 ) {
-				void *tempEntryDataOrPos = &thisEntry->dataOrPos;
-				if ( ! this->nativeEndian ) Flip4 ( &thisEntry->dataOrPos );
-				if ( (GetUns32AsIs(&thisEntry->dataOrPos) < 8) || (GetUns32AsIs(&thisEntry->dataOrPos) >= this->tiffLength) ) {
-					// thisEntry->bytes = thisEntry->dataOrPos = 0;	// Make this bad tag look empty.
-					memset ( tempEntryByte, 0, sizeof(XMP_Uns32) );
-					memset ( tempEntryDataOrPos, 0, sizeof(XMP_Uns32) );
-				}
-				if ( GetUns32AsIs(&thisEntry->bytes) > (this->tiffLength - GetUns32AsIs(&thisEntry->dataOrPos)) ) {
-					// thisEntry->bytes = thisEntry->dataOrPos = 0;	// Make this bad tag look empty.
-					memset ( tempEntryByte, 0, sizeof(XMP_Uns32) );
-					memset ( tempEntryDataOrPos, 0, sizeof(XMP_Uns32) );
-				}
+			if ( thisEntry->bytes > (this->tiffLength - thisEntry->dataOrPos) ) {
+				thisEntry->bytes = thisEntry->dataOrPos = 0;	// Make this bad tag look empty.
 			}
-	
-		#endif
+		}
+
+	#else
+
+		void *tempEntryByte = &thisEntry->bytes;
+		XMP_Uns32 temp = GetUns32AsIs(&thisEntry->bytes);
+		temp = temp * (XMP_Uns32)kTIFF_TypeSizes[GetUns16AsIs(&thisEntry->type)];
+		memcpy ( tempEntryByte, &temp, sizeof(thisEntry->bytes) );
+
+		// thisEntry->bytes *= (XMP_Uns32)kTIFF_TypeSizes[thisEntry->type];
+		if ( GetUns32AsIs(&thisEntry->bytes) > 4 ) {
+			void *tempEntryDataOrPos = &thisEntry->dataOrPos;
+			if ( ! this->nativeEndian ) Flip4 ( &thisEntry->dataOrPos );
+			if ( (GetUns32AsIs(&thisEntry->dataOrPos) < 8) || (GetUns32AsIs(&thisEntry->dataOrPos) >= this->tiffLength) ) {
+				// thisEntry->bytes = thisEntry->dataOrPos = 0;	// Make this bad tag look empty.
+				memset ( tempEntryByte, 0, sizeof(XMP_Uns32) );
+				memset ( tempEntryDataOrPos, 0, sizeof(XMP_Uns32) );
+			}
+			if ( GetUns32AsIs(&thisEntry->bytes) > (this->tiffLength - GetUns32AsIs(&thisEntry->dataOrPos)) ) {
+				// thisEntry->bytes = thisEntry->dataOrPos = 0;	// Make this bad tag look empty.
+				memset ( tempEntryByte, 0, sizeof(XMP_Uns32) );
+				memset ( tempEntryDataOrPos, 0, sizeof(XMP_Uns32) );
+			}
+		}
+
+	#endif
+
+}	// TIFF_MemoryReader::TweakOneEntry
+
+// =================================================================================================
+// TIFF_MemoryReader::IndexIFD
+// ===========================
+//
+// Called on the first look into a pending IFD. Most IFDs are written in tag order, those are left
+// as stored and searched directly, with entries tweaked as they are found. An IFD that is out of
+// order, has duplicates, or is too big for the tweakedMask is tweaked as a whole and sorted.
+
+void TIFF_MemoryReader::IndexIFD ( TweakedIFDInfo* thisIFD ) const
+{
+	XMP_Assert ( thisIFD->state == kIFD_Pending );
+
+	XMP_Uns16 tagCount = thisIFD->count;
+	TweakedIFDEntry* ifdEntries = thisIFD->entries;
+
+	XMP_Int32 prevTag = -1;	// ! The GPS IFD has a tag 0, so we need a signed initial value.
+	bool needsSorting = (tagCount > kMaxRawIFDCount);
+	for ( size_t i = 0; (i < tagCount) && (! needsSorting); ++i ) {
+		XMP_Uns16 thisTag = this->GetRawID ( &ifdEntries[i] );
+		if ( thisTag <= prevTag ) needsSorting = true;
+		prevTag = thisTag;
+	}
 
+	if ( ! needsSorting ) {
+		memset ( thisIFD->tweakedMask, 0, sizeof(thisIFD->tweakedMask) );
+		thisIFD->state = kIFD_SortedRaw;
+	} else {
+		for ( size_t i = 0; i < tagCount; ++i ) this->TweakOneEntry ( &ifdEntries[i] );
+		SortIFD ( thisIFD );
+		thisIFD->state = kIFD_Tweaked;
 	}
 
-	ifdPtr += (2 + ifdCount*12);
-	XMP_Uns32 nextIFDOffset = this->GetUns32 ( ifdPtr );
+}	// TIFF_MemoryReader::IndexIFD
+
+// =================================================================================================
+// TIFF_MemoryReader::TweakWholeIFD
+// ================================
 
-	if ( needsSorting ) SortIFD ( &ifdInfo );	// ! Don't perturb the ifdCount used to find the next IFD offset.
+void TIFF_MemoryReader::TweakWholeIFD ( TweakedIFDInfo* thisIFD ) const
+{
+	if ( thisIFD->state == kIFD_Pending ) this->IndexIFD ( thisIFD );
 
-	return nextIFDOffset;
+	if ( thisIFD->state == kIFD_SortedRaw ) {
+		for ( size_t i = 0; i < thisIFD->count; ++i ) {
+			if ( ! thisIFD->IsTweaked ( i ) ) this->TweakOneEntry ( &thisIFD->entries[i] );
+		}
+		thisIFD->state = kIFD_Tweaked;
+	}
 
-}	// TIFF_MemoryReader::ProcessOneIFD
+}	// TIFF_MemoryReader::TweakWholeIFD
 
 // =================================================================================================
@@ -792,21 +792,46 @@ private:
 		TweakedIFDEntry() : id(0), type(0), bytes(0), dataOrPos(0) {};
 	};
 
+	enum {	// The states of an IFD's entries.
+		kIFD_Tweaked   = 0,	// All entries are tweaked and sorted.
+		kIFD_Pending   = 1,	// Not looked at since ProcessOneIFD.
+		kIFD_SortedRaw = 2	// Stored in tag order, only the entries marked in tweakedMask are tweaked.
+	};
+
+	enum { kMaxRawIFDCount = 128 };	// Larger IFDs are tweaked as a whole, see IndexIFD.
+
 	struct TweakedIFDInfo {
 		XMP_Uns16 count;
+		XMP_Uns8  state;
 		TweakedIFDEntry* entries;
-		TweakedIFDInfo() : count(0), entries(0) {};
+		XMP_Uns64 tweakedMask [kMaxRawIFDCount/64];
+		TweakedIFDInfo() : count(0), state(kIFD_Tweaked), entries(0) {};
+		bool IsTweaked ( size_t index ) const { return ((tweakedMask[index>>6] >> (index & 63)) & 1) != 0; };
+		void SetTweaked ( size_t index ) { tweakedMask[index>>6] |= ((XMP_Uns64)1 << (index & 63)); };
 	};
 
-	TweakedIFDInfo containedIFDs[kTIFF_KnownIFDCount];
+	mutable TweakedIFDInfo containedIFDs[kTIFF_KnownIFDCount];	// ! Entries are tweaked by the const lookups.
 
 	static void SortIFD ( TweakedIFDInfo* thisIFD );
 
+	void TweakOneEntry ( TweakedIFDEntry* thisEntry ) const;
+	void IndexIFD ( TweakedIFDInfo* thisIFD ) const;
+	void TweakWholeIFD ( TweakedIFDInfo* thisIFD ) const;
+
 	// ModifiedInitialCheck is provided for case when data contain no header
 	XMP_Uns32 ProcessOneIFD ( XMP_Uns32 ifdOffset, XMP_Uns8 ifd, bool ModifiedInitialCheck = false );
 
 	const TweakedIFDEntry* FindTagInIFD ( XMP_Uns8 ifd, XMP_Uns16 id ) const;
 
+	inline XMP_Uns16 GetRawID ( const TweakedIFDEntry* tifdEntry ) const	// For entries not yet tweaked.
+		{ XMP_Uns16 id = GetUns16AsIs ( &tifdEntry->id ); return ( this->nativeEndian ) ? id : Flip2 ( id ); }
+
+	inline XMP_Uns16 GetEntryID ( const TweakedIFDInfo* thisIFD, size_t index ) const	// Tweaked or not.
+		{ const TweakedIFDEntry* tifdEntry = &thisIFD->entries[index];
+		  if ( (thisIFD->state == kIFD_SortedRaw) && (! thisIFD->IsTweaked ( index )) ) return this->GetRawID ( tifdEntry );
+		  return GetUns16AsIs ( &tifdEntry->id );
+		}
+
 	const inline void* GetDataPtr ( const TweakedIFDEntry* tifdEntry ) const
 		{ if ( GetUns32AsIs(&tifdEntry->bytes) <= 4 ) {
 		  	return &tifdEntry->dataOrPos;
@@ -876,7 +901,16 @@ public:
 
 	// isAlredyLittle is provided for case when data contain no information about Endianess, So need not to check for header
 	void ParseMemoryStream ( const void* data, XMP_Uns32 length, bool copyData = true, bool isAlreadyLittle = false );
-	void ParseFileStream   ( XMP_IO* fileRef );
+	void ParseFileStream   ( XMP_IO* fileRef ) { this->ParseFileStream ( fileRef, kLoadLargeValues ); };
+
+	// The deferred form of ParseFileStream records the offset and length of the recognized large
+	// values instead of reading them. A value is read by the first lookup that needs it, so the
+	// fileRef must stay open for the life of the parse. Unchanged values are never moved by
+	// UpdateFileStream and so are never read just to be written back.
+
+	enum { kLoadLargeValues = false, kDeferLargeValues = true };
+
+	void ParseFileStream ( XMP_IO* fileRef, bool deferLargeValues );
 
 	void IntegrateFromPShop6 ( const void * buriedPtr, size_t buriedLen );
 
@@ -896,12 +930,15 @@ private:
 	XMP_Uns8* memStream;
 	XMP_Uns32 tiffLength;
 
+	XMP_IO* deferredFile;	// The source of deferred large values, 0 if the parse loaded them.
+
 	// Memory usage notes: TIFF_FileWriter is for file-based OR read/write usage. For memory-based
 	// streams the dataPtr is initially into the stream, regardless of size. For file-based streams
 	// the dataPtr is initially a separate allocation for large values (over 4 bytes), and points to
 	// the smallValue field for small values. This is also the usage when a tag is changed (for both
 	// memory and file cases), the dataPtr is a separate allocation for large values (over 4 bytes),
-	// and points to the smallValue field for small values.
+	// and points to the smallValue field for small values. A deferred large value has a null dataPtr
+	// until it is first looked up.
 
 	// ! The working data values are always stream endian, no matter where stored. They are flipped
 	// ! as necessary by GetTag and SetTag.
@@ -922,6 +959,7 @@ private:
 		XMP_Uns32 origDataOffset;	// The original data offset, regardless of length.
 		bool      changed;
 		bool      fileBased;
+		bool      deferred;			// A recognized large value not yet read from the deferredFile.
 
 		inline void FreeData() {
 			if ( this->fileBased || this->changed ) {
@@ -931,7 +969,7 @@ private:
 
 		InternalTagInfo ( XMP_Uns16 _id, XMP_Uns16 _type, XMP_Uns32 _count, bool _fileBased )
 			: id(_id), type(_type), count(_count), dataLen(0), smallValue(0), dataPtr(0),
-			  origDataLen(0), origDataOffset(0), changed(false), fileBased(_fileBased) {};
+			  origDataLen(0), origDataOffset(0), changed(false), fileBased(_fileBased), deferred(false) {};
 		~InternalTagInfo() { this->FreeData(); };
 
 		void operator=  ( const InternalTagInfo & in )
@@ -950,7 +988,7 @@ private:
 
 		InternalTagInfo()	// Hidden on purpose, fileBased must be properly set.
 			: id(0), type(0), count(0), dataLen(0), smallValue(0), dataPtr(0),
-			  origDataLen(0), origDataOffset(0), changed(false), fileBased(false) {};
+			  origDataLen(0), origDataOffset(0), changed(false), fileBased(false), deferred(false) {};
 
 	};
 
@@ -972,11 +1010,13 @@ private:
 		};
 	};
 
-	InternalIFDInfo containedIFDs[kTIFF_KnownIFDCount];
+	mutable InternalIFDInfo containedIFDs[kTIFF_KnownIFDCount];	// ! Mutable for deferred value loading.
 
 	static XMP_Uns8 PickIFD ( XMP_Uns8 ifd, XMP_Uns16 id );
 	const InternalTagInfo* FindTagInIFD ( XMP_Uns8 ifd, XMP_Uns16 id ) const;
 
+	void LoadDeferredValue ( InternalTagInfo* tagInfo ) const;
+
 	void DeleteExistingInfo();
 
 	XMP_Uns32 ProcessMemoryIFD ( XMP_Uns32 ifdOffset, XMP_Uns8 ifd );
@@ -24,6 +24,20 @@ using namespace IFF_RIFF;
 const LittleEndian& WAVEBehavior::mEndian = LittleEndian::getInstance();
 
 
+//-----------------------------------------------------------------------------
+// 
+// isRF64ID(...)
+// 
+// Purpose: [static] RF64 and BW64 (ITU-R BS.2088) share the 'ds64' chunk and
+//			differ only in the ID of the top-level chunk
+// 
+//-----------------------------------------------------------------------------
+
+static bool isRF64ID( XMP_Uns32 id )
+{
+	return id == kChunk_RF64 || id == kChunk_BW64;
+}
+
 //-----------------------------------------------------------------------------
 // 
 // WAVEBehavior::getRealSize(...)
@@ -55,7 +69,8 @@ XMP_Uns64 WAVEBehavior::getRealSize( const XMP_Uns64 size, const ChunkIdentifier
 				//
 				switch( id.id )
 				{
-					case kChunk_RF64:	realSize = rf64->riffSize;	break;
+					case kChunk_RF64:
+					case kChunk_BW64:	realSize = rf64->riffSize;	break;
 					case kChunk_data:	realSize = rf64->dataSize;	break;
 
 					default:
@@ -144,7 +159,7 @@ bool WAVEBehavior::isValidTopLevelChunk( const ChunkIdentifier& id, XMP_Uns32 ch
 {
 	return ( chunkNo == 0 )												&& 
 		   ( ( ( id.id == kChunk_RIFF ) && ( id.type == kType_WAVE ) )	||  
-		     ( ( id.id == kChunk_RF64 ) && ( id.type == kType_WAVE ) ) );
+		     ( ( ::isRF64ID( id.id ) ) && ( id.type == kType_WAVE ) ) );
 }
 
 //-----------------------------------------------------------------------------
@@ -371,7 +386,7 @@ bool WAVEBehavior::isRF64( const IChunkContainer& tree )
 	{
 		Chunk *chunk = tree.getChildAt(0);
 		// Only the TopLevel chunk is interesting
-		mIsRF64 = chunk->getID() == kChunk_RF64 && 
+		mIsRF64 = ::isRF64ID( chunk->getID() ) && 
 				chunk->getType() == kType_WAVE;
 	}
 	
@@ -402,7 +417,7 @@ WAVEBehavior::DS64* WAVEBehavior::getDS64( IChunkContainer& tree, XMP_IO* stream
 		{
 			rf64 = tree.getChildAt(0);
 
-			if( rf64 != NULL && rf64->getID() == kChunk_RF64 && rf64->numChildren() > 0 )
+			if( rf64 != NULL && ::isRF64ID( rf64->getID() ) && rf64->numChildren() > 0 )
 			{
 				//
 				// 'ds64' chunk needs to be the very first child of the 'RF64' chunk
@@ -504,7 +519,7 @@ void WAVEBehavior::updateRF64( IChunkContainer& tree )
 		// Check all chunks that sizes have changed and update their related value in the DS64 chunk
 		//
 		Chunk* rf64 = tree.getChildAt(0);
-		XMP_Validate( rf64 != NULL && rf64->getID() == kChunk_RF64 && rf64->numChildren() > 0, "Invalid RF64 chunk", kXMPErr_InternalFailure );
+		XMP_Validate( rf64 != NULL && ::isRF64ID( rf64->getID() ) && rf64->numChildren() > 0, "Invalid RF64 chunk", kXMPErr_InternalFailure );
 
 		this->doUpdateRF64( *rf64 );
 
@@ -527,11 +542,15 @@ void WAVEBehavior::doUpdateRF64( Chunk& chunk )
 	//
 	// update ds64 entry for chunk if its size has changed
 	//
-	if( chunk.hasChanged() && chunk.getOriginalSize() > kNormalRF64ChunkSize )
+	if( chunk.hasChanged() )
 	{
 		switch( chunk.getID() )
 		{
-			case kChunk_RF64:	mDS64Data->riffSize = chunk.getSize();		break;
+			case kChunk_RF64:
+			case kChunk_BW64:
+				// readers take the RIFF size from 'ds64', so keep it current even below 4GB
+				mDS64Data->riffSize = chunk.getSize();
+				break;
 			case kChunk_data:
 				if( chunk.getSize() != chunk.getOriginalSize() )
 				{
@@ -540,6 +559,12 @@ void WAVEBehavior::doUpdateRF64( Chunk& chunk )
 				break;
 			default:
 			{
+				// the table only holds the sizes of chunks beyond 4GB, the entries are found by ID
+				if( chunk.getOriginalSize() <= kNormalRF64ChunkSize && chunk.getSize() <= kNormalRF64ChunkSize )
+				{
+					break;
+				}
+
 				bool requireEntry = ( chunk.getSize() > kNormalRF64ChunkSize );
 				bool found = false;
 
@@ -13,6 +13,8 @@
 #include "source/XIO.hpp"
 
 #include "XMPFiles/source/HandlerRegistry.h"
+#include "XMPFiles/source/XMPFiles_Metrics.hpp"
+#include "XMPFiles/source/HeaderCache_IO.hpp"
 
 #if EnablePluginManager
 	#include "XMPFiles/source/PluginHandler/XMPAtoms.h"
@@ -60,6 +62,82 @@ using namespace Common;
 	using namespace XMP_PLUGIN;
 #endif
 
+// =================================================================================================
+// OpenSessionFile
+// ===============
+//
+// Open the local file for the CheckProcs and handler. With kXMPFiles_OpenPrefetch the start of the
+// file is read ahead asynchronously, the CheckProcs and CacheFileData then mostly hit the cache.
+
+static const XMP_Int64 kSessionPrefetchLength = 256*1024;
+
+static XMPFiles_IO * OpenSessionFile ( XMPFiles * session, XMP_StringPtr clientPath, bool readOnly, XMP_OptionBits openFlags )
+{
+	XMPFiles_IO * localFile = XMPFiles_IO::New_XMPFiles_IO ( clientPath, readOnly, &session->errorCallback );
+	if ( (localFile != 0) && (openFlags & kXMPFiles_OpenPrefetch) ) localFile->Prefetch ( 0, kSessionPrefetchLength );
+	return localFile;
+}
+
+// =================================================================================================
+// SniffFileFormat
+// ===============
+//
+// Picks the likely format from the magic numbers at the start of the file. This only decides which
+// CheckProc is tried first, that CheckProc still makes the real decision. Where several handlers
+// take the same magic numbers (EPS and PostScript, MOV and MPEG-4) the table names the one that
+// comes first in the full search, so sniffing never changes which handler is selected.
+
+struct MagicNumber {
+	const char *	prefix;		// Bytes at offset 0, may be empty.
+	XMP_Uns8		prefixLen;
+	XMP_Uns8		tagOffset;	// Optional second check, typically a form type after a chunk header.
+	const char *	tag;
+	XMP_Uns8		tagLen;
+	XMP_FileFormat	format;
+};
+
+static const MagicNumber kMagicNumbers[] = {
+	{ "\xFF\xD8", 2, 0, 0, 0, kXMP_JPEGFile },
+	{ "\x89PNG\x0D\x0A\x1A\x0A", 8, 0, 0, 0, kXMP_PNGFile },
+	{ "II*\x00", 4, 0, 0, 0, kXMP_TIFFFile },
+	{ "MM\x00*", 4, 0, 0, 0, kXMP_TIFFFile },
+	{ "8BPS", 4, 0, 0, 0, kXMP_PhotoshopFile },
+	{ "GIF89a", 6, 0, 0, 0, kXMP_GIFFile },
+	{ "RIFF", 4, 8, "WAVE", 4, kXMP_WAVFile },
+	{ "RF64", 4, 8, "WAVE", 4, kXMP_WAVFile },
+	{ "BW64", 4, 8, "WAVE", 4, kXMP_WAVFile },
+	{ "RIFF", 4, 8, "AVI ", 4, kXMP_AVIFile },
+	{ "FORM", 4, 8, "AIFF", 4, kXMP_AIFFFile },
+	{ "FORM", 4, 8, "AIFC", 4, kXMP_AIFFFile },
+	{ "\x30\x26\xB2\x75\x8E\x66\xCF\x11\xA6\xD9\x00\xAA\x00\x62\xCE\x6C", 16, 0, 0, 0, kXMP_WMAVFile },
+	{ "FLV\x01", 4, 0, 0, 0, kXMP_FLVFile },
+	{ "FWS", 3, 0, 0, 0, kXMP_SWFFile },
+	{ "CWS", 3, 0, 0, 0, kXMP_SWFFile },
+	{ "ID3", 3, 0, 0, 0, kXMP_MP3File },
+	{ "", 0, 4, "ftyp", 4, kXMP_MOVFile },
+	{ "\x06\x06\xED\xF5\xD8\x1D\x46\xE5\xBD\x31\xEF\xE7\xFE\x74\xB7\x1D", 16, 0, 0, 0, kXMP_InDesignFile },
+	{ "PK\x03\x04", 4, 0, 0, 0, kXMP_UCFFile },
+	{ "%!PS", 4, 0, 0, 0, kXMP_EPSFile },
+	{ "\xC5\xD0\xD3\xC6", 4, 0, 0, 0, kXMP_EPSFile },
+	{ 0, 0, 0, 0, 0, kXMP_UnknownFile }
+};
+
+static XMP_FileFormat SniffFileFormat ( const XMP_Uns8 * header, size_t headerLen )
+{
+	for ( const MagicNumber * magic = &kMagicNumbers[0]; magic->prefix != 0; ++magic ) {
+		if ( headerLen < magic->prefixLen ) continue;
+		if ( memcmp ( header, magic->prefix, magic->prefixLen ) != 0 ) continue;
+		if ( magic->tag != 0 ) {
+			if ( headerLen < (size_t)(magic->tagOffset + magic->tagLen) ) continue;
+			if ( memcmp ( header + magic->tagOffset, magic->tag, magic->tagLen ) != 0 ) continue;
+		}
+		return magic->format;
+	}
+
+	return kXMP_UnknownFile;
+
+}	// SniffFileFormat
+
 // =================================================================================================
 
 #if EnableDynamicMediaHandlers
@@ -578,6 +656,8 @@ XMPFileHandlerInfo* HandlerRegistry::selectSmartHandler( XMPFiles* session, XMP_
 
 	XMPFileHandlerInfo* handlerInfo	= 0;
 	bool foundHandler				= false;
+
+	HeaderCache_IO headerCache;	// Gives the CheckProcs one shared read of the file header.
 	
 	if ( openFlags & kXMPFiles_ForceGivenHandler ) {
 		// We're being told to blindly use the handler for the given format and nothing else.
@@ -620,7 +700,7 @@ XMPFileHandlerInfo* HandlerRegistry::selectSmartHandler( XMPFiles* session, XMP_
 		{
 			if( ( session->ioRef == 0 ) && (! ( handlerInfo->flags & kXMPFiles_HandlerOwnsFile ) ) ) 
 			{
-				session->ioRef = XMPFiles_IO::New_XMPFiles_IO( clientPath, readOnly, &session->errorCallback);
+				session->ioRef = OpenSessionFile ( session, clientPath, readOnly, openFlags );
 				if ( session->ioRef == 0 ) return 0;
 			}
 			
@@ -659,7 +739,10 @@ XMPFileHandlerInfo* HandlerRegistry::selectSmartHandler( XMPFiles* session, XMP_
 				if( tryThisHandler ) 
 				{
 					CheckFileFormatProc CheckProc = (CheckFileFormatProc) (handlerInfo->checkProc);
-					foundHandler = CheckProc ( format, clientPath, session->ioRef, session );
+					XMP_IO * checkIO = headerCache.Attach ( session->ioRef );
+					XMPFiles_Metrics::PhaseTimer checkTimer ( handlerInfo->format, kXMPFiles_Phase_CheckFormat );
+					foundHandler = CheckProc ( format, clientPath, checkIO, session );
+					checkTimer.Stop();
 				}
 			}
 
@@ -694,9 +777,7 @@ XMPFileHandlerInfo* HandlerRegistry::selectSmartHandler( XMPFiles* session, XMP_
 
 			// ! This does "return 0" on failure, the file does not exist so a normal file handler can't apply.
 
-			if ( Host_IO::GetFileMode ( rootPath.c_str() ) != Host_IO::kFMode_IsFolder ) return 0;
-			
-			session->format = checkTopFolderName ( rootPath );
+			session->format = this->probeClipRoot ( rootPath );
 			
 			if ( session->format == kXMP_UnknownFile ) return 0;
 
@@ -746,48 +827,79 @@ XMPFileHandlerInfo* HandlerRegistry::selectSmartHandler( XMPFiles* session, XMP_
 
 	// Try an initial file-oriented handler based on the extension.
 
+	XMPFileHandlerInfo* extHandlerInfo = 0;
+
 	if( session->UsesLocalIO() ) 
 	{
 		handlerInfo = pickDefaultHandler ( kXMP_UnknownFile, fileExt );	// Picks based on just the extension.
+		extHandlerInfo = handlerInfo;
 
 		if( handlerInfo != 0 ) 
 		{
 			if( (session->ioRef == 0) && (! (handlerInfo->flags & kXMPFiles_HandlerOwnsFile)) ) 
 			{
-				session->ioRef = XMPFiles_IO::New_XMPFiles_IO ( clientPath, readOnly, &session->errorCallback);
+				session->ioRef = OpenSessionFile ( session, clientPath, readOnly, openFlags );
 				if ( session->ioRef == 0 ) return 0;
 			} 
 			else if( (session->ioRef != 0) && (handlerInfo->flags & kXMPFiles_HandlerOwnsFile) ) 
 			{
+				headerCache.Forget();
 				delete session->ioRef;	// Close is implicit in the destructor.
 				session->ioRef = 0;
 			}
 			
 			session->format = handlerInfo->format;	// ! Hack to tell the CheckProc this is an initial call.
 			CheckFileFormatProc CheckProc = (CheckFileFormatProc) (handlerInfo->checkProc);
-			foundHandler = CheckProc ( handlerInfo->format, clientPath, session->ioRef, session );
+			XMP_IO * checkIO = headerCache.Attach ( session->ioRef );
+			XMPFiles_Metrics::PhaseTimer checkTimer ( handlerInfo->format, kXMPFiles_Phase_CheckFormat );
+			foundHandler = CheckProc ( handlerInfo->format, clientPath, checkIO, session );
+			checkTimer.Stop();
 			XMP_Assert ( foundHandler || (session->tempPtr == 0) );
 			
 			if ( foundHandler ) return handlerInfo;
 		}
 	}
 
-	// Search the handlers that don't want to open the file themselves.
+	// Search the handlers that don't want to open the file themselves. Start with the one picked by
+	// the magic numbers, a file with a wrong or missing extension then usually needs one more check.
+	// A handler that has already been tried is not tried again, an initial call is never stricter.
 
 	if( session->ioRef == 0 ) 
 	{
-		session->ioRef = XMPFiles_IO::New_XMPFiles_IO ( clientPath, readOnly, &session->errorCallback );
+		session->ioRef = OpenSessionFile ( session, clientPath, readOnly, openFlags );
 		if ( session->ioRef == 0 ) return 0;
 	}
+
+	XMP_IO * checkIO = headerCache.Attach ( session->ioRef );
+	XMPFileHandlerInfo* sniffedHandlerInfo = 0;
+
+	XMP_FileFormat sniffedFormat = SniffFileFormat ( headerCache.HeaderPtr(), headerCache.HeaderLength() );
+	XMPFileHandlerTablePos handlerPos = mNormalHandlers->find ( sniffedFormat );
+
+	if ( (sniffedFormat != kXMP_UnknownFile) && (handlerPos != mNormalHandlers->end()) &&
+		 (&handlerPos->second != extHandlerInfo) )
+	{
+		session->format = kXMP_UnknownFile;	// ! Hack to tell the CheckProc this is not an initial call.
+		sniffedHandlerInfo = &handlerPos->second;
+		CheckFileFormatProc CheckProc = (CheckFileFormatProc) (sniffedHandlerInfo->checkProc);
+		XMPFiles_Metrics::PhaseTimer checkTimer ( sniffedHandlerInfo->format, kXMPFiles_Phase_CheckFormat );
+		foundHandler = CheckProc ( sniffedHandlerInfo->format, clientPath, checkIO, session );
+		checkTimer.Stop();
+		XMP_Assert ( foundHandler || (session->tempPtr == 0) );
+		if ( foundHandler ) return sniffedHandlerInfo;
+	}
 	
-	XMPFileHandlerTablePos handlerPos = mNormalHandlers->begin();
+	handlerPos = mNormalHandlers->begin();
 
 	for( ; handlerPos != mNormalHandlers->end(); ++handlerPos ) 
 	{
-		session->format = kXMP_UnknownFile;	// ! Hack to tell the CheckProc this is not an initial call.
 		handlerInfo = &handlerPos->second;
+		if ( (handlerInfo == sniffedHandlerInfo) || (handlerInfo == extHandlerInfo) ) continue;
+		session->format = kXMP_UnknownFile;	// ! Hack to tell the CheckProc this is not an initial call.
 		CheckFileFormatProc CheckProc = (CheckFileFormatProc) (handlerInfo->checkProc);
-		foundHandler = CheckProc ( handlerInfo->format, clientPath, session->ioRef, session );
+		XMPFiles_Metrics::PhaseTimer checkTimer ( handlerInfo->format, kXMPFiles_Phase_CheckFormat );
+		foundHandler = CheckProc ( handlerInfo->format, clientPath, checkIO, session );
+		checkTimer.Stop();
 		XMP_Assert ( foundHandler || (session->tempPtr == 0) );
 		if ( foundHandler ) return handlerInfo;
 	}
@@ -796,6 +908,7 @@ XMPFileHandlerInfo* HandlerRegistry::selectSmartHandler( XMPFiles* session, XMP_
 
 	if( session->UsesLocalIO() ) 
 	{
+		headerCache.Forget();
 		delete session->ioRef;	// Close is implicit in the destructor.
 		session->ioRef = 0;
 		handlerPos = mOwningHandlers->begin();
@@ -805,7 +918,9 @@ XMPFileHandlerInfo* HandlerRegistry::selectSmartHandler( XMPFiles* session, XMP_
 			session->format = kXMP_UnknownFile;	// ! Hack to tell the CheckProc this is not an initial call.
 			handlerInfo = &handlerPos->second;
 			CheckFileFormatProc CheckProc = (CheckFileFormatProc) (handlerInfo->checkProc);
+			XMPFiles_Metrics::PhaseTimer checkTimer ( handlerInfo->format, kXMPFiles_Phase_CheckFormat );
 			foundHandler = CheckProc ( handlerInfo->format, clientPath, session->ioRef, session );
+			checkTimer.Stop();
 			XMP_Assert ( foundHandler || (session->tempPtr == 0) );
 			if ( foundHandler ) return handlerInfo;
 		}
@@ -844,7 +959,9 @@ XMPFileHandlerInfo* HandlerRegistry::tryFolderHandlers( XMP_FileFormat format,
 		{
 			handlerInfo = &handlerPos->second;
 			CheckFolderFormatProc CheckProc = (CheckFolderFormatProc) (handlerInfo->checkProc);
+			XMPFiles_Metrics::PhaseTimer checkTimer ( handlerInfo->format, kXMPFiles_Phase_CheckFormat );
 			foundHandler = CheckProc ( handlerInfo->format, rootPath, gpName, parentName, leafName, parentObj );
+			checkTimer.Stop();
 			XMP_Assert ( foundHandler || (parentObj->tempPtr == 0) );
 		}
 	} 
@@ -855,7 +972,9 @@ XMPFileHandlerInfo* HandlerRegistry::tryFolderHandlers( XMP_FileFormat format,
 		{
 			handlerInfo = &handlerPos->second;
 			CheckFolderFormatProc CheckProc = (CheckFolderFormatProc) (handlerInfo->checkProc);
+			XMPFiles_Metrics::PhaseTimer checkTimer ( handlerInfo->format, kXMPFiles_Phase_CheckFormat );
 			foundHandler = CheckProc ( handlerInfo->format, rootPath, gpName, parentName, leafName, parentObj );
+			checkTimer.Stop();
 			XMP_Assert ( foundHandler || (parentObj->tempPtr == 0) );
 			if ( foundHandler ) break;	// ! Exit before incrementing handlerPos.
 		}
@@ -933,6 +1052,65 @@ XMPFileHandlerInfo* HandlerRegistry::tryFolderHandlers( XMP_FileFormat format,
 
 #if EnableDynamicMediaHandlers
 
+// The probes only look at the top level content folders, so the answer is the same for every clip
+// in the folder. Entries expire because clip folders can appear while the client is running, the
+// lifetime is short enough to not surprise someone copying a card and long enough for a bulk open.
+
+static const size_t kMaxClipRootProbes = 64;
+static const std::chrono::steady_clock::duration kClipRootProbeLifetime = std::chrono::seconds ( 2 );
+
+XMP_FileFormat HandlerRegistry::probeClipRoot( const std::string & rootPath, bool refresh /* = false */ )
+{
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+	if ( ! refresh ) {
+		std::lock_guard<std::mutex> guard ( mClipRootMutex );
+		ClipRootProbeMap::iterator pos = mClipRootProbes.find ( rootPath );
+		if ( (pos != mClipRootProbes.end()) && ((now - pos->second.probeTime) < kClipRootProbeLifetime) ) {
+			return pos->second.format;
+		}
+	}
+
+	// Probe without holding the lock, two threads probing the same folder just do it twice.
+
+	ClipRootProbe probe;
+	probe.format = kXMP_UnknownFile;
+	probe.probeTime = now;
+	if ( Host_IO::GetFileMode ( rootPath.c_str() ) == Host_IO::kFMode_IsFolder ) {
+		probe.format = checkTopFolderName ( rootPath );
+	}
+
+	std::lock_guard<std::mutex> guard ( mClipRootMutex );
+
+	if ( mClipRootProbes.size() >= kMaxClipRootProbes ) {
+		// Drop the expired probes, or the oldest one if none have expired.
+		for ( ClipRootProbeMap::iterator pos = mClipRootProbes.begin(); pos != mClipRootProbes.end(); ) {
+			if ( (now - pos->second.probeTime) >= kClipRootProbeLifetime ) {
+				mClipRootProbes.erase ( pos++ );
+			} else {
+				++pos;
+			}
+		}
+		if ( mClipRootProbes.size() >= kMaxClipRootProbes ) {
+			ClipRootProbeMap::iterator oldest = mClipRootProbes.begin();
+			for ( ClipRootProbeMap::iterator pos = oldest; pos != mClipRootProbes.end(); ++pos ) {
+				if ( pos->second.probeTime < oldest->second.probeTime ) oldest = pos;
+			}
+			mClipRootProbes.erase ( oldest );
+		}
+	}
+
+	mClipRootProbes[rootPath] = probe;
+	return probe.format;
+
+}	// HandlerRegistry::probeClipRoot
+
+#endif
+
+// =================================================================================================
+
+#if EnableDynamicMediaHandlers
+
 /*static*/ XMP_FileFormat HandlerRegistry::checkParentFolderNames( const std::string& rootPath,
 																   const std::string& gpName,
 																   const std::string& parentName, 
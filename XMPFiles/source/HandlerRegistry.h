@@ -22,6 +22,11 @@
 #include "XMPFiles/source/FormatSupport/IFF/ChunkPath.h"
 #include "source/Endian.h"
 
+#if EnableDynamicMediaHandlers
+	#include <chrono>
+	#include <mutex>
+#endif
+
 namespace Common
 {
 
@@ -71,6 +76,16 @@ public:
 														const std::string& gpName,
 														const std::string& parentName, 
 														const std::string& leafName );
+
+	/**
+	 * Cached form of checkTopFolderName, including the check that rootPath is a folder. Bulk
+	 * opens of logical clip paths in one folder then probe its children once.
+	 *
+	 * @param rootPath		Path to a possible clip root folder
+	 * @param refresh		Ignore a cached answer, probe the folder and cache the new answer
+	 * @return				The format of the top content folder found, kXMP_UnknownFile if none
+	 */
+	XMP_FileFormat				probeClipRoot( const std::string & rootPath, bool refresh = false );
 #endif
 
 public:
@@ -230,6 +245,18 @@ private:
 
 	XMPFileHandlerTable*	mReplacedHandlers;	// All file handler that where replaced by a later one
 
+#if EnableDynamicMediaHandlers
+	struct ClipRootProbe
+	{
+		XMP_FileFormat							format;		// kXMP_UnknownFile if not a clip root.
+		std::chrono::steady_clock::time_point	probeTime;
+	};
+	typedef std::map <std::string, ClipRootProbe>	ClipRootProbeMap;
+
+	std::mutex				mClipRootMutex;
+	ClipRootProbeMap		mClipRootProbes;	// ! Protected by mClipRootMutex.
+#endif
+
 	static HandlerRegistry*	sInstance;			// singleton instance
 };
 
@@ -0,0 +1,187 @@
+// =================================================================================================
+// Copyright Adobe
+// Copyright 2026 Adobe
+// All Rights Reserved
+//
+// NOTICE: Adobe permits you to use, modify, and distribute this file in accordance with the terms
+// of the Adobe license agreement accompanying it.
+// =================================================================================================
+
+#include "public/include/XMP_Environment.h"	// ! XMP_Environment.h must be the first included header.
+#include "public/include/XMP_Const.h"
+
+#include "XMPFiles/source/XMPFiles_Impl.hpp"
+#include "XMPFiles/source/HeaderCache_IO.hpp"
+
+#include <cstring>
+
+// =================================================================================================
+// HeaderCache_IO::~HeaderCache_IO
+// ===============================
+
+HeaderCache_IO::~HeaderCache_IO()
+{
+	try {
+		this->Detach();
+	} catch ( ... ) {
+		// Ignore, the handler seeks before its own reads anyway.
+	}
+
+}	// HeaderCache_IO::~HeaderCache_IO
+
+// =================================================================================================
+// HeaderCache_IO::Attach
+// ======================
+
+XMP_IO * HeaderCache_IO::Attach ( XMP_IO * _baseFile, size_t headerSize /* = kDefaultHeaderSize */ )
+{
+	if ( _baseFile == 0 ) return 0;
+	if ( _baseFile == this->baseFile ) return this;
+
+	this->Detach();
+
+	this->fileLength = _baseFile->Length();
+	XMP_Int64 cacheLength = this->fileLength;
+	if ( cacheLength > (XMP_Int64)headerSize ) cacheLength = headerSize;
+
+	this->header.resize ( (size_t)cacheLength );
+	if ( cacheLength > 0 ) {
+		_baseFile->Rewind();
+		XMP_Uns32 ioCount = _baseFile->Read ( &this->header[0], (XMP_Uns32)cacheLength );
+		this->header.resize ( ioCount );
+	}
+
+	this->baseFile = _baseFile;
+	this->currOffset = 0;
+	return this;
+
+}	// HeaderCache_IO::Attach
+
+// =================================================================================================
+// HeaderCache_IO::Detach
+// ======================
+
+void HeaderCache_IO::Detach()
+{
+	if ( this->baseFile == 0 ) return;
+	XMP_IO * oldBase = this->baseFile;
+	XMP_Int64 oldOffset = this->currOffset;
+	this->Forget();
+	oldBase->Seek ( oldOffset, kXMP_SeekFromStart );
+
+}	// HeaderCache_IO::Detach
+
+// =================================================================================================
+// HeaderCache_IO::Forget
+// ======================
+
+void HeaderCache_IO::Forget()
+{
+	this->baseFile = 0;
+	this->currOffset = 0;
+	this->fileLength = 0;
+	this->header.clear();
+
+}	// HeaderCache_IO::Forget
+
+// =================================================================================================
+// HeaderCache_IO::Read
+// ====================
+
+XMP_Uns32 HeaderCache_IO::Read ( void * buffer, XMP_Uns32 count, bool readAll /* = false */ )
+{
+	XMP_Assert ( this->baseFile != 0 );
+
+	const XMP_Int64 headerLength = (XMP_Int64)this->header.size();
+	const bool headerIsWholeFile = (headerLength == this->fileLength);
+
+	if ( (this->currOffset + count) > headerLength ) {
+
+		if ( ! headerIsWholeFile ) {
+			// Not all in the header, let the underlying file do it.
+			this->baseFile->Seek ( this->currOffset, kXMP_SeekFromStart );
+			XMP_Uns32 ioCount = this->baseFile->Read ( buffer, count, readAll );
+			this->currOffset += ioCount;
+			return ioCount;
+		}
+
+		if ( readAll ) XMP_Throw ( "HeaderCache_IO::Read, not enough data", kXMPErr_EnforceFailure );
+		count = (XMP_Uns32) (headerLength - this->currOffset);
+
+	}
+
+	if ( count > 0 ) memcpy ( buffer, &this->header[(size_t)this->currOffset], count );
+	this->currOffset += count;
+	return count;
+
+}	// HeaderCache_IO::Read
+
+// =================================================================================================
+// HeaderCache_IO::Seek
+// ====================
+
+XMP_Int64 HeaderCache_IO::Seek ( XMP_Int64 offset, SeekMode mode )
+{
+	XMP_Assert ( this->baseFile != 0 );
+
+	XMP_Int64 newOffset = offset;
+	if ( mode == kXMP_SeekFromCurrent ) {
+		newOffset += this->currOffset;
+	} else if ( mode == kXMP_SeekFromEnd ) {
+		newOffset += this->fileLength;
+	}
+	XMP_Enforce ( newOffset >= 0 );
+
+	if ( newOffset > this->fileLength ) {
+		// Leave the policy for seeks beyond EOF to the underlying file.
+		newOffset = this->baseFile->Seek ( newOffset, kXMP_SeekFromStart );
+		this->fileLength = this->baseFile->Length();
+	}
+
+	this->currOffset = newOffset;
+	return this->currOffset;
+
+}	// HeaderCache_IO::Seek
+
+// =================================================================================================
+// HeaderCache_IO::Length
+// ======================
+
+XMP_Int64 HeaderCache_IO::Length()
+{
+	return this->fileLength;
+
+}	// HeaderCache_IO::Length
+
+// =================================================================================================
+// The rest are not allowed, the CheckProcs only read.
+
+void HeaderCache_IO::Write ( const void * buffer, XMP_Uns32 count )
+{
+	IgnoreParam(buffer); IgnoreParam(count);
+	XMP_Throw ( "HeaderCache_IO::Write, not permitted", kXMPErr_FilePermission );
+}
+
+void HeaderCache_IO::Truncate ( XMP_Int64 length )
+{
+	IgnoreParam(length);
+	XMP_Throw ( "HeaderCache_IO::Truncate, not permitted", kXMPErr_FilePermission );
+}
+
+XMP_IO * HeaderCache_IO::DeriveTemp()
+{
+	XMP_Throw ( "HeaderCache_IO::DeriveTemp, not permitted", kXMPErr_FilePermission );
+	return 0;
+}
+
+void HeaderCache_IO::AbsorbTemp()
+{
+	XMP_Throw ( "HeaderCache_IO::AbsorbTemp, not permitted", kXMPErr_FilePermission );
+}
+
+void HeaderCache_IO::DeleteTemp()
+{
+	XMP_Throw ( "HeaderCache_IO::DeleteTemp, not permitted", kXMPErr_FilePermission );
+}
+
+// =================================================================================================
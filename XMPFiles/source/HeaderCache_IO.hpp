@@ -0,0 +1,73 @@
+#ifndef __HeaderCache_IO_hpp__
+#define __HeaderCache_IO_hpp__	1
+
+// =================================================================================================
+// Copyright Adobe
+// Copyright 2026 Adobe
+// All Rights Reserved
+//
+// NOTICE: Adobe permits you to use, modify, and distribute this file in accordance with the terms
+// of the Adobe license agreement accompanying it.
+// =================================================================================================
+
+#include "public/include/XMP_Environment.h"	// ! This must be the first include.
+#include "public/include/XMP_Const.h"
+#include "public/include/XMP_IO.hpp"
+
+#include <vector>
+
+// =================================================================================================
+// HeaderCache_IO
+// ==============
+//
+// A read-only view of another XMP_IO object that keeps the start of the file in memory. Handler
+// selection passes this to the CheckProcs, so the whole sequence of checks costs one read of the
+// file header instead of a Seek and Read pair per handler tried. Reads beyond the cached header go
+// to the underlying file.
+//
+// The header is also used by HandlerRegistry to sniff the format from its magic numbers.
+//
+// Seeks within the file only move the logical offset. Detach (or the destructor) moves the
+// underlying file to that offset, so the handler finds the file where its CheckProc left it.
+
+class HeaderCache_IO : public XMP_IO {
+public:
+
+	enum { kDefaultHeaderSize = 16*1024 };	// Enough for every built-in CheckProc except the SVG parse.
+
+	HeaderCache_IO() : baseFile(0), currOffset(0), fileLength(0) {};
+	virtual ~HeaderCache_IO();
+
+	// Returns this, reading the header if baseFile is not already the attached file. Returns 0 for
+	// a null baseFile, the owning handlers get no file.
+	XMP_IO * Attach ( XMP_IO * baseFile, size_t headerSize = kDefaultHeaderSize );
+
+	// Syncs the underlying file offset and forgets it. Use Forget before deleting the base file.
+	void Detach();
+	void Forget();
+
+	const XMP_Uns8 * HeaderPtr() const { return ( this->header.empty() ) ? 0 : &this->header[0]; };
+	size_t HeaderLength() const { return this->header.size(); };
+
+	XMP_Uns32 Read ( void * buffer, XMP_Uns32 count, bool readAll = false );
+	void Write ( const void * buffer, XMP_Uns32 count );
+	XMP_Int64 Seek ( XMP_Int64 offset, SeekMode mode );
+	XMP_Int64 Length();
+	void Truncate ( XMP_Int64 length );
+	XMP_IO * DeriveTemp();
+	void AbsorbTemp();
+	void DeleteTemp();
+
+private:
+
+	XMP_IO *				baseFile;
+	XMP_Int64				currOffset;
+	XMP_Int64				fileLength;
+	std::vector<XMP_Uns8>	header;
+
+	HeaderCache_IO ( const HeaderCache_IO & );	// ! Not implemented.
+	void operator= ( const HeaderCache_IO & );
+
+};	// HeaderCache_IO
+
+#endif	// __HeaderCache_IO_hpp__
@@ -228,12 +228,8 @@ void WXMPFiles_OpenFile_1 ( XMPFilesRef    xmpObjRef,
                             WXMP_Result *  wResult )
 {
 	XMP_ENTER_ObjWrite ( XMPFiles, "WXMPFiles_OpenFile_1" )
-		StartPerfCheck ( kAPIPerf_OpenFile, filePath );
-
 		bool ok = thiz->OpenFile ( filePath, format, openFlags );
 		wResult->int32Result = ok;
-
-		EndPerfCheck ( kAPIPerf_OpenFile );
 	XMP_EXIT
 }
 
@@ -247,12 +243,8 @@ void WXMPFiles_OpenFile_2 ( XMPFilesRef    xmpObjRef,
                             WXMP_Result *  wResult )
 {
 	XMP_ENTER_ObjWrite ( XMPFiles, "WXMPFiles_OpenFile_2" )
-		StartPerfCheck ( kAPIPerf_OpenFile, "<client-managed>" );
-
 		bool ok = thiz->OpenFile ( clientIO, format, openFlags );
 		wResult->int32Result = ok;
-
-		EndPerfCheck ( kAPIPerf_OpenFile );
 	XMP_EXIT
 }
 #endif
@@ -264,11 +256,7 @@ void WXMPFiles_CloseFile_1 ( XMPFilesRef    xmpObjRef,
                              WXMP_Result *  wResult )
 {
 	XMP_ENTER_ObjWrite ( XMPFiles, "WXMPFiles_CloseFile_1" )
-		StartPerfCheck ( kAPIPerf_CloseFile, "" );
-
 		thiz->CloseFile ( closeFlags );
-
-		EndPerfCheck ( kAPIPerf_CloseFile );
 	XMP_EXIT
 }
 
@@ -318,8 +306,6 @@ void WXMPFiles_GetXMP_1 ( XMPFilesRef      xmpObjRef,
                           WXMP_Result *    wResult )
 {
 	XMP_ENTER_ObjWrite ( XMPFiles, "WXMPFiles_GetXMP_1" )
-		StartPerfCheck ( kAPIPerf_GetXMP, "" );
-
 		bool hasXMP = false;
 		XMP_StringPtr packetStr = NULL;
 		XMP_StringLen packetLen = 0;
@@ -336,8 +322,6 @@ void WXMPFiles_GetXMP_1 ( XMPFilesRef      xmpObjRef,
 
 		if ( hasXMP && (clientPacket != 0) ) (*SetClientString) ( clientPacket, packetStr, packetLen );
 		wResult->int32Result = hasXMP;
-
-		EndPerfCheck ( kAPIPerf_GetXMP );
 	XMP_EXIT
 }
 
@@ -350,15 +334,11 @@ void WXMPFiles_PutXMP_1 ( XMPFilesRef   xmpObjRef,
                           WXMP_Result * wResult )
 {
 	XMP_ENTER_ObjWrite ( XMPFiles, "WXMPFiles_PutXMP_1" )
-		StartPerfCheck ( kAPIPerf_PutXMP, "" );
-
 		if ( xmpRef != 0 ) {
 			thiz->PutXMP ( xmpRef );
 		} else {
 			thiz->PutXMP ( xmpPacket, xmpPacketLen );
 		}
-
-		EndPerfCheck ( kAPIPerf_PutXMP );
 	XMP_EXIT
 }
 
@@ -371,15 +351,94 @@ void WXMPFiles_CanPutXMP_1 ( XMPFilesRef   xmpObjRef,
                              WXMP_Result * wResult )
 {
 	XMP_ENTER_ObjWrite ( XMPFiles, "WXMPFiles_CanPutXMP_1" )
-		StartPerfCheck ( kAPIPerf_CanPutXMP, "" );
-
 		if ( xmpRef != 0 ) {
 			wResult->int32Result = thiz->CanPutXMP ( xmpRef );
 		} else {
 			wResult->int32Result = thiz->CanPutXMP ( xmpPacket, xmpPacketLen );
 		}
+	XMP_EXIT
+}
+
+// =================================================================================================
+
+void WXMPFiles_SubmitGetXMP_1 ( XMP_StringPtr  filePath,
+								XMP_FileFormat format,
+								XMP_OptionBits openFlags,
+								WXMP_Result *  wResult )
+{
+	XMP_ENTER_Static ( "WXMPFiles_SubmitGetXMP_1" )
+
+		wResult->int32Result = XMPFiles::SubmitGetXMP ( filePath, format, openFlags );
+
+	XMP_EXIT
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void WXMPFiles_HarvestGetXMP_1 ( XMP_Uns32        waitMS,
+								 XMP_Uns32 *      requestID,
+								 void *           clientPacket,
+								 XMP_PacketInfo * packetInfo,
+								 XMP_FileFormat * format,
+								 XMP_Int32 *      errorID,
+								 void *           clientMessage,
+								 SetClientStringProc SetClientString,
+								 WXMP_Result *    wResult )
+{
+	XMP_ENTER_NoLock ( "WXMPFiles_HarvestGetXMP_1" )	// ! Can wait a long time, the queue has its own lock.
+
+		std::string xmpPacket, errMessage;	// Fill local strings, not the client's.
+		bool harvested = XMPFiles::HarvestGetXMP ( waitMS, requestID, &xmpPacket, packetInfo, format, errorID, &errMessage );
+
+		if ( harvested && (clientPacket != 0) ) (*SetClientString) ( clientPacket, xmpPacket.c_str(), (XMP_StringLen)xmpPacket.size() );
+		if ( harvested && (clientMessage != 0) ) (*SetClientString) ( clientMessage, errMessage.c_str(), (XMP_StringLen)errMessage.size() );
+		wResult->int32Result = harvested;
+
+	XMP_EXIT
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void WXMPFiles_GetXMPForFiles_1 ( const XMP_StringPtr *       filePaths,
+								  XMP_Uns32                   fileCount,
+								  XMP_FileFormat              format,
+								  XMP_OptionBits              openFlags,
+								  XMPFiles_BatchResultWrapper wrapperProc,
+								  XMPFiles_BatchResultProc    clientProc,
+								  void *                      context,
+								  WXMP_Result *               wResult )
+{
+	XMP_ENTER_NoLock ( "WXMPFiles_GetXMPForFiles_1" )	// ! The callbacks may call back in, the batch serializes them.
+
+		wResult->int32Result = XMPFiles::GetXMPForFiles ( filePaths, fileCount, format, openFlags,
+														  wrapperProc, clientProc, context );
+
+	XMP_EXIT
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void WXMPFiles_SetMetricsEnabled_1 ( XMP_Bool      enabled,
+									 WXMP_Result * wResult )
+{
+	XMP_ENTER_Static ( "WXMPFiles_SetMetricsEnabled_1" )
+
+		XMPFiles::SetMetricsEnabled ( ConvertXMP_BoolToBool ( enabled ) );
+
+	XMP_EXIT
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void WXMPFiles_GetMetrics_1 ( XMPFiles_HandlerMetrics * metrics,
+							  XMP_Uns32                 capacity,
+							  XMP_Bool                  reset,
+							  WXMP_Result *             wResult )
+{
+	XMP_ENTER_Static ( "WXMPFiles_GetMetrics_1" )
+
+		wResult->int32Result = XMPFiles::GetMetrics ( metrics, capacity, ConvertXMP_BoolToBool ( reset ) );
 
-		EndPerfCheck ( kAPIPerf_CanPutXMP );
 	XMP_EXIT
 }
 
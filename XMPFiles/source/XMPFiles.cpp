@@ -12,6 +12,7 @@
 #include "public/include/XMP_IO.hpp"
 
 #include <vector>
+#include <memory>
 #include <string.h>
 
 #include "source/UnicodeConversions.hpp"
@@ -20,6 +21,9 @@
 
 #include "XMPFiles/source/XMPFiles_Impl.hpp"
 #include "XMPFiles/source/HandlerRegistry.h"
+#include "XMPFiles/source/XMPFiles_AsyncQueue.hpp"
+#include "XMPFiles/source/XMPFiles_BatchReader.hpp"
+#include "XMPFiles/source/XMPFiles_Metrics.hpp"
 
 #if EnablePluginManager
 	#include "XMPFiles/source/PluginHandler/PluginManager.h"
@@ -65,10 +69,18 @@ XMP_Int32 sXMPFilesInitCount = 0;
 static XMP_ProgressTracker::CallbackInfo sProgressDefault;
 static XMPFiles::ErrorCallbackInfo sDefaultErrorCallback;
 
+// Created by the first SubmitGetXMP, shut down in Terminate. A harvest holds a reference while it
+// waits, the queue object is deleted by whoever lets go of it last.
+static std::shared_ptr<XMPFiles_AsyncQueue> sAsyncQueue;
+static std::mutex sAsyncQueueMutex;
 
-#if GatherPerformanceData
-	APIPerfCollection* sAPIPerf = 0;
-#endif
+static std::shared_ptr<XMPFiles_AsyncQueue> GetAsyncQueue()	// Create the queue if necessary.
+{
+	std::lock_guard<std::mutex> guard ( sAsyncQueueMutex );
+	if ( sXMPFilesInitCount == 0 ) XMP_Throw ( "XMPFiles is not initialized", kXMPErr_BadObject );
+	if ( ! sAsyncQueue ) sAsyncQueue.reset ( new XMPFiles_AsyncQueue() );
+	return sAsyncQueue;
+}
 
 // These are embedded version strings.
 
@@ -160,10 +172,6 @@ XMPFiles::Initialize( XMP_OptionBits options, const char* pluginFolder, const ch
 	if ( ! Initialize_LibUtils() ) return false;
 	if ( ! ID3_Support::InitializeGlobals() ) return false;
 
-	#if GatherPerformanceData
-		sAPIPerf = new APIPerfCollection;
-	#endif
-
 	XMP_Uns16 endianInt  = 0x00FF;
 	XMP_Uns8  endianByte = *((XMP_Uns8*)&endianInt);
 	if ( kBigEndianHost ) {
@@ -211,79 +219,6 @@ XMPFiles::Initialize( XMP_OptionBits options, const char* pluginFolder, const ch
 
 // =================================================================================================
 
-#if GatherPerformanceData
-
-#if XMP_WinBuild
-	#pragma warning ( disable : 4996 )	// '...' was declared deprecated
-#endif
-
-#include "PerfUtils.cpp"
-
-static void ReportPerformanceData()
-{
-	struct SummaryInfo {
-		size_t callCount;
-		double totalTime;
-		SummaryInfo() : callCount(0), totalTime(0.0) {};
-	};
-
-	SummaryInfo perfSummary [kAPIPerfProcCount];
-
-	XMP_DateTime now;
-	SXMPUtils::CurrentDateTime ( &now );
-	std::string nowStr;
-	SXMPUtils::ConvertFromDate ( now, &nowStr );
-
-	#if XMP_WinBuild
-		#define kPerfLogPath "C:\\XMPFilesPerformanceLog.txt"
-	#else
-		#define kPerfLogPath "/XMPFilesPerformanceLog.txt"
-	#endif
-	FILE * perfLog = fopen ( kPerfLogPath, "ab" );
-	if ( perfLog == 0 ) return;
-
-	fprintf ( perfLog, "\n\n// =================================================================================================\n\n" );
-	fprintf ( perfLog, "XMPFiles performance data\n" );
-	fprintf ( perfLog, "   %s\n", kXMPFiles_VersionMessage );
-	fprintf ( perfLog, "   Reported at %s\n", nowStr.c_str() );
-	fprintf ( perfLog, "   %s\n", PerfUtils::GetTimerInfo() );
-
-	// Gather and report the summary info.
-
-	for ( size_t i = 0; i < sAPIPerf->size(); ++i ) {
-		SummaryInfo& summaryItem = perfSummary [(*sAPIPerf)[i].whichProc];
-		++summaryItem.callCount;
-		summaryItem.totalTime += (*sAPIPerf)[i].elapsedTime;
-	}
-
-	fprintf ( perfLog, "\nSummary data:\n" );
-
-	for ( size_t i = 0; i < kAPIPerfProcCount; ++i ) {
-		long averageTime = 0;
-		if ( perfSummary[i].callCount != 0 ) {
-			averageTime = (long) (((perfSummary[i].totalTime/perfSummary[i].callCount) * 1000.0*1000.0) + 0.5);
-		}
-		fprintf ( perfLog, "   %s, %d total calls, %d average microseconds per call\n",
-				  kAPIPerfNames[i], perfSummary[i].callCount, averageTime );
-	}
-
-	fprintf ( perfLog, "\nPer-call data:\n" );
-
-	// Report the info for each call.
-
-	for ( size_t i = 0; i < sAPIPerf->size(); ++i ) {
-		long time = (long) (((*sAPIPerf)[i].elapsedTime * 1000.0*1000.0) + 0.5);
-		fprintf ( perfLog, "   %s, %d microSec, ref %.8X, \"%s\"\n",
-				  kAPIPerfNames[(*sAPIPerf)[i].whichProc], time,
-				  (*sAPIPerf)[i].xmpFilesRef, (*sAPIPerf)[i].extraInfo.c_str() );
-	}
-
-	fclose ( perfLog );
-
-}	// ReportAReportPerformanceDataPIPerformance
-
-#endif
-
 // =================================================================================================
 
 /* class static */
@@ -294,10 +229,16 @@ XMPFiles::Terminate()
 	--sXMPFilesInitCount;
 	if ( sXMPFilesInitCount != 0 ) return;	// Not ready to terminate, or already terminated.
 
-	#if GatherPerformanceData
-		ReportPerformanceData();
-		EliminateGlobal ( sAPIPerf );
-	#endif
+	{
+		std::shared_ptr<XMPFiles_AsyncQueue> queue;
+		{
+			std::lock_guard<std::mutex> guard ( sAsyncQueueMutex );
+			queue.swap ( sAsyncQueue );
+		}
+		if ( queue ) queue->Shutdown();	// ! Waits for running requests, must precede the handler teardown.
+	}
+
+	XMPFiles_Metrics::Terminate();	// ! After the queue, running requests still record metrics.
 
 	#if EnablePluginManager
 		PluginManager::terminate();
@@ -449,9 +390,8 @@ XMPFiles::CheckPackageFormat ( XMP_StringPtr folderPath )
 	#if ! EnableDynamicMediaHandlers
 		return kXMP_UnknownFile;
 	#else
-		Host_IO::FileMode folderMode = Host_IO::GetFileMode ( folderPath );
-		if ( folderMode != Host_IO::kFMode_IsFolder ) return kXMP_UnknownFile;
-		return HandlerRegistry::checkTopFolderName ( std::string ( folderPath ) );
+		// ! Always probe, the client may have just created the folder. The fresh answer is cached for opens.
+		return HandlerRegistry::getInstance().probeClipRoot ( std::string ( folderPath ), true );
 	#endif
 	XMP_FILES_STATIC_END2 ( folderPath, kXMPErrSev_OperationFatal )
 	return kXMP_UnknownFile;
@@ -1073,7 +1013,9 @@ DoOpenFile ( XMPFiles *     thiz,
 				XMP_Throw ( "Open, file permission error", kXMPErr_FilePermission );
 			}
 		}
+		XMPFiles_Metrics::PhaseTimer cacheTimer ( thiz->format, kXMPFiles_Phase_CacheFileData );
 		handler->CacheFileData();
+		cacheTimer.Stop();
 	} catch ( ... ) {
 		delete thiz->handler;
 		thiz->handler = 0;
@@ -1139,7 +1081,9 @@ static bool DoOpenFile( XMPFiles* thiz,
 	//
 	try 
 	{
+		XMPFiles_Metrics::PhaseTimer cacheTimer ( thiz->format, kXMPFiles_Phase_CacheFileData );
 		handler->CacheFileData();
+		cacheTimer.Stop();
 
 		if( handler->containsXMP ) 
 		{
@@ -1241,9 +1185,6 @@ XMPFiles::CloseFile ( XMP_OptionBits closeFlags /* = 0 */ )
 	// that don't own the file tolerate safe update using common code below.
 
 	bool doSafeUpdate = XMP_OptionIsSet ( closeFlags, kXMPFiles_UpdateSafely );
-	#if GatherPerformanceData
-		if ( doSafeUpdate ) sAPIPerf->back().extraInfo += ", safe update";	// Client wants safe update.
-	#endif
 
 	if ( ! (this->openFlags & kXMPFiles_OpenForUpdate) ) doSafeUpdate = false;
 	if ( ! needsUpdate ) doSafeUpdate = false;
@@ -1270,10 +1211,9 @@ XMPFiles::CloseFile ( XMP_OptionBits closeFlags /* = 0 */ )
 			needsUpdate |= optimizeFileLayout;
 
 			if ( needsUpdate ) {
-				#if GatherPerformanceData
-					sAPIPerf->back().extraInfo += ", direct update";
-				#endif
+				XMPFiles_Metrics::PhaseTimer updateTimer ( this->format, kXMPFiles_Phase_UpdateFile );
 				this->handler->UpdateFile ( doSafeUpdate );
+				updateTimer.Stop();
 			}
 
 			delete this->handler;
@@ -1291,22 +1231,15 @@ XMPFiles::CloseFile ( XMP_OptionBits closeFlags /* = 0 */ )
 
 				// The handler can rewrite an entire file based on the original.
 
-				#if GatherPerformanceData
-					sAPIPerf->back().extraInfo += ", file rewrite";
-				#endif
-
+				XMPFiles_Metrics::PhaseTimer writeTimer ( this->format, kXMPFiles_Phase_WriteTempFile );
 				this->handler->WriteTempFile ( tempFileRef );
+				writeTimer.Stop();
 
 			} else {
 
 				// The handler can only update an existing file. Copy to the temp then update.
 
-
-				#if GatherPerformanceData
-					sAPIPerf->back().extraInfo += ", copy update";
-				#endif
-
-
+				XMPFiles_Metrics::PhaseTimer updateTimer ( this->format, kXMPFiles_Phase_UpdateFile );	// ! Includes the copy.
 				XMP_IO* origFileRef = this->ioRef;
 
 				origFileRef->Rewind();
@@ -1318,6 +1251,7 @@ XMPFiles::CloseFile ( XMP_OptionBits closeFlags /* = 0 */ )
 					this->ioRef = tempFileRef;
 					this->handler->UpdateFile ( false );	// We're doing the safe update, not the handler.
 					this->ioRef = origFileRef;
+					updateTimer.Stop();
 
 				} catch ( ... ) {
 
@@ -1494,7 +1428,9 @@ XMPFiles::GetXMP ( SXMPMeta *       xmpObj /* = 0 */,
 
 	if ( ! this->handler->processedXMP ) {
 		try {
+			XMPFiles_Metrics::PhaseTimer processTimer ( this->format, kXMPFiles_Phase_ProcessXMP );
 			this->handler->ProcessXMP();
+			processTimer.Stop();
 		} catch ( ... ) {
 			// Return the outputs then rethrow the exception.
 			if ( xmpObj != 0 ) {
@@ -1550,7 +1486,11 @@ DoPutXMP ( XMPFiles * thiz, const SXMPMeta & xmpObj, const bool doIt )
 	XMP_PacketInfo & packetInfo   = handler->packetInfo;
 	std::string &    xmpPacket    = handler->xmpPacket;
 
-	if ( ! handler->processedXMP ) handler->ProcessXMP();	// Might have Open/Put with no GetXMP.
+	if ( ! handler->processedXMP ) {	// Might have Open/Put with no GetXMP.
+		XMPFiles_Metrics::PhaseTimer processTimer ( thiz->format, kXMPFiles_Phase_ProcessXMP );
+		handler->ProcessXMP();
+		processTimer.Stop();
+	}
 
 	size_t oldPacketOffset = (size_t)packetInfo.offset;
 	size_t oldPacketLength = packetInfo.length;
@@ -1679,6 +1619,112 @@ XMPFiles::CanPutXMP ( XMP_StringPtr xmpPacket,
 }	// XMPFiles::CanPutXMP
 
 
+// =================================================================================================
+
+/* class-static */
+XMP_Uns32
+XMPFiles::SubmitGetXMP ( XMP_StringPtr  filePath,
+						 XMP_FileFormat format /* = kXMP_UnknownFile */,
+						 XMP_OptionBits openFlags /* = 0 */ )
+{
+	XMP_FILES_STATIC_START
+	return GetAsyncQueue()->Submit ( filePath, format, openFlags );
+	XMP_FILES_STATIC_END2 ( filePath, kXMPErrSev_OperationFatal )
+	return 0;
+
+}	// XMPFiles::SubmitGetXMP
+
+// =================================================================================================
+
+/* class-static */
+bool
+XMPFiles::HarvestGetXMP ( XMP_Uns32        waitMS,
+						  XMP_Uns32 *      requestID,
+						  std::string *    xmpPacket /* = 0 */,
+						  XMP_PacketInfo * packetInfo /* = 0 */,
+						  XMP_FileFormat * format /* = 0 */,
+						  XMP_Int32 *      errorID /* = 0 */,
+						  std::string *    errMessage /* = 0 */ )
+{
+	XMP_FILES_STATIC_START
+	if ( requestID == 0 ) XMP_Throw ( "A request ID output must be provided", kXMPErr_BadParam );
+
+	std::shared_ptr<XMPFiles_AsyncQueue> queue;
+	{
+		std::lock_guard<std::mutex> guard ( sAsyncQueueMutex );
+		queue = sAsyncQueue;	// ! Don't hold the lock while waiting, the reference keeps the queue alive.
+	}
+	if ( ! queue ) return false;
+
+	XMPFiles_AsyncQueue::Completion completion;
+	if ( ! queue->Harvest ( &completion, waitMS ) ) return false;
+
+	*requestID = completion.requestID;
+	if ( xmpPacket != 0 ) xmpPacket->swap ( completion.xmpPacket );
+	if ( packetInfo != 0 ) *packetInfo = completion.packetInfo;
+	if ( format != 0 ) *format = completion.format;
+	if ( errorID != 0 ) *errorID = completion.errorID;
+	if ( errMessage != 0 ) errMessage->swap ( completion.errMessage );
+
+	return true;
+	XMP_FILES_STATIC_END1 ( kXMPErrSev_OperationFatal )
+	return false;
+
+}	// XMPFiles::HarvestGetXMP
+
+// =================================================================================================
+
+/* class-static */
+XMP_Uns32
+XMPFiles::GetXMPForFiles ( const XMP_StringPtr *       filePaths,
+						   XMP_Uns32                   fileCount,
+						   XMP_FileFormat              format,
+						   XMP_OptionBits              openFlags,
+						   XMPFiles_BatchResultWrapper wrapperProc,
+						   XMPFiles_BatchResultProc    clientProc,
+						   void *                      context )
+{
+	XMP_FILES_STATIC_START
+	std::shared_ptr<XMPFiles_AsyncQueue> pool = GetAsyncQueue();	// The batch workers run on the queue's threads.
+
+	XMPFiles_BatchReader::ResultCallback resultCallback;
+	resultCallback.wrapperProc = wrapperProc;
+	resultCallback.clientProc  = clientProc;
+	resultCallback.context     = context;
+
+	XMPFiles_BatchReader batch ( sDefaultErrorCallback );	// ! The same callback a new XMPFiles object would get.
+	return batch.Run ( *pool, filePaths, fileCount, format, openFlags, resultCallback );
+	XMP_FILES_STATIC_END1 ( kXMPErrSev_OperationFatal )
+	return 0;
+
+}	// XMPFiles::GetXMPForFiles
+
+// =================================================================================================
+
+/* class-static */
+void
+XMPFiles::SetMetricsEnabled ( bool enabled )
+{
+	XMP_FILES_STATIC_START
+	XMPFiles_Metrics::SetEnabled ( enabled );
+	XMP_FILES_STATIC_END1 ( kXMPErrSev_OperationFatal )
+
+}	// XMPFiles::SetMetricsEnabled
+
+// =================================================================================================
+
+/* class-static */
+XMP_Uns32
+XMPFiles::GetMetrics ( XMPFiles_HandlerMetrics * metrics, XMP_Uns32 capacity, bool reset )
+{
+	XMP_FILES_STATIC_START
+	if ( (metrics == 0) && (capacity != 0) ) XMP_Throw ( "Null metrics array", kXMPErr_BadParam );
+	return XMPFiles_Metrics::Snapshot ( metrics, capacity, reset );
+	XMP_FILES_STATIC_END1 ( kXMPErrSev_OperationFatal )
+	return 0;
+
+}	// XMPFiles::GetMetrics
+
 // =================================================================================================
 
 /* class-static */
@@ -206,6 +206,31 @@ public:
         XMP_Bool *     writable,    
         XMP_OptionBits options  = 0 );
 
+	// Asynchronous read-only open/GetXMP/close, see XMPFiles_AsyncQueue.hpp.
+	static XMP_Uns32 SubmitGetXMP(XMP_StringPtr filePath, XMP_FileFormat format = kXMP_UnknownFile, XMP_OptionBits openFlags = 0);
+	static bool HarvestGetXMP(
+		XMP_Uns32 waitMS,
+		XMP_Uns32 * requestID,
+		std::string * xmpPacket = 0,
+		XMP_PacketInfo * packetInfo = 0,
+		XMP_FileFormat * format = 0,
+		XMP_Int32 * errorID = 0,
+		std::string * errMessage = 0);
+
+	// Concurrent read-only GetXMP over a list of files, see XMPFiles_BatchReader.hpp.
+	static XMP_Uns32 GetXMPForFiles(
+		const XMP_StringPtr * filePaths,
+		XMP_Uns32 fileCount,
+		XMP_FileFormat format,
+		XMP_OptionBits openFlags,
+		XMPFiles_BatchResultWrapper wrapperProc,
+		XMPFiles_BatchResultProc clientProc,
+		void * context);
+
+	// Runtime performance metrics, see XMPFiles_Metrics.hpp.
+	static void SetMetricsEnabled(bool enabled);
+	static XMP_Uns32 GetMetrics(XMPFiles_HandlerMetrics * metrics, XMP_Uns32 capacity, bool reset);
+
 	static void SetDefaultProgressCallback(const XMP_ProgressTracker::CallbackInfo & cbInfo);
 	static void SetDefaultErrorCallback(XMPFiles_ErrorCallbackWrapper wrapperProc,
 		XMPFiles_ErrorCallbackProc clientProc,
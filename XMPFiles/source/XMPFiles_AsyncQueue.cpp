@@ -0,0 +1,304 @@
+// =================================================================================================
+// Copyright Adobe
+// Copyright 2026 Adobe
+// All Rights Reserved
+//
+// NOTICE: Adobe permits you to use, modify, and distribute this file in accordance with the terms
+// of the Adobe license agreement accompanying it.
+// =================================================================================================
+
+#include "public/include/XMP_Environment.h"	// ! XMP_Environment.h must be the first included header.
+#include "public/include/XMP_Const.h"
+
+#include "XMPFiles/source/XMPFiles_Impl.hpp"
+#include "XMPFiles/source/XMPFiles.hpp"
+#include "XMPFiles/source/XMPFiles_AsyncQueue.hpp"
+
+#include <chrono>
+
+// =================================================================================================
+// XMPFiles_AsyncQueue::XMPFiles_AsyncQueue
+// ========================================
+//
+// The workers mostly wait on storage, so use several per core. The upper bound keeps the number of
+// simultaneously open files reasonable.
+
+static const size_t kWorkersPerCore = 4;
+static const size_t kMinWorkers = 4;
+static const size_t kMaxWorkers = 64;
+
+XMPFiles_AsyncQueue::XMPFiles_AsyncQueue ( size_t workerCount /* = 0 */ )
+	: outstanding(0), nextRequestID(0), stopping(false)
+{
+
+	if ( workerCount == 0 ) {
+		workerCount = std::thread::hardware_concurrency() * kWorkersPerCore;
+		if ( workerCount < kMinWorkers ) workerCount = kMinWorkers;
+		if ( workerCount > kMaxWorkers ) workerCount = kMaxWorkers;
+	}
+
+	this->workers.reserve ( workerCount );
+	for ( size_t i = 0; i < workerCount; ++i ) {
+		this->workers.push_back ( std::thread ( &XMPFiles_AsyncQueue::WorkerLoop, this ) );
+	}
+
+}	// XMPFiles_AsyncQueue::XMPFiles_AsyncQueue
+
+// =================================================================================================
+// XMPFiles_AsyncQueue::~XMPFiles_AsyncQueue
+// =========================================
+
+XMPFiles_AsyncQueue::~XMPFiles_AsyncQueue()
+{
+
+	this->Shutdown();
+
+}	// XMPFiles_AsyncQueue::~XMPFiles_AsyncQueue
+
+// =================================================================================================
+// XMPFiles_AsyncQueue::Shutdown
+// =============================
+
+void XMPFiles_AsyncQueue::Shutdown()
+{
+	std::deque<Job> abandoned;
+
+	{
+		std::lock_guard<std::mutex> guard ( this->queueMutex );
+		this->stopping = true;
+		abandoned.swap ( this->pending );	// Jobs not yet started are abandoned.
+	}
+
+	this->requestReady.notify_all();
+	this->completionReady.notify_all();
+
+	for ( size_t i = 0; i < this->workers.size(); ++i ) {
+		if ( this->workers[i].joinable() ) this->workers[i].join();
+	}
+
+	for ( size_t i = 0; i < abandoned.size(); ++i ) {
+		if ( abandoned[i].abandon ) abandoned[i].abandon();
+	}
+
+}	// XMPFiles_AsyncQueue::Shutdown
+
+// =================================================================================================
+// XMPFiles_AsyncQueue::Submit
+// ===========================
+
+XMP_Uns32 XMPFiles_AsyncQueue::Submit ( XMP_StringPtr filePath, XMP_FileFormat format, XMP_OptionBits openFlags )
+{
+	if ( (filePath == 0) || (*filePath == 0) ) XMP_Throw ( "Empty file path", kXMPErr_BadParam );
+	if ( openFlags & kXMPFiles_OpenForUpdate ) XMP_Throw ( "Asynchronous opens are read-only", kXMPErr_BadParam );
+
+	Request request;
+	request.filePath  = filePath;
+	request.format    = format;
+	request.openFlags = openFlags | kXMPFiles_OpenForRead | kXMPFiles_OpenPrefetch;
+
+	{
+		std::lock_guard<std::mutex> guard ( this->queueMutex );
+		if ( this->stopping ) XMP_Throw ( "Asynchronous queue is shutting down", kXMPErr_BadObject );
+		++this->nextRequestID;
+		if ( this->nextRequestID == 0 ) ++this->nextRequestID;	// Zero is never a valid ID.
+		request.requestID = this->nextRequestID;
+		Job job;
+		job.run = std::bind ( &XMPFiles_AsyncQueue::RunRequest, this, request );
+		this->pending.push_back ( job );
+		++this->outstanding;
+	}
+
+	this->requestReady.notify_one();
+	return request.requestID;
+
+}	// XMPFiles_AsyncQueue::Submit
+
+// =================================================================================================
+// XMPFiles_AsyncQueue::Post
+// =========================
+
+void XMPFiles_AsyncQueue::Post ( const Job & job )
+{
+
+	{
+		std::lock_guard<std::mutex> guard ( this->queueMutex );
+		if ( this->stopping ) XMP_Throw ( "Asynchronous queue is shutting down", kXMPErr_BadObject );
+		this->pending.push_back ( job );
+	}
+
+	this->requestReady.notify_one();
+
+}	// XMPFiles_AsyncQueue::Post
+
+// =================================================================================================
+// XMPFiles_AsyncQueue::Harvest
+// ============================
+
+bool XMPFiles_AsyncQueue::Harvest ( Completion * completion, XMP_Uns32 waitMS )
+{
+	XMP_Assert ( completion != 0 );
+
+	std::unique_lock<std::mutex> guard ( this->queueMutex );
+
+	if ( this->completed.empty() ) {
+
+		if ( (this->outstanding == 0) || (waitMS == 0) ) return false;
+
+		if ( waitMS == kXMPFiles_WaitForever ) {
+			while ( this->completed.empty() && (! this->stopping) ) this->completionReady.wait ( guard );
+		} else {
+			std::chrono::steady_clock::time_point deadline =
+				std::chrono::steady_clock::now() + std::chrono::milliseconds ( waitMS );
+			while ( this->completed.empty() && (! this->stopping) ) {
+				if ( this->completionReady.wait_until ( guard, deadline ) == std::cv_status::timeout ) break;
+			}
+		}
+
+		if ( this->completed.empty() ) return false;
+
+	}
+
+	std::swap ( *completion, this->completed.front() );
+	this->completed.pop_front();
+	--this->outstanding;
+	return true;
+
+}	// XMPFiles_AsyncQueue::Harvest
+
+// =================================================================================================
+// XMPFiles_AsyncQueue::CountOutstanding
+// =====================================
+
+size_t XMPFiles_AsyncQueue::CountOutstanding()
+{
+	std::lock_guard<std::mutex> guard ( this->queueMutex );
+	return this->outstanding;
+
+}	// XMPFiles_AsyncQueue::CountOutstanding
+
+// =================================================================================================
+// XMPFiles_AsyncQueue::WorkerLoop
+// ===============================
+
+void XMPFiles_AsyncQueue::WorkerLoop()
+{
+	Job job;
+
+	while ( true ) {
+
+		{
+			std::unique_lock<std::mutex> guard ( this->queueMutex );
+			while ( this->pending.empty() && (! this->stopping) ) this->requestReady.wait ( guard );
+			if ( this->stopping ) return;
+			std::swap ( job, this->pending.front() );
+			this->pending.pop_front();
+		}
+
+		try {
+			job.run();
+		} catch ( ... ) {
+			// Jobs report their own failures, don't let one take the worker down.
+		}
+
+	}
+
+}	// XMPFiles_AsyncQueue::WorkerLoop
+
+// =================================================================================================
+// XMPFiles_AsyncQueue::RunRequest
+// ===============================
+
+void XMPFiles_AsyncQueue::RunRequest ( const Request & request )
+{
+	Completion completion;
+	completion.requestID = request.requestID;
+
+	XMPFiles * xmpFile = 0;
+
+	try {
+		xmpFile = new XMPFiles();
+	} catch ( ... ) {
+		NoteCurrentException ( &completion );
+	}
+
+	if ( xmpFile != 0 ) {
+		ReadFile ( xmpFile, request.filePath.c_str(), request.format, request.openFlags, &completion );
+		try {
+			delete xmpFile;
+		} catch ( ... ) {
+			// Ignore cleanup problems, the completion already says what happened.
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> guard ( this->queueMutex );
+		this->completed.push_back ( Completion() );
+		std::swap ( this->completed.back(), completion );
+	}
+
+	this->completionReady.notify_one();
+
+}	// XMPFiles_AsyncQueue::RunRequest
+
+// =================================================================================================
+// XMPFiles_AsyncQueue::ReadFile
+// =============================
+//
+// A file that can't be handled is not an error, the result just has no XMP.
+
+void XMPFiles_AsyncQueue::ReadFile ( XMPFiles * xmpFile, XMP_StringPtr filePath, XMP_FileFormat format,
+									 XMP_OptionBits openFlags, ReadResult * result )
+{
+
+	try {
+
+		bool ok = xmpFile->OpenFile ( filePath, format, openFlags );
+
+		if ( ok ) {
+			XMP_StringPtr packetStr = 0;
+			XMP_StringLen packetLen = 0;
+			result->format = xmpFile->format;
+			result->hasXMP = xmpFile->GetXMP ( 0, &packetStr, &packetLen, &result->packetInfo );
+			if ( result->hasXMP && (packetStr != 0) ) result->xmpPacket.assign ( packetStr, packetLen );
+			xmpFile->CloseFile();
+		}
+
+	} catch ( ... ) {
+		NoteCurrentException ( result );
+	}
+
+	if ( result->errorID != 0 ) {
+		result->hasXMP = false;
+		result->xmpPacket.clear();
+		try {
+			xmpFile->CloseFile();	// Leave the object closed, normally a no-op after a failed open.
+		} catch ( ... ) {
+			// Ignore cleanup problems, the result already says what happened.
+		}
+	}
+
+}	// XMPFiles_AsyncQueue::ReadFile
+
+// =================================================================================================
+// XMPFiles_AsyncQueue::NoteCurrentException
+// =========================================
+
+void XMPFiles_AsyncQueue::NoteCurrentException ( ReadResult * result )
+{
+
+	try {
+		throw;	// ! Rethrow the exception being handled by the caller.
+	} catch ( XMP_Error & xmpErr ) {
+		result->errorID = xmpErr.GetID();
+		result->errMessage = ( xmpErr.GetErrMsg() != 0 ) ? xmpErr.GetErrMsg() : "";
+	} catch ( std::exception & stdErr ) {
+		result->errorID = kXMPErr_StdException;
+		result->errMessage = stdErr.what();
+	} catch ( ... ) {
+		result->errorID = kXMPErr_UnknownException;
+		result->errMessage = "Caught unknown exception";
+	}
+
+}	// XMPFiles_AsyncQueue::NoteCurrentException
+
+// =================================================================================================
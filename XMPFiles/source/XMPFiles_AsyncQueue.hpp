@@ -0,0 +1,126 @@
+#ifndef __XMPFiles_AsyncQueue_hpp__
+#define __XMPFiles_AsyncQueue_hpp__	1
+
+// =================================================================================================
+// Copyright Adobe
+// Copyright 2026 Adobe
+// All Rights Reserved
+//
+// NOTICE: Adobe permits you to use, modify, and distribute this file in accordance with the terms
+// of the Adobe license agreement accompanying it.
+// =================================================================================================
+
+#include "public/include/XMP_Environment.h"	// ! This must be the first include.
+#include "public/include/XMP_Const.h"
+
+#include <string>
+#include <functional>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+class XMPFiles;
+
+// =================================================================================================
+// XMPFiles_AsyncQueue
+// ===================
+//
+// The engine behind SXMPFiles::SubmitGetXMP and SXMPFiles::HarvestGetXMP. Each request is a
+// complete read-only open/GetXMP/close of one file, run on a worker thread with its own XMPFiles
+// object. Opening a file for metadata is a chain of small dependent reads, so a single thread
+// spends most of its time waiting on storage. Keeping many requests in flight hides that latency,
+// the worker count is therefore a multiple of the core count.
+//
+// Requests are opened with kXMPFiles_OpenPrefetch added, so the host starts reading the start of
+// each file ahead of the handler's first read.
+//
+// Completions are queued in the order they finish, not the order they were submitted. The caller
+// matches them up using the request ID returned by Submit. Errors are captured in the completion,
+// they are never thrown from a worker.
+//
+// The workers also run the jobs of XMPFiles_BatchReader, so the library has one pool of reader
+// threads. The open/GetXMP/close of one file, with its error handling, is ReadFile for both.
+//
+// There is one queue per library, created by the first use and shut down by XMPFiles::Terminate.
+// Shutdown waits for the running requests, discards those not yet started, and wakes any waiting
+// Harvest. The object itself lives until the last harvest holding a reference to it returns.
+
+class XMPFiles_AsyncQueue {
+public:
+
+	struct ReadResult {
+		XMP_FileFormat	format;
+		bool			hasXMP;
+		std::string		xmpPacket;
+		XMP_PacketInfo	packetInfo;
+		XMP_Int32		errorID;	// Zero if the read succeeded.
+		std::string		errMessage;
+		ReadResult() : format(kXMP_UnknownFile), hasXMP(false), errorID(0) {};
+	};
+
+	struct Completion : public ReadResult {
+		XMP_Uns32		requestID;
+		Completion() : requestID(0) {};
+	};
+
+	// A job for the workers. If the queue shuts down before the job starts, abandon is called
+	// instead of run, on the thread doing the shutdown. Neither may throw.
+	struct Job {
+		std::function<void()>	run;
+		std::function<void()>	abandon;
+	};
+
+	XMPFiles_AsyncQueue ( size_t workerCount = 0 );	// Zero picks a count from the core count.
+	~XMPFiles_AsyncQueue();
+
+	void Shutdown();	// Also done by the destructor.
+
+	XMP_Uns32 Submit ( XMP_StringPtr filePath, XMP_FileFormat format, XMP_OptionBits openFlags );
+
+	// Returns false if nothing is outstanding, or nothing completed within waitMS milliseconds.
+	bool Harvest ( Completion * completion, XMP_Uns32 waitMS );
+
+	size_t CountOutstanding();
+
+	void Post ( const Job & job );	// Throws if the queue is shutting down.
+
+	// Read-only open, GetXMP, and close of one file using the given XMPFiles object. Never throws,
+	// errors are returned in the result and the object is left closed.
+	static void ReadFile ( XMPFiles * xmpFile, XMP_StringPtr filePath, XMP_FileFormat format,
+						   XMP_OptionBits openFlags, ReadResult * result );
+
+	// Fill in the error of a result from the exception being handled. Only call from a catch block.
+	static void NoteCurrentException ( ReadResult * result );
+
+private:
+
+	struct Request {
+		XMP_Uns32		requestID;
+		std::string		filePath;
+		XMP_FileFormat	format;
+		XMP_OptionBits	openFlags;
+	};
+
+	void WorkerLoop();
+	void RunRequest ( const Request & request );
+
+	std::mutex				queueMutex;
+	std::condition_variable	requestReady;
+	std::condition_variable	completionReady;
+
+	std::deque<Job>			pending;
+	std::deque<Completion>	completed;
+	size_t					outstanding;	// Pending plus running plus completed but not harvested.
+	XMP_Uns32				nextRequestID;
+	bool					stopping;
+
+	std::vector<std::thread> workers;
+
+	XMPFiles_AsyncQueue ( const XMPFiles_AsyncQueue & );	// ! Not implemented.
+	void operator= ( const XMPFiles_AsyncQueue & );
+
+};	// XMPFiles_AsyncQueue
+
+#endif	// __XMPFiles_AsyncQueue_hpp__
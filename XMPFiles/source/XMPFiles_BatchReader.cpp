@@ -0,0 +1,306 @@
+// =================================================================================================
+// Copyright Adobe
+// Copyright 2026 Adobe
+// All Rights Reserved
+//
+// NOTICE: Adobe permits you to use, modify, and distribute this file in accordance with the terms
+// of the Adobe license agreement accompanying it.
+// =================================================================================================
+
+#include "public/include/XMP_Environment.h"	// ! XMP_Environment.h must be the first included header.
+#include "public/include/XMP_Const.h"
+
+#include "XMPFiles/source/XMPFiles_Impl.hpp"
+#include "XMPFiles/source/XMPFiles_BatchReader.hpp"
+
+#include <thread>
+#include <functional>
+
+// =================================================================================================
+// XMPFiles_BatchReader::XMPFiles_BatchReader
+// ==========================================
+
+XMPFiles_BatchReader::XMPFiles_BatchReader ( const XMPFiles::ErrorCallbackInfo & defaultErrorCallback )
+	: errorCallback(defaultErrorCallback), filePaths(0), format(kXMP_UnknownFile), openFlags(0)
+	, cancelled(false), runningWorkers(0)
+{
+	// Nothing more to do.
+
+}	// XMPFiles_BatchReader::XMPFiles_BatchReader
+
+// =================================================================================================
+// XMPFiles_BatchReader::~XMPFiles_BatchReader
+// ===========================================
+
+XMPFiles_BatchReader::~XMPFiles_BatchReader()
+{
+	for ( size_t i = 0; i < this->ranges.size(); ++i ) delete this->ranges[i];
+
+}	// XMPFiles_BatchReader::~XMPFiles_BatchReader
+
+// =================================================================================================
+// XMPFiles_BatchReader::Run
+// =========================
+
+XMP_Uns32 XMPFiles_BatchReader::Run ( XMPFiles_AsyncQueue & pool,
+									  const XMP_StringPtr * _filePaths, XMP_Uns32 fileCount,
+									  XMP_FileFormat _format, XMP_OptionBits _openFlags,
+									  const ResultCallback & resultCallback )
+{
+	XMP_Assert ( resultCallback.wrapperProc != 0 );	// ! Should be provided by the glue code.
+	if ( (resultCallback.clientProc == 0) ) XMP_Throw ( "A result callback must be provided", kXMPErr_BadParam );
+	if ( _openFlags & kXMPFiles_OpenForUpdate ) XMP_Throw ( "Batch opens are read-only", kXMPErr_BadParam );
+	if ( fileCount == 0 ) return 0;
+	if ( _filePaths == 0 ) XMP_Throw ( "Null file path list", kXMPErr_BadParam );
+	for ( XMP_Uns32 i = 0; i < fileCount; ++i ) {
+		if ( (_filePaths[i] == 0) || (*_filePaths[i] == 0) ) XMP_Throw ( "Empty file path", kXMPErr_BadParam );
+	}
+
+	this->filePaths = _filePaths;
+	this->format = _format;
+	this->openFlags = _openFlags | kXMPFiles_OpenForRead;
+
+	// Use a worker per core and deal out equal slices of the file list.
+
+	size_t workerCount = std::thread::hardware_concurrency();
+	if ( workerCount == 0 ) workerCount = 1;
+	if ( workerCount > fileCount ) workerCount = fileCount;
+
+	this->ranges.reserve ( workerCount );
+	for ( size_t i = 0; i < workerCount; ++i ) {
+		WorkRange * range = new WorkRange();
+		range->next = (fileCount * i) / workerCount;
+		range->end  = (fileCount * (i + 1)) / workerCount;
+		this->ranges.push_back ( range );
+	}
+
+	this->workerFailure.errorID = kXMPErr_InternalFailure;	// Used if a worker is abandoned.
+	this->workerFailure.errMessage = "The batch stopped before the file was read";
+
+	std::vector<bool> reported ( fileCount, false );
+	XMP_Uns32 delivered = 0;
+
+	try {
+
+		for ( size_t i = 0; i < workerCount; ++i ) {
+
+			XMPFiles_AsyncQueue::Job job;
+			job.run = std::bind ( &XMPFiles_BatchReader::WorkerLoop, this, i );
+			job.abandon = std::bind ( &XMPFiles_BatchReader::WorkerDone, this );
+
+			{
+				std::lock_guard<std::mutex> guard ( this->resultMutex );
+				++this->runningWorkers;
+			}
+
+			try {
+				pool.Post ( job );
+			} catch ( ... ) {
+				this->WorkerDone();
+				throw;
+			}
+
+		}
+
+		// Deliver the results on this thread as they arrive. Once cancelled, the workers stop
+		// claiming files and the results still in flight are discarded.
+
+		Result result;
+
+		while ( true ) {
+
+			{
+				std::unique_lock<std::mutex> guard ( this->resultMutex );
+				while ( this->results.empty() && (this->runningWorkers > 0) ) this->resultReady.wait ( guard );
+				if ( this->results.empty() ) break;	// All workers are done.
+				std::swap ( result, this->results.front() );
+				this->results.pop_front();
+			}
+
+			if ( this->cancelled ) continue;
+
+			reported[result.fileIndex] = true;
+			++delivered;
+			if ( ! this->DeliverResult ( resultCallback, result ) ) this->cancelled = true;
+
+		}
+
+		// Report the files that no worker read, only possible if a worker failed.
+
+		for ( size_t i = 0; (i < fileCount) && (! this->cancelled); ++i ) {
+			if ( reported[i] ) continue;
+			result = this->workerFailure;
+			result.fileIndex = i;
+			++delivered;
+			if ( ! this->DeliverResult ( resultCallback, result ) ) this->cancelled = true;
+		}
+
+	} catch ( ... ) {
+		this->cancelled = true;
+		this->WaitForWorkers();	// ! The jobs refer to this object.
+		throw;
+	}
+
+	return delivered;
+
+}	// XMPFiles_BatchReader::Run
+
+// =================================================================================================
+// XMPFiles_BatchReader::DeliverResult
+// ===================================
+//
+// Returns false if the client cancelled the batch.
+
+bool XMPFiles_BatchReader::DeliverResult ( const ResultCallback & resultCallback, Result & result )
+{
+	XMP_StringPtr packetPtr = ( result.hasXMP ) ? result.xmpPacket.c_str() : 0;
+	XMP_StringPtr messagePtr = ( result.errorID != 0 ) ? result.errMessage.c_str() : 0;
+
+	XMP_Bool keepGoing = (*resultCallback.wrapperProc) ( resultCallback.clientProc, resultCallback.context,
+														 this->filePaths[result.fileIndex], result.format,
+														 packetPtr, (XMP_StringLen)result.xmpPacket.size(),
+														 &result.packetInfo, result.errorID, messagePtr );
+	return ConvertXMP_BoolToBool ( keepGoing );
+
+}	// XMPFiles_BatchReader::DeliverResult
+
+// =================================================================================================
+// XMPFiles_BatchReader::ClaimFile
+// ===============================
+//
+// Take from the front of our own range, otherwise steal from the back of the others, starting with
+// the next worker so that thieves spread out.
+
+bool XMPFiles_BatchReader::ClaimFile ( size_t workerIndex, size_t * fileIndex )
+{
+	const size_t workerCount = this->ranges.size();
+
+	{
+		WorkRange * own = this->ranges[workerIndex];
+		std::lock_guard<std::mutex> guard ( own->rangeMutex );
+		if ( own->next < own->end ) {
+			*fileIndex = own->next;
+			++own->next;
+			return true;
+		}
+	}
+
+	for ( size_t offset = 1; offset < workerCount; ++offset ) {
+		WorkRange * victim = this->ranges[(workerIndex + offset) % workerCount];
+		std::lock_guard<std::mutex> guard ( victim->rangeMutex );
+		if ( victim->next < victim->end ) {
+			--victim->end;
+			*fileIndex = victim->end;
+			return true;
+		}
+	}
+
+	return false;
+
+}	// XMPFiles_BatchReader::ClaimFile
+
+// =================================================================================================
+// XMPFiles_BatchReader::WorkerLoop
+// ================================
+
+void XMPFiles_BatchReader::WorkerLoop ( size_t workerIndex )
+{
+	XMPFiles * xmpFile = 0;
+
+	try {
+
+		xmpFile = new XMPFiles();	// Reused for every file this worker reads.
+		if ( this->errorCallback.clientProc != 0 ) {
+			xmpFile->SetErrorCallback ( SerializedErrorNotify, this->errorCallback.clientProc, this, this->errorCallback.limit );
+		}
+
+		size_t fileIndex;
+		while ( (! this->cancelled) && this->ClaimFile ( workerIndex, &fileIndex ) ) {
+
+			Result result;
+			result.fileIndex = fileIndex;
+
+			if ( this->errorCallback.clientProc != 0 ) xmpFile->ResetErrorCallbackLimit ( this->errorCallback.limit );
+			XMPFiles_AsyncQueue::ReadFile ( xmpFile, this->filePaths[fileIndex], this->format, this->openFlags, &result );
+
+			{
+				std::lock_guard<std::mutex> guard ( this->resultMutex );
+				this->results.push_back ( Result() );
+				std::swap ( this->results.back(), result );
+			}
+			this->resultReady.notify_one();
+
+		}
+
+	} catch ( ... ) {
+
+		// The remaining files are left to other workers, Run reports any that are never read.
+		try {
+			Result failure;
+			XMPFiles_AsyncQueue::NoteCurrentException ( &failure );
+			std::lock_guard<std::mutex> guard ( this->resultMutex );
+			if ( this->workerFailure.errorID == kXMPErr_InternalFailure ) std::swap ( this->workerFailure, failure );
+		} catch ( ... ) {
+			// Keep the default failure.
+		}
+
+	}
+
+	try {
+		delete xmpFile;
+	} catch ( ... ) {
+		// Ignore cleanup problems.
+	}
+
+	this->WorkerDone();
+
+}	// XMPFiles_BatchReader::WorkerLoop
+
+// =================================================================================================
+// XMPFiles_BatchReader::WorkerDone
+// ================================
+//
+// Called when a worker finishes, or by the pool if the job is abandoned before it starts.
+
+void XMPFiles_BatchReader::WorkerDone()
+{
+
+	{
+		std::lock_guard<std::mutex> guard ( this->resultMutex );
+		--this->runningWorkers;
+	}
+	this->resultReady.notify_one();
+
+}	// XMPFiles_BatchReader::WorkerDone
+
+// =================================================================================================
+// XMPFiles_BatchReader::WaitForWorkers
+// ====================================
+
+void XMPFiles_BatchReader::WaitForWorkers()
+{
+	std::unique_lock<std::mutex> guard ( this->resultMutex );
+	while ( this->runningWorkers > 0 ) this->resultReady.wait ( guard );
+
+}	// XMPFiles_BatchReader::WaitForWorkers
+
+// =================================================================================================
+// XMPFiles_BatchReader::SerializedErrorNotify
+// ===========================================
+//
+// Installed as the wrapper for each worker's error callback, the context is the batch reader.
+
+XMP_Bool XMPFiles_BatchReader::SerializedErrorNotify ( XMPFiles_ErrorCallbackProc clientProc, void * context,
+													   XMP_StringPtr filePath, XMP_ErrorSeverity severity,
+													   XMP_Int32 cause, XMP_StringPtr message )
+{
+	XMPFiles_BatchReader * batch = (XMPFiles_BatchReader*)context;
+	XMP_Assert ( clientProc == batch->errorCallback.clientProc );
+
+	std::lock_guard<std::mutex> guard ( batch->notifyMutex );
+	return (*batch->errorCallback.wrapperProc) ( clientProc, batch->errorCallback.context,
+												 filePath, severity, cause, message );
+
+}	// XMPFiles_BatchReader::SerializedErrorNotify
+
+// =================================================================================================
@@ -0,0 +1,111 @@
+#ifndef __XMPFiles_BatchReader_hpp__
+#define __XMPFiles_BatchReader_hpp__	1
+
+// =================================================================================================
+// Copyright Adobe
+// Copyright 2026 Adobe
+// All Rights Reserved
+//
+// NOTICE: Adobe permits you to use, modify, and distribute this file in accordance with the terms
+// of the Adobe license agreement accompanying it.
+// =================================================================================================
+
+#include "public/include/XMP_Environment.h"	// ! This must be the first include.
+#include "public/include/XMP_Const.h"
+
+#include "XMPFiles/source/XMPFiles.hpp"
+#include "XMPFiles/source/XMPFiles_AsyncQueue.hpp"
+
+#include <string>
+#include <deque>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+// =================================================================================================
+// XMPFiles_BatchReader
+// ====================
+//
+// The engine behind XMPFiles::GetXMPForFiles. Reads the XMP from a list of files using as many
+// workers as there are cores, and hands the results to the client callback as they complete. The
+// workers are jobs on the threads of the library's XMPFiles_AsyncQueue, each file is read with
+// XMPFiles_AsyncQueue::ReadFile.
+//
+// Scheduling is work stealing over index ranges. Each worker starts with an equal contiguous slice
+// of the file list and takes files from the front of it. A worker that runs dry takes files from
+// the back of another worker's slice. Neighbouring files tend to share folders, so the front-first
+// order keeps each worker in one folder for as long as possible.
+//
+// Each worker keeps one XMPFiles object for the whole batch, the error callback limit is reset
+// before each file so the notifications match a fresh open. A worker that fails leaves its files to
+// the others. Files that no worker read are reported to the callback as failed, after the rest.
+//
+// Error notifications use the callback that a new XMPFiles object would get, that is the default
+// set by SetDefaultErrorCallback. They are made from the worker threads but serialized, the client
+// callback is never entered concurrently. The result callback is always called on the thread that
+// called Run, so it needs no locking of its own.
+
+class XMPFiles_BatchReader {
+public:
+
+	struct ResultCallback {
+		XMPFiles_BatchResultWrapper	wrapperProc;
+		XMPFiles_BatchResultProc	clientProc;
+		void *						context;
+		ResultCallback() : wrapperProc(0), clientProc(0), context(0) {};
+	};
+
+	XMPFiles_BatchReader ( const XMPFiles::ErrorCallbackInfo & defaultErrorCallback );
+	~XMPFiles_BatchReader();
+
+	// Returns the number of results delivered. Less than the file count if the callback cancelled.
+	XMP_Uns32 Run ( XMPFiles_AsyncQueue & pool, const XMP_StringPtr * filePaths, XMP_Uns32 fileCount,
+					XMP_FileFormat format, XMP_OptionBits openFlags,
+					const ResultCallback & resultCallback );
+
+private:
+
+	struct WorkRange {	// The unclaimed files of one worker, [next,end).
+		std::mutex	rangeMutex;
+		size_t		next, end;
+		WorkRange() : next(0), end(0) {};
+	};
+
+	struct Result : public XMPFiles_AsyncQueue::ReadResult {
+		size_t			fileIndex;
+		Result() : fileIndex(0) {};
+	};
+
+	bool ClaimFile ( size_t workerIndex, size_t * fileIndex );
+	void WorkerLoop ( size_t workerIndex );
+	void WorkerDone();
+	void WaitForWorkers();
+	bool DeliverResult ( const ResultCallback & resultCallback, Result & result );
+
+	static XMP_Bool SerializedErrorNotify ( XMPFiles_ErrorCallbackProc clientProc, void * context,
+											XMP_StringPtr filePath, XMP_ErrorSeverity severity,
+											XMP_Int32 cause, XMP_StringPtr message );
+
+	XMPFiles::ErrorCallbackInfo	errorCallback;	// Copy of the client's default callback.
+	std::mutex					notifyMutex;	// Serializes the client error callback.
+
+	const XMP_StringPtr *	filePaths;
+	XMP_FileFormat			format;
+	XMP_OptionBits			openFlags;
+
+	std::vector<WorkRange*>	ranges;
+	std::atomic<bool>		cancelled;
+
+	std::mutex				resultMutex;
+	std::condition_variable	resultReady;
+	std::deque<Result>		results;
+	size_t					runningWorkers;	// Posted and not yet finished or abandoned.
+	Result					workerFailure;	// Why the first failed worker stopped.
+
+	XMPFiles_BatchReader ( const XMPFiles_BatchReader & );	// ! Not implemented.
+	void operator= ( const XMPFiles_BatchReader & );
+
+};	// XMPFiles_BatchReader
+
+#endif	// __XMPFiles_BatchReader_hpp__
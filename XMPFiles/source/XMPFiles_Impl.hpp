@@ -85,63 +85,6 @@ extern bool ignoreLocalText;
 
 extern XMP_Int32 sXMPFilesInitCount;
 
-#ifndef GatherPerformanceData
-	#define GatherPerformanceData 0
-#endif
-
-#if ! GatherPerformanceData
-
-	#define StartPerfCheck(proc,info)	/* do nothing */
-	#define EndPerfCheck(proc)	/* do nothing */
-
-#else
-
-	#include "PerfUtils.hpp"
-	
-	enum {
-		kAPIPerf_OpenFile,
-		kAPIPerf_CloseFile,
-		kAPIPerf_GetXMP,
-		kAPIPerf_PutXMP,
-		kAPIPerf_CanPutXMP,
-		kAPIPerfProcCount	// Last, count of the procs.
-	};
-	
-	static const char* kAPIPerfNames[] =
-	{ "OpenFile", "CloseFile", "GetXMP", "PutXMP", "CanPutXMP", 0 };
-	
-	struct APIPerfItem {
-		XMP_Uns8    whichProc;
-		double      elapsedTime;
-		XMPFilesRef xmpFilesRef;
-		std::string extraInfo;
-		APIPerfItem ( XMP_Uns8 proc, double time, XMPFilesRef ref, const char * info )
-			: whichProc(proc), elapsedTime(time), xmpFilesRef(ref), extraInfo(info) {};
-	};
-	
-	typedef std::vector<APIPerfItem> APIPerfCollection;
-	
-	extern APIPerfCollection* sAPIPerf;
-	
-	#define StartPerfCheck(proc,info)	\
-		sAPIPerf->push_back ( APIPerfItem ( proc, 0.0, xmpFilesRef, info ) );	\
-		APIPerfItem & thisPerf = sAPIPerf->back();								\
-		PerfUtils::MomentValue startTime, endTime;								\
-		try {																	\
-		startTime = PerfUtils::NoteThisMoment();
-	
-	#define EndPerfCheck(proc)	\
-		endTime = PerfUtils::NoteThisMoment();										\
-		thisPerf.elapsedTime = PerfUtils::GetElapsedSeconds ( startTime, endTime );	\
-	} catch ( ... ) {																\
-		endTime = PerfUtils::NoteThisMoment();										\
-		thisPerf.elapsedTime = PerfUtils::GetElapsedSeconds ( startTime, endTime );	\
-		thisPerf.extraInfo += "  ** THROW **";										\
-		throw;																		\
-	}
-
-#endif
-
 // **** See CTECHXMP-4169947 *****
 
 //extern XMP_FileFormat voidFileFormat;	// Used as sink for unwanted output parameters.
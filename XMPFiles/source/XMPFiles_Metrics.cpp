@@ -0,0 +1,192 @@
+// =================================================================================================
+// Copyright Adobe
+// Copyright 2026 Adobe
+// All Rights Reserved
+//
+// NOTICE: Adobe permits you to use, modify, and distribute this file in accordance with the terms
+// of the Adobe license agreement accompanying it.
+// =================================================================================================
+
+#include "public/include/XMP_Environment.h"	// ! XMP_Environment.h must be the first included header.
+#include "public/include/XMP_Const.h"
+
+#include "XMPFiles/source/XMPFiles_Impl.hpp"
+#include "XMPFiles/source/XMPFiles_Metrics.hpp"
+
+#include <map>
+#include <mutex>
+#include <cstring>
+
+// =================================================================================================
+
+std::atomic<bool> XMPFiles_Metrics::sEnabled ( false );
+
+typedef std::map < XMP_FileFormat, XMPFiles_HandlerMetrics > HandlerMetricsMap;
+
+static std::mutex sMetricsMutex;
+static HandlerMetricsMap sMetrics;	// ! Protected by sMetricsMutex.
+
+// =================================================================================================
+// FindHandlerMetrics
+// ==================
+//
+// Must be called with sMetricsMutex held. Creates zeroed counts for a handler seen the first time.
+
+static XMPFiles_HandlerMetrics & FindHandlerMetrics ( XMP_FileFormat format )
+{
+	HandlerMetricsMap::iterator pos = sMetrics.find ( format );
+
+	if ( pos == sMetrics.end() ) {
+		XMPFiles_HandlerMetrics newMetrics;
+		memset ( &newMetrics, 0, sizeof(newMetrics) );
+		newMetrics.format = format;
+		pos = sMetrics.insert ( sMetrics.end(), HandlerMetricsMap::value_type ( format, newMetrics ) );
+	}
+
+	return pos->second;
+
+}	// FindHandlerMetrics
+
+// =================================================================================================
+// XMPFiles_Metrics::SetEnabled
+// ============================
+
+void XMPFiles_Metrics::SetEnabled ( bool enabled )
+{
+	sEnabled.store ( enabled );
+
+}	// XMPFiles_Metrics::SetEnabled
+
+// =================================================================================================
+// XMPFiles_Metrics::Snapshot
+// ==========================
+
+XMP_Uns32 XMPFiles_Metrics::Snapshot ( XMPFiles_HandlerMetrics * metrics, XMP_Uns32 capacity, bool reset )
+{
+	std::lock_guard<std::mutex> guard ( sMetricsMutex );
+
+	XMP_Uns32 handlerCount = (XMP_Uns32) sMetrics.size();
+	if ( handlerCount > capacity ) return handlerCount;	// ! Don't reset what the caller can't see.
+
+	HandlerMetricsMap::const_iterator pos = sMetrics.begin();
+	for ( XMP_Uns32 i = 0; pos != sMetrics.end(); ++pos, ++i ) metrics[i] = pos->second;
+
+	if ( reset ) sMetrics.clear();
+	return handlerCount;
+
+}	// XMPFiles_Metrics::Snapshot
+
+// =================================================================================================
+// XMPFiles_Metrics::NoteUpdate
+// ============================
+
+void XMPFiles_Metrics::NoteUpdate ( XMP_FileFormat format, bool inPlace )
+{
+	if ( ! IsEnabled() ) return;
+
+	try {
+		std::lock_guard<std::mutex> guard ( sMetricsMutex );
+		XMPFiles_HandlerMetrics & handlerMetrics = FindHandlerMetrics ( format );
+		if ( inPlace ) {
+			++handlerMetrics.inPlaceUpdates;
+		} else {
+			++handlerMetrics.copyUpdates;
+		}
+	} catch ( ... ) {
+		// Metrics must never make an update fail.
+	}
+
+}	// XMPFiles_Metrics::NoteUpdate
+
+// =================================================================================================
+// XMPFiles_Metrics::Terminate
+// ===========================
+
+void XMPFiles_Metrics::Terminate()
+{
+	sEnabled.store ( false );
+
+	std::lock_guard<std::mutex> guard ( sMetricsMutex );
+	sMetrics.clear();
+
+}	// XMPFiles_Metrics::Terminate
+
+// =================================================================================================
+// XMPFiles_Metrics::PhaseTimer::PhaseTimer
+// ========================================
+
+XMPFiles_Metrics::PhaseTimer::PhaseTimer ( XMP_FileFormat _format, XMP_Uns8 _phase )
+	: format(_format), phase(_phase), active(XMPFiles_Metrics::IsEnabled())
+{
+	XMP_Assert ( this->phase < kXMPFiles_PhaseCount );
+
+	if ( this->active ) {
+		this->startIO = XMPFiles_IO::ThreadIOCounters();
+		this->startTime = std::chrono::steady_clock::now();
+	}
+
+}	// XMPFiles_Metrics::PhaseTimer::PhaseTimer
+
+// =================================================================================================
+// XMPFiles_Metrics::PhaseTimer::~PhaseTimer
+// =========================================
+
+XMPFiles_Metrics::PhaseTimer::~PhaseTimer()
+{
+	if ( this->active ) this->Record ( true );	// Not stopped, the timed code threw.
+
+}	// XMPFiles_Metrics::PhaseTimer::~PhaseTimer
+
+// =================================================================================================
+// XMPFiles_Metrics::PhaseTimer::Stop
+// ==================================
+
+void XMPFiles_Metrics::PhaseTimer::Stop()
+{
+	if ( this->active ) this->Record ( false );
+
+}	// XMPFiles_Metrics::PhaseTimer::Stop
+
+// =================================================================================================
+// XMPFiles_Metrics::PhaseTimer::Record
+// ====================================
+//
+// Never throws, it is called from the destructor.
+
+void XMPFiles_Metrics::PhaseTimer::Record ( bool failed )
+{
+	this->active = false;
+
+	std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - this->startTime;
+	XMP_Uns64 micros = (XMP_Uns64) std::chrono::duration_cast<std::chrono::microseconds> ( elapsed ).count();
+
+	size_t bucket = 0;	// The number of significant bits, see kXMPFiles_LatencyBucketCount.
+	for ( XMP_Uns64 bits = micros; bits != 0; bits >>= 1 ) ++bucket;
+	if ( bucket >= kXMPFiles_LatencyBucketCount ) bucket = kXMPFiles_LatencyBucketCount - 1;
+
+	const XMPFiles_IO::IOCounters & endIO = XMPFiles_IO::ThreadIOCounters();
+
+	try {
+
+		std::lock_guard<std::mutex> guard ( sMetricsMutex );
+		XMPFiles_PhaseMetrics & phaseMetrics = FindHandlerMetrics ( this->format ).phases[this->phase];
+
+		++phaseMetrics.callCount;
+		if ( failed ) ++phaseMetrics.errorCount;
+		phaseMetrics.totalMicroseconds += micros;
+		if ( micros > phaseMetrics.maxMicroseconds ) phaseMetrics.maxMicroseconds = micros;
+		++phaseMetrics.latencyBuckets[bucket];
+
+		phaseMetrics.bytesRead    += endIO.bytesRead - this->startIO.bytesRead;
+		phaseMetrics.bytesWritten += endIO.bytesWritten - this->startIO.bytesWritten;
+		phaseMetrics.readCalls    += endIO.readCalls - this->startIO.readCalls;
+		phaseMetrics.writeCalls   += endIO.writeCalls - this->startIO.writeCalls;
+		phaseMetrics.seekCalls    += endIO.seekCalls - this->startIO.seekCalls;
+
+	} catch ( ... ) {
+		// Metrics must never change the outcome of the timed code.
+	}
+
+}	// XMPFiles_Metrics::PhaseTimer::Record
+
+// =================================================================================================
@@ -0,0 +1,73 @@
+#ifndef __XMPFiles_Metrics_hpp__
+#define __XMPFiles_Metrics_hpp__	1
+
+// =================================================================================================
+// Copyright Adobe
+// Copyright 2026 Adobe
+// All Rights Reserved
+//
+// NOTICE: Adobe permits you to use, modify, and distribute this file in accordance with the terms
+// of the Adobe license agreement accompanying it.
+// =================================================================================================
+
+#include "public/include/XMP_Environment.h"	// ! This must be the first include.
+#include "public/include/XMP_Const.h"
+
+#include "source/XMPFiles_IO.hpp"
+
+#include <atomic>
+#include <chrono>
+
+// =================================================================================================
+// XMPFiles_Metrics
+// ================
+//
+// The engine behind SXMPFiles::SetMetricsEnabled and SXMPFiles::GetMetrics. Counters and latency
+// histograms are kept per handler format and per phase, see the kXMPFiles_Phase_* constants. The
+// collection is always compiled in and off until the client enables it, a disabled PhaseTimer
+// costs one relaxed atomic load.
+//
+// The I/O counts are the change in the calling thread's XMPFiles_IO totals across the phase. They
+// are exact because a phase runs on one thread, and other threads doing I/O do not disturb them.
+//
+// Recording takes a global mutex. That is cheap next to the phases being timed, the smallest of
+// which still does file I/O.
+
+class XMPFiles_Metrics {
+public:
+
+	static void SetEnabled ( bool enabled );
+	static bool IsEnabled() { return sEnabled.load ( std::memory_order_relaxed ); };
+
+	// Copies out the handlers with any counts, in format order. Returns the number of handlers with
+	// counts, the copy and reset are only done if that fits within the capacity.
+	static XMP_Uns32 Snapshot ( XMPFiles_HandlerMetrics * metrics, XMP_Uns32 capacity, bool reset );
+
+	static void NoteUpdate ( XMP_FileFormat format, bool inPlace );
+
+	static void Terminate();	// Discards the counts and disables collection.
+
+	// Times one phase for one handler. The phase counts as an error unless Stop is called, so an
+	// exception thrown from the timed code is recorded as such by the destructor.
+
+	class PhaseTimer {
+	public:
+		PhaseTimer ( XMP_FileFormat format, XMP_Uns8 phase );
+		~PhaseTimer();
+		void Stop();
+	private:
+		void Record ( bool failed );
+		XMP_FileFormat	format;
+		XMP_Uns8		phase;
+		bool			active;
+		std::chrono::steady_clock::time_point	startTime;
+		XMPFiles_IO::IOCounters					startIO;
+	};
+
+private:
+
+	static std::atomic<bool> sEnabled;
+
+};	// XMPFiles_Metrics
+
+#endif	// __XMPFiles_Metrics_hpp__
@@ -491,7 +491,15 @@ public:
     ///   \li \c #kXMPFiles_OpenUseSmartHandler - Require the use of a smart handler.
     ///   \li \c #kXMPFiles_OpenUsePacketScanning - Force packet scanning, do not use a smart handler.
 	///   \li \c #kXMPFiles_OptimizeFileLayout - When updating a file, spend the effort necessary 
-	///    to optimize file layout.
+	///    to optimize file layout. For MP3 files this also shrinks an ID3v2 tag with more than 8K
+	///    of excess padding, moving the audio. Otherwise the padding is kept.
+    ///   \li \c #kXMPFiles_OpenFastRead - For read-only access, skip reading the IPTC if the XMP
+    ///   is known to be current. This is for JPEG, TIFF, and Photoshop files written by a compliant
+    ///   writer: the IPTC digest matches and \c xmp:MetadataDate is not older than the Exif
+    ///   \c DateTime. IPTC values missing from the XMP are then not imported. The Exif is always
+    ///   imported, compliant writers keep it out of the XMP. For PNG files, stop looking for the
+    ///   XMP at the image data. XMPFiles writes the XMP before the image data, other writers might
+    ///   not, then the XMP is not found. Ignored when opening for update.
     ///
     /// @return True if the file is succesfully opened and attached to a file handler. False for
     /// anticipated problems, such as passing \c #kXMPFiles_OpenUseSmartHandler but not having an
@@ -730,6 +738,150 @@ public:
 
     /// @}
 
+    // =============================================================================================
+    /// \name Asynchronous metadata reads
+    /// @{
+    ///
+    /// These functions read the XMP from many files concurrently. Each request is a complete
+    /// read-only open, \c GetXMP(), and close of one file, run on an internal worker thread. Opening
+    /// a file is a chain of small dependent reads, keeping many requests in flight hides most of
+    /// the storage latency. This is intended for bulk ingest from slow or network storage.
+    ///
+    /// Requests are opened with \c #kXMPFiles_OpenPrefetch added. The default error callback, if
+    /// any, applies to each request and may be called from a worker thread. Errors that would make
+    /// \c OpenFile() throw are returned by \c HarvestGetXMP() instead.
+
+    // ---------------------------------------------------------------------------------------------
+    /// @brief \c SubmitGetXMP() queues a request to read the XMP from a file.
+    ///
+    /// This function is static; make the call directly from the concrete class (\c SXMPFiles).
+    ///
+    /// @param filePath The path of the file, see \c OpenFile().
+    ///
+    /// @param format The format of the file, see \c OpenFile().
+    ///
+    /// @param openFlags Options for opening the file, see \c OpenFile(). Must not include
+    /// \c #kXMPFiles_OpenForUpdate.
+    ///
+    /// @return A nonzero ID identifying the request in the result of \c HarvestGetXMP().
+
+    static XMP_Uns32 SubmitGetXMP ( XMP_StringPtr  filePath,
+                                    XMP_FileFormat format = kXMP_UnknownFile,
+                                    XMP_OptionBits openFlags = 0 );
+
+    // ---------------------------------------------------------------------------------------------
+    /// @brief \c HarvestGetXMP() returns the result of a completed request.
+    ///
+    /// Results are returned in the order the requests complete, not the order of submission.
+    ///
+    /// This function is static; make the call directly from the concrete class (\c SXMPFiles).
+    ///
+    /// @param requestID [out] The ID returned by \c SubmitGetXMP() for this request.
+    ///
+    /// @param xmpPacket [out] A string object in which to return the raw XMP packet. Can be null.
+    /// Empty if the file has no XMP or the request failed.
+    ///
+    /// @param packetInfo [out] The location and form of the raw XMP, see \c GetXMP(). Can be null.
+    ///
+    /// @param format [out] The format of the file. Can be null. \c #kXMP_UnknownFile if no handler
+    /// could open it.
+    ///
+    /// @param errorID [out] The \c XMP_Error ID if the request failed, zero otherwise. Can be null.
+    ///
+    /// @param errMessage [out] A string object in which to return the error message if the request
+    /// failed. Can be null. Empty if the request succeeded.
+    ///
+    /// @param waitMS The maximum number of milliseconds to wait for a request to complete. Pass
+    /// zero to poll, or \c #kXMPFiles_WaitForever.
+    ///
+    /// @return True if a completed request was returned. False if no request completed within the
+    /// wait, if there are no outstanding requests, or if \c SXMPFiles::Terminate() shut the
+    /// requests down. A call to \c Terminate() during a harvest discards the requests that have not
+    /// started and makes a waiting \c HarvestGetXMP() return false.
+
+    static bool HarvestGetXMP ( XMP_Uns32 *      requestID,
+                                tStringObj *     xmpPacket = 0,
+                                XMP_PacketInfo * packetInfo = 0,
+                                XMP_FileFormat * format = 0,
+                                XMP_Int32 *      errorID = 0,
+                                tStringObj *     errMessage = 0,
+                                XMP_Uns32        waitMS = kXMPFiles_WaitForever );
+
+    // ---------------------------------------------------------------------------------------------
+    /// @brief \c GetXMPForFiles() reads the XMP from a list of files concurrently.
+    ///
+    /// The files are read by one worker per core, on the same internal threads as
+    /// \c SubmitGetXMP(). The function returns when every file has been reported, or after the
+    /// callback cancels the batch. A file that could not be read because of an internal failure is
+    /// still reported, with an error.
+    ///
+    /// The result callback is called once per file, in the order the files complete, on the
+    /// calling thread. Error notifications behave as for a new \c TXMPFiles object opening each
+    /// file, using the default error callback with its limit reset for every file. They may come
+    /// from a worker thread, but the error callback is never entered concurrently. An error that
+    /// would make \c OpenFile() throw is reported to the result callback instead.
+    ///
+    /// This function is static; make the call directly from the concrete class (\c SXMPFiles).
+    ///
+    /// @param filePaths The paths of the files to read.
+    ///
+    /// @param resultProc The client's result callback, see \c #XMPFiles_BatchResultProc.
+    ///
+    /// @param context Client-provided context for the result callback.
+    ///
+    /// @param format The format of the files, see \c OpenFile().
+    ///
+    /// @param openFlags Options for opening the files, see \c OpenFile(). Must not include
+    /// \c #kXMPFiles_OpenForUpdate.
+    ///
+    /// @return The number of results delivered to the callback.
+
+    static XMP_Uns32 GetXMPForFiles ( const std::vector<tStringObj> & filePaths,
+                                      XMPFiles_BatchResultProc        resultProc,
+                                      void *                          context = 0,
+                                      XMP_FileFormat                  format = kXMP_UnknownFile,
+                                      XMP_OptionBits                  openFlags = 0 );
+
+    /// @}
+
+	// =============================================================================================
+    /// \name Performance metrics
+    /// @{
+    ///
+    /// XMPFiles can count the work its file handlers do, and how long it takes. The counts are kept
+    /// per handler and per phase of the work, see \c #XMPFiles_HandlerMetrics. They cover all
+    /// \c TXMPFiles objects in the process, and are meant for export to a client's metrics system.
+    /// Collection is off until \c SetMetricsEnabled() is called.
+
+    // ---------------------------------------------------------------------------------------------
+    /// @brief \c SetMetricsEnabled() turns collection of the performance metrics on or off.
+    ///
+    /// Turning collection off keeps the counts so far. Phases already running when collection is
+    /// turned on are not counted.
+    ///
+    /// This function is static; make the call directly from the concrete class (\c SXMPFiles).
+    ///
+    /// @param enabled True to collect metrics.
+
+    static void SetMetricsEnabled ( bool enabled );
+
+    // ---------------------------------------------------------------------------------------------
+    /// @brief \c GetMetrics() copies out the performance metrics collected so far.
+    ///
+    /// There is one \c XMPFiles_HandlerMetrics item for each handler format that has any counts,
+    /// in order of the format constant.
+    ///
+    /// This function is static; make the call directly from the concrete class (\c SXMPFiles).
+    ///
+    /// @param metrics [out] Receives the metrics, any previous contents are replaced.
+    ///
+    /// @param reset True to zero the counts after copying them. The copy and reset are atomic,
+    /// no counts are lost between successive calls.
+
+    static void GetMetrics ( std::vector<XMPFiles_HandlerMetrics> * metrics, bool reset = false );
+
+    /// @}
+
     // =============================================================================================
     /// \name Progress notifications
     /// @{
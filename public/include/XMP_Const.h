@@ -1197,12 +1197,28 @@ enum {
     /// Attempt to repair a file opened for update, default is to not open (throw an exception).
     kXMPFiles_OpenRepairFile        = 0x00000100,
 
-	/// When updating a file, spend the effort necessary to optimize file layout.
+	/// When updating a file, spend the effort necessary to optimize file layout. For MP3 files this
+	/// also shrinks an ID3v2 tag with more than 8K of excess padding, moving the audio. Otherwise the
+	/// padding is kept.
     kXMPFiles_OptimizeFileLayout    = 0x00000200,
 
 	/// When updating a PDF preserve state of document
-    kXMPFiles_PreservePDFState    =  0x00000400
+    kXMPFiles_PreservePDFState    =  0x00000400,
 
+	/// Ask the host to start reading the start of the file asynchronously as soon as it is opened.
+	/// Hides some of the latency of the handler's first reads on slow or network storage.
+    kXMPFiles_OpenPrefetch          = 0x00000800,
+
+	/// For read-only opens of JPEG, TIFF, and Photoshop files, skip reading the IPTC if the IPTC
+	/// digest matches and xmp:MetadataDate is not older than the Exif DateTime. For PNG files, stop
+	/// looking for the XMP at the image data. XMPFiles writes it before, other writers might not.
+    kXMPFiles_OpenFastRead          = 0x00001000
+
+};
+
+/// @brief Wait limit for \c TXMPFiles::HarvestGetXMP() that never times out.
+enum {
+    kXMPFiles_WaitForever = 0xFFFFFFFFUL
 };
 
 /// @brief Option bit flags for \c TXMPFiles::CloseFile().
@@ -1211,6 +1227,69 @@ enum {
     kXMPFiles_UpdateSafely = 0x0001
 };
 
+// -------------------------------------------------------------------------------------------------
+
+/// @brief The phases of handler work measured by \c TXMPFiles::GetMetrics(). Phases can nest, for
+/// example \c kXMPFiles_Phase_ExportXMPtoJTP is usually part of \c kXMPFiles_Phase_UpdateFile.
+enum {
+	/// Checking whether a handler can take the file, counted for every handler tried.
+    kXMPFiles_Phase_CheckFormat    = 0,
+	/// Reading the file's XMP and native metadata when the file is opened.
+    kXMPFiles_Phase_CacheFileData  = 1,
+	/// Parsing the XMP and reconciling the native metadata.
+    kXMPFiles_Phase_ProcessXMP     = 2,
+	/// Exporting XMP to the Exif, IPTC, and PSIR legacy metadata of JPEG, TIFF, and Photoshop files.
+    kXMPFiles_Phase_ExportXMPtoJTP = 3,
+	/// Updating the file when it is closed, including safe updates done by copying the file.
+    kXMPFiles_Phase_UpdateFile     = 4,
+	/// Writing a whole new file during a safe update.
+    kXMPFiles_Phase_WriteTempFile  = 5,
+	/// Count of the phases.
+    kXMPFiles_PhaseCount           = 6
+};
+
+/// @brief Size of the latency histogram in \c XMPFiles_PhaseMetrics.
+enum {
+	/// Bucket 0 counts calls under 1 microsecond, bucket N counts calls of at least 2^(N-1) and
+	/// under 2^N microseconds. The last bucket also counts everything longer.
+    kXMPFiles_LatencyBucketCount = 24
+};
+
+/// @brief Counters for one phase of one handler, see \c TXMPFiles::GetMetrics().
+///
+/// The I/O counts cover the local file I/O done by XMPFiles on the thread running the phase. I/O
+/// done through a client-provided \c XMP_IO object is not included.
+struct XMPFiles_PhaseMetrics {
+	/// Number of times the phase ran.
+    XMP_Uns64 callCount;
+	/// Number of those that ended by throwing an exception.
+    XMP_Uns64 errorCount;
+	/// Total and longest run time in microseconds.
+    XMP_Uns64 totalMicroseconds;
+    XMP_Uns64 maxMicroseconds;
+	/// Histogram of the run times, see \c kXMPFiles_LatencyBucketCount.
+    XMP_Uns64 latencyBuckets [kXMPFiles_LatencyBucketCount];
+	/// Bytes transferred to and from the file system.
+    XMP_Uns64 bytesRead;
+    XMP_Uns64 bytesWritten;
+	/// Number of read, write, and seek system calls.
+    XMP_Uns64 readCalls;
+    XMP_Uns64 writeCalls;
+    XMP_Uns64 seekCalls;
+};
+
+/// @brief Counters for one file handler, see \c TXMPFiles::GetMetrics().
+struct XMPFiles_HandlerMetrics {
+	/// The format of the handler.
+    XMP_FileFormat format;
+	/// Number of updates the handler made by overwriting the old packet or appending to the file.
+    XMP_Uns64 inPlaceUpdates;
+	/// Number of updates the handler made by copying the file.
+    XMP_Uns64 copyUpdates;
+	/// Counters for each phase, indexed by the \c kXMPFiles_Phase_* constants.
+    XMPFiles_PhaseMetrics phases [kXMPFiles_PhaseCount];
+};
+
 
 // =================================================================================================
 // Error notification and Exceptions
@@ -1327,6 +1406,45 @@ typedef XMP_Bool (* XMPFiles_ErrorCallbackWrapper) ( XMPFiles_ErrorCallbackProc
                                      	         XMP_StringPtr filePath, XMP_ErrorSeverity severity,
                                     	         XMP_Int32 cause, XMP_StringPtr message );
 
+// -------------------------------------------------------------------------------------------------
+/// @brief The signature of a client-defined callback receiving the results of
+/// \c TXMPFiles::GetXMPForFiles().
+///
+/// The callback is called once per file, in the order the files complete, always on the thread
+/// that called \c GetXMPForFiles(). Calls are never concurrent.
+///
+/// @param context A pointer to client-defined data passed to \c GetXMPForFiles().
+///
+/// @param filePath The path of the file, as passed to \c GetXMPForFiles().
+///
+/// @param format The format of the file, \c #kXMP_UnknownFile if no handler could open it.
+///
+/// @param xmpPacket The raw XMP packet, null if the file has no XMP or the open failed. Only valid
+/// during the callback.
+///
+/// @param xmpLength The length in bytes of the raw XMP packet.
+///
+/// @param packetInfo The location and form of the raw XMP, see \c TXMPFiles::GetXMP().
+///
+/// @param errorID The \c XMP_Error ID if the file could not be read, zero otherwise.
+///
+/// @param message An explanation of the error, null if \c errorID is zero. For debugging use only.
+///
+/// @return True to continue with the remaining files, false to cancel them.
+
+typedef bool (* XMPFiles_BatchResultProc) ( void* context, XMP_StringPtr filePath, XMP_FileFormat format,
+                                            XMP_StringPtr xmpPacket, XMP_StringLen xmpLength,
+                                            const XMP_PacketInfo * packetInfo, XMP_Int32 errorID,
+                                            XMP_StringPtr message );
+
+/// Internal: The signature of the client-side wrapper for the batch result callback.
+
+typedef XMP_Bool (* XMPFiles_BatchResultWrapper) ( XMPFiles_BatchResultProc clientProc, void* context,
+                                                   XMP_StringPtr filePath, XMP_FileFormat format,
+                                                   XMP_StringPtr xmpPacket, XMP_StringLen xmpLength,
+                                                   const XMP_PacketInfo * packetInfo, XMP_Int32 errorID,
+                                                   XMP_StringPtr message );
+
 /// XMP Toolkit error, associates an error code with a descriptive error string.
 class XMP_Error {
 public:
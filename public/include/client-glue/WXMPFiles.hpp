@@ -64,6 +64,21 @@ static XMP_Bool WrapFilesErrorNotify ( XMPFiles_ErrorCallbackProc proc, void * c
 
 // =================================================================================================
 
+static XMP_Bool WrapBatchResult ( XMPFiles_BatchResultProc proc, void * context,
+	XMP_StringPtr filePath, XMP_FileFormat format, XMP_StringPtr xmpPacket, XMP_StringLen xmpLength,
+	const XMP_PacketInfo * packetInfo, XMP_Int32 errorID, XMP_StringPtr message )
+{
+	bool ok;
+	try {
+		ok = (*proc) ( context, filePath, format, xmpPacket, xmpLength, packetInfo, errorID, message );
+	} catch ( ... ) {
+		ok = false;
+	}
+	return ConvertBoolToXMP_Bool( ok );
+}
+
+// =================================================================================================
+
 #define zXMPFiles_GetVersionInfo_1(versionInfo) \
 	WXMPFiles_GetVersionInfo_1 ( versionInfo /* no wResult */ )
 
@@ -123,6 +138,21 @@ static XMP_Bool WrapFilesErrorNotify ( XMPFiles_ErrorCallbackProc proc, void * c
 #define zXMPFiles_CanPutXMP_1(xmpRef,xmpPacket,xmpPacketLen) \
 	WXMPFiles_CanPutXMP_1 ( this->xmpFilesRef, xmpRef, xmpPacket, xmpPacketLen, &wResult )
 
+#define zXMPFiles_SubmitGetXMP_1(filePath,format,openFlags) \
+	WXMPFiles_SubmitGetXMP_1 ( filePath, format, openFlags, &wResult )
+
+#define zXMPFiles_HarvestGetXMP_1(waitMS,requestID,clientPacket,packetInfo,format,errorID,clientMessage,SetClientString) \
+	WXMPFiles_HarvestGetXMP_1 ( waitMS, requestID, clientPacket, packetInfo, format, errorID, clientMessage, SetClientString, &wResult )
+
+#define zXMPFiles_GetXMPForFiles_1(filePaths,fileCount,format,openFlags,proc,context) \
+	WXMPFiles_GetXMPForFiles_1 ( filePaths, fileCount, format, openFlags, WrapBatchResult, proc, context, &wResult )
+
+#define zXMPFiles_SetMetricsEnabled_1(enabled) \
+	WXMPFiles_SetMetricsEnabled_1 ( enabled, &wResult )
+
+#define zXMPFiles_GetMetrics_1(metrics,capacity,reset) \
+	WXMPFiles_GetMetrics_1 ( metrics, capacity, reset, &wResult )
+
 #define zXMPFiles_SetDefaultProgressCallback_1(proc,context,interval,sendStartStop) \
 	WXMPFiles_SetDefaultProgressCallback_1 ( WrapProgressReport, proc, context, interval, sendStartStop, &wResult )
 
@@ -238,6 +268,38 @@ extern void WXMPFiles_CanPutXMP_1 ( XMPFilesRef   xmpFilesRef,
                                     XMP_StringLen xmpPacketLen,
                                     WXMP_Result * result );
 
+extern void WXMPFiles_SubmitGetXMP_1 ( XMP_StringPtr  filePath,
+                                       XMP_FileFormat format,
+                                       XMP_OptionBits openFlags,
+                                       WXMP_Result *  result );
+
+extern void WXMPFiles_HarvestGetXMP_1 ( XMP_Uns32        waitMS,
+                                        XMP_Uns32 *      requestID,
+                                        void *           clientPacket,	// ! Can be null.
+                                        XMP_PacketInfo * packetInfo,	// ! Can be null.
+                                        XMP_FileFormat * format,		// ! Can be null.
+                                        XMP_Int32 *      errorID,		// ! Can be null.
+                                        void *           clientMessage,	// ! Can be null.
+                                        SetClientStringProc SetClientString,
+                                        WXMP_Result *    result );
+
+extern void WXMPFiles_GetXMPForFiles_1 ( const XMP_StringPtr *       filePaths,
+                                         XMP_Uns32                   fileCount,
+                                         XMP_FileFormat              format,
+                                         XMP_OptionBits              openFlags,
+                                         XMPFiles_BatchResultWrapper wrapperProc,
+                                         XMPFiles_BatchResultProc    clientProc,
+                                         void *                      context,
+                                         WXMP_Result *               result );
+
+extern void WXMPFiles_SetMetricsEnabled_1 ( XMP_Bool      enabled,
+                                            WXMP_Result * result );
+
+extern void WXMPFiles_GetMetrics_1 ( XMPFiles_HandlerMetrics * metrics,
+                                     XMP_Uns32                 capacity,
+                                     XMP_Bool                  reset,
+                                     WXMP_Result *             result );
+
 extern void WXMPFiles_SetDefaultProgressCallback_1 ( XMP_ProgressReportWrapper wrapperproc,
 													 XMP_ProgressReportProc    clientProc,
 													 void *        context,
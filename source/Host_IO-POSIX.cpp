@@ -409,6 +409,26 @@ void Host_IO::SetEOF ( Host_IO::FileRef refNum, XMP_Int64 length )
 
 }	// Host_IO::SetEOF
 
+// =================================================================================================
+// Host_IO::Prefetch
+// =================
+
+void Host_IO::Prefetch ( Host_IO::FileRef refNum, XMP_Int64 offset, XMP_Int64 length )
+{
+	if ( (refNum == Host_IO::noFileRef) || (offset < 0) || (length <= 0) ) return;
+
+	#if XMP_MacBuild | XMP_iOSBuild
+		if ( length > 0x7FFFFFFF ) length = 0x7FFFFFFF;
+		struct radvisory advice;
+		advice.ra_offset = (off_t) offset;
+		advice.ra_count  = (int) length;
+		(void) fcntl ( refNum, F_RDADVISE, &advice );	// Errors are ignored, this is just advice.
+	#elif defined ( POSIX_FADV_WILLNEED )
+		(void) posix_fadvise ( refNum, (Host_IO::XMP_off_t)offset, (Host_IO::XMP_off_t)length, POSIX_FADV_WILLNEED );
+	#endif
+
+}	// Host_IO::Prefetch
+
 // =================================================================================================
 // =====================================   Folder operations   =====================================
 // =================================================================================================
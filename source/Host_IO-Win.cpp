@@ -450,6 +450,19 @@ void Host_IO::SetEOF ( Host_IO::FileRef fileHandle, XMP_Int64 length )
 
 }	// Host_IO::SetEOF
 
+// =================================================================================================
+// Host_IO::Prefetch
+// =================
+//
+// Windows has no per-handle read-ahead advice for a byte range, the cache manager already does
+// sequential read-ahead. Nothing to do here.
+
+void Host_IO::Prefetch ( Host_IO::FileRef fileHandle, XMP_Int64 offset, XMP_Int64 length )
+{
+	IgnoreParam ( fileHandle ); IgnoreParam ( offset ); IgnoreParam ( length );
+
+}	// Host_IO::Prefetch
+
 // =================================================================================================
 // Folder operations
 // =================================================================================================
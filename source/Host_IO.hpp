@@ -95,6 +95,10 @@ namespace Host_IO {
 	//
 	// SetEOF - Sets a new EOF offset. The I/O position may be changed. Throws an XMP_Error
 	// exception for any errors.
+	//
+	// Prefetch - Hint that a range of an open file will be read soon. The host is asked to start
+	// reading it asynchronously, so that later small dependent reads are satisfied from the cache.
+	// The I/O position is not changed. This is only advice, it never throws an exception.
 
 	#if XMP_WinBuild
 		typedef HANDLE FileRef;
@@ -133,6 +137,7 @@ namespace Host_IO {
 	void		Write    ( FileRef file, const void* buffer, XMP_Uns32 count );
 	XMP_Int64	Length   ( FileRef file );
 	void		SetEOF   ( FileRef file, XMP_Int64 length );
+	void		Prefetch ( FileRef file, XMP_Int64 offset, XMP_Int64 length );
 
 	inline XMP_Int64 Offset ( FileRef file ) { return Host_IO::Seek ( file, 0, kXMP_SeekFromCurrent ); };
 	inline XMP_Int64 Rewind ( FileRef file ) { return Host_IO::Seek ( file, 0, kXMP_SeekFromStart ); };	// Always returns 0.
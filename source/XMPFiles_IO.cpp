@@ -137,6 +137,15 @@ void XMPFiles_IO::operator = ( const XMP_IO& in )
 
 };	// XMPFiles_IO::operator=
 
+// =================================================================================================
+
+static thread_local XMPFiles_IO::IOCounters sThreadIOCounters;	// ! Zero initialized, static storage.
+
+const XMPFiles_IO::IOCounters & XMPFiles_IO::ThreadIOCounters()
+{
+	return sThreadIOCounters;
+}
+
 // =================================================================================================
 // XMPFiles_IO::Read
 // =================
@@ -155,6 +164,8 @@ XMP_Uns32 XMPFiles_IO::Read ( void * buffer, XMP_Uns32 count, bool readAll /* =
 	}
 
 	XMP_Uns32 amountRead = Host_IO::Read ( this->fileRef, buffer, count );
+	++sThreadIOCounters.readCalls;
+	sThreadIOCounters.bytesRead += amountRead;
 	XMP_Enforce ( amountRead == count );
 
 	this->currOffset += amountRead;
@@ -179,7 +190,9 @@ void XMPFiles_IO::Write ( const void * buffer, XMP_Uns32 count )
 	try {
 		if ( this->readOnly )
 			XMP_Throw ( "New_XMPFiles_IO, write not permitted on read only file", kXMPErr_FilePermission );
+		++sThreadIOCounters.writeCalls;
 		Host_IO::Write ( this->fileRef, buffer, count );
+		sThreadIOCounters.bytesWritten += count;
 		if ( this->progressTracker != 0 ) this->progressTracker->AddWorkDone ( (float) count );
 	} catch ( ... ) {
 		try {
@@ -219,6 +232,7 @@ XMP_Int64 XMPFiles_IO::Seek ( XMP_Int64 offset, SeekMode mode )
 	}
 	XMP_Enforce ( newOffset >= 0 );
 
+	++sThreadIOCounters.seekCalls;
 	if ( newOffset <= this->currLength ) {
 		this->currOffset = Host_IO::Seek ( this->fileRef, offset, mode );
 	} else if ( this->readOnly ) {
@@ -278,6 +292,20 @@ void XMPFiles_IO::Truncate ( XMP_Int64 length )
 
 }	// XMPFiles_IO::Truncate
 
+// =================================================================================================
+// XMPFiles_IO::Prefetch
+// =====================
+//
+// Clipped to the current length. The I/O position is not changed.
+
+void XMPFiles_IO::Prefetch ( XMP_Int64 offset, XMP_Int64 length )
+{
+	if ( (this->fileRef == Host_IO::noFileRef) || (offset >= this->currLength) ) return;
+	if ( length > (this->currLength - offset) ) length = this->currLength - offset;
+	Host_IO::Prefetch ( this->fileRef, offset, length );
+
+}	// XMPFiles_IO::Prefetch
+
 // =================================================================================================
 // XMPFiles_IO::DeriveTemp
 // =======================
@@ -66,6 +66,17 @@ public:
 
 	void Close();	// Not part of XMP_IO, added here to let errors propagate.
 
+	void Prefetch ( XMP_Int64 offset, XMP_Int64 length );	// Not part of XMP_IO, just advice to the host.
+
+	// Running totals of the host I/O done through any XMPFiles_IO object by the calling thread. The
+	// XMPFiles metrics take the difference across a phase, so the totals are never reset.
+	struct IOCounters {
+		XMP_Uns64 bytesRead, bytesWritten;
+		XMP_Uns64 readCalls, writeCalls, seekCalls;
+	};
+
+	static const IOCounters & ThreadIOCounters();
+
 private:
 	bool					readOnly;
 	std::string				filePath;